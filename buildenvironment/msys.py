@@ -39,20 +39,27 @@ localconf = {
     "linkflags"             : [ ],
 
     "cpplibraries"          : [  "stdc++",
-                                 "boost_iostreams-mt"
+                                 "boost_iostreams-mt",
+                                 "boost_filesystem-mt",
+                                 "boost_system-mt"
     ],
     
     # gfortran must be linked after Lapack, otherwise a linker error is shown
-    "clibraries"            : [ "lapack",
+    "clibraries"            : [ "z",
+                                "bz2",
+                                "lapack",
                                 "lapacke",
                                 "blas",
                                 "gfortran"
     ],
     
-    "cheaders"              : [ "omp.h"
+    "cheaders"              : [ "omp.h",
+                                "zlib.h",
+                                "bzlib.h"
     ],
     
     "cppheaders"            : [ "map",
+                                os.path.join("boost", "filesystem.hpp"),
                                 "algorithm",
                                 "limits",
                                 "iostream",
@@ -255,13 +262,12 @@ elif conf.env["winversion"] == "w2000" :
     
 if not("java" in COMMAND_LINE_TARGETS) :
     localconf["cpplibraries"].extend([
-                            "boost_program_options-mt", "boost_filesystem-mt"
+                            "boost_program_options-mt"
     ])
     localconf["cppheaders"].extend([
                             "cstdlib",
                             os.path.join("boost", "program_options", "parsers.hpp"),
                             os.path.join("boost", "program_options", "variables_map.hpp"),
-                            os.path.join("boost", "filesystem.hpp"),
                             os.path.join("boost", "program_options", "options_description.hpp")
     ])
     
@@ -35,15 +35,20 @@ localconf = {
     "linkflags"             : [ ],
 
     "cpplibraries"          : [  "stdc++",
-                                 "boost_iostreams-mt"
+                                 "boost_iostreams-mt",
+                                 "boost_filesystem-mt",
+                                 "boost_system-mt"
     ],
     
-    "clibraries"            : [ ],
+    "clibraries"            : [ "z", "bz2" ],
     
-    "cheaders"              : [ "omp.h"
+    "cheaders"              : [ "omp.h",
+                                "zlib.h",
+                                "bzlib.h"
     ],
     
     "cppheaders"            : [ "map",
+                                os.path.join("boost", "filesystem.hpp"),
                                 "algorithm",
                                 "limits",
                                 "iostream",
@@ -228,13 +233,12 @@ elif conf.env["atlaslink"] == "single" :
     
 if not("java" in COMMAND_LINE_TARGETS) :
     localconf["cpplibraries"].extend([
-                            "boost_program_options-mt", "boost_filesystem-mt"
+                            "boost_program_options-mt"
     ])
     localconf["cppheaders"].extend([
                             "cstdlib",
                             os.path.join("boost", "program_options", "parsers.hpp"),
                             os.path.join("boost", "program_options", "variables_map.hpp"),
-                            os.path.join("boost", "filesystem.hpp"),
                             os.path.join("boost", "program_options", "options_description.hpp")
     ])
     
@@ -27,6 +27,7 @@
 
 #include <algorithm>
 #include <map>
+#include <omp.h>
 #include <boost/numeric/ublas/matrix.hpp>
 #include <boost/numeric/ublas/vector.hpp>
 
@@ -82,6 +83,10 @@ namespace machinelearning { namespace classifier {
             ublas::matrix<T> m_basedata;
             /** vector with data label information **/
             std::vector<L> m_baselabels;
+            /** vector with the distinct labels (index is the dense label id) **/
+            std::vector<L> m_labelvalues;
+            /** vector with the dense label id of each data point **/
+            std::vector<std::size_t> m_labelindex;
             /** bool for logging **/
             bool m_logging;
             /** std::vector with index of the nearest datapoints for each datapoint  **/
@@ -92,8 +97,6 @@ namespace machinelearning { namespace classifier {
             std::vector<L> getLabelsWithoutWeight( const ublas::matrix<std::size_t>& ) const;
             std::vector<L> getLabelsWithWeight( const ublas::matrix<std::size_t>&, const ublas::matrix<T>& ) const;
         
-            static bool labelMapCompair( const std::pair<L, std::size_t>&, const std::pair<L, std::size_t>& );
-        
     };
     
     
@@ -182,7 +185,8 @@ namespace machinelearning { namespace classifier {
     }
     
     
-    /** sets the datapoints as the fixed references 
+    /** sets the datapoints as the fixed references. The labels are mapped
+     * once to dense indices, so the voting can be run on a flat array
      * @param p_data Matrix with data (rows are the vectors)
      * @param p_labels vector for labels
      **/
@@ -194,18 +198,23 @@ namespace machinelearning { namespace classifier {
         clearLogging();
         m_basedata      = p_data;
         m_baselabels    = p_labels;
-    }
-    
-    
-    
-    /** compair call for std::map, so we get the maximum element (on the second entry)
-     * @param p_left first element
-     * @param p_right right element
-     * @return bool if first pair (second component) is smaller
-    **/
-    template<typename T, typename L> inline bool lazylearner<T,L>::labelMapCompair( const std::pair<L, std::size_t>& p_left, const std::pair<L, std::size_t>& p_right)
-    {
-        return p_left.second < p_right.second;
+        
+        // create dense label ids, the ids are set in label order, so equal votes
+        // are resolved to the smallest label (equal to a std::map scan)
+        std::map<L, std::size_t> l_labelmap;
+        for(std::size_t i=0; i < m_baselabels.size(); ++i)
+            l_labelmap.insert( std::pair<L, std::size_t>(m_baselabels[i], 0) );
+        
+        m_labelvalues.clear();
+        m_labelvalues.reserve( l_labelmap.size() );
+        for(typename std::map<L, std::size_t>::iterator it = l_labelmap.begin(); it != l_labelmap.end(); ++it) {
+            it->second = m_labelvalues.size();
+            m_labelvalues.push_back( it->first );
+        }
+        
+        m_labelindex.resize( m_baselabels.size() );
+        for(std::size_t i=0; i < m_baselabels.size(); ++i)
+            m_labelindex[i] = l_labelmap[ m_baselabels[i] ];
     }
     
     
@@ -215,23 +224,34 @@ namespace machinelearning { namespace classifier {
     **/
     template<typename T, typename L> inline std::vector<L> lazylearner<T, L>::getLabelsWithoutWeight( const ublas::matrix<std::size_t>& p_neighbour ) const
     {
-        std::vector<L> l_label; 
-        std::map<L, std::size_t> l_nnlabel;
+        std::vector<L> l_label( p_neighbour.size1() );
         
-        for(std::size_t i=0; i < p_neighbour.size1(); ++i) {            
-
-            // get label count
-            l_nnlabel.clear();
-            for(std::size_t j=0; j < p_neighbour.size2(); ++j)
-                
-                if ( l_nnlabel.find(m_baselabels[p_neighbour(i,j)]) == l_nnlabel.end())
-                    l_nnlabel.insert( std::pair<L, std::size_t>(m_baselabels[p_neighbour(i,j)], 1) );
-                else
-                    l_nnlabel[ m_baselabels[p_neighbour(i,j)] ]++;
+        #pragma omp parallel shared(l_label)
+        {
+            // every thread uses its own vote array, only the touched entries are reset
+            std::vector<std::size_t> l_votes( m_labelvalues.size(), 0 );
             
-            // set this label that is the biggest (most counts)
-            l_label.push_back(  std::max_element(l_nnlabel.begin(), l_nnlabel.end(), labelMapCompair)->first );
+            #pragma omp for
+            for(std::size_t i=0; i < p_neighbour.size1(); ++i) {
+                
+                // get label count
+                for(std::size_t j=0; j < p_neighbour.size2(); ++j)
+                    l_votes[ m_labelindex[p_neighbour(i,j)] ]++;
+                
+                // set this label that is the biggest (most counts), on equal counts the smallest label
+                std::size_t l_max = m_labelindex[p_neighbour(i,0)];
+                for(std::size_t j=1; j < p_neighbour.size2(); ++j) {
+                    const std::size_t l_id = m_labelindex[p_neighbour(i,j)];
+                    if ( (l_votes[l_id] > l_votes[l_max]) || ((l_votes[l_id] == l_votes[l_max]) && (l_id < l_max)) )
+                        l_max = l_id;
+                }
+                l_label[i] = m_labelvalues[l_max];
+                
+                for(std::size_t j=0; j < p_neighbour.size2(); ++j)
+                    l_votes[ m_labelindex[p_neighbour(i,j)] ] = 0;
+            }
         }
+        
         return l_label;
     }
     
@@ -243,39 +263,51 @@ namespace machinelearning { namespace classifier {
      **/
     template<typename T, typename L> inline std::vector<L> lazylearner<T, L>::getLabelsWithWeight( const ublas::matrix<std::size_t>& p_neighbour, const ublas::matrix<T>& p_data ) const
     {
-        std::vector<L> l_label; 
-        std::map<L,T> l_nnlabel;
+        std::vector<L> l_label( p_neighbour.size1() );
         
-        for(std::size_t i=0; i < p_neighbour.size1(); ++i) {
+        #pragma omp parallel shared(l_label)
+        {
+            // every thread uses its own weight array, only the touched entries are reset
+            std::vector<T> l_votes( m_labelvalues.size(), static_cast<T>(0) );
             
-            // calculate the distance values of the neighbourhood points
-            // if data point exact over a prototype (distance == 0) set lable direct
-            l_nnlabel.clear();
-            for(std::size_t j=0; j < p_neighbour.size2(); ++j) {
-                T l_distance = m_neighborhood->calculateDistance( static_cast< ublas::vector<T> >(ublas::row(p_data,i)), 
-                                                                  static_cast< ublas::vector<T> >(ublas::row(m_basedata, p_neighbour(i,j)))
-                                                                );
+            #pragma omp for
+            for(std::size_t i=0; i < p_neighbour.size1(); ++i) {
                 
-                if (tools::function::isNumericalZero<T>(l_distance)) {
-                    l_label.push_back( m_baselabels[p_neighbour(i,j)] );
-                    break;
+                // calculate the distance values of the neighbourhood points
+                // if data point exact over a prototype (distance == 0) set lable direct
+                bool l_exact = false;
+                for(std::size_t j=0; (j < p_neighbour.size2()) && (!l_exact); ++j) {
+                    T l_distance = m_neighborhood->calculateDistance( static_cast< ublas::vector<T> >(ublas::row(p_data,i)), 
+                                                                      static_cast< ublas::vector<T> >(ublas::row(m_basedata, p_neighbour(i,j)))
+                                                                    );
+                    
+                    if (tools::function::isNumericalZero<T>(l_distance)) {
+                        l_label[i] = m_baselabels[p_neighbour(i,j)];
+                        l_exact    = true;
+                        continue;
+                    }
+                    
+                    if (m_weight == inversedistance)
+                        l_distance = m_neighborhood->invert(l_distance);
+                    
+                    // add distance to bucket
+                    l_votes[ m_labelindex[p_neighbour(i,j)] ] += l_distance;
                 }
                 
+                // data point is not over a prototype (get max element label)
+                if (!l_exact) {
+                    std::size_t l_max = m_labelindex[p_neighbour(i,0)];
+                    for(std::size_t j=1; j < p_neighbour.size2(); ++j) {
+                        const std::size_t l_id = m_labelindex[p_neighbour(i,j)];
+                        if ( (l_votes[l_id] > l_votes[l_max]) || ((l_votes[l_id] == l_votes[l_max]) && (l_id < l_max)) )
+                            l_max = l_id;
+                    }
+                    l_label[i] = m_labelvalues[l_max];
+                }
                 
-                if (m_weight == inversedistance)
-                    l_distance = m_neighborhood->invert(l_distance);
-                
-                // add distance to bucket
-                if ( l_nnlabel.find(m_baselabels[p_neighbour(i,j)]) == l_nnlabel.end())
-                    l_nnlabel.insert( std::pair<L,T>(m_baselabels[p_neighbour(i,j) ], l_distance) );
-                else
-                    l_nnlabel[ m_baselabels[p_neighbour(i,j)] ] += l_distance;
+                for(std::size_t j=0; j < p_neighbour.size2(); ++j)
+                    l_votes[ m_labelindex[p_neighbour(i,j)] ] = static_cast<T>(0);
             }
-            
-            // data point is not over a prototype (normalize buckets and get max element label)
-            if ( i == l_label.size())
-                l_label.push_back(  std::max_element(l_nnlabel.begin(), l_nnlabel.end(), labelMapCompair)->first );
-        
         }
         
         return l_label;
@@ -64,6 +64,11 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
             std::vector<T> getLoggedQuantizationError( void ) const;
             ublas::indirect_array<> use( const ublas::matrix<T>& ) const;
         
+            #ifndef SWIG
+            void train( const ublas::compressed_matrix<T>&, const std::size_t& );
+            ublas::indirect_array<> use( const ublas::compressed_matrix<T>& ) const;
+            #endif
+        
             
         private :
         
@@ -79,6 +84,9 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
             std::vector<T> m_quantizationerror;
             
             T calculateQuantizationError( const ublas::matrix<T>& ) const;
+            #ifndef SWIG
+            T calculateQuantizationError( const ublas::compressed_matrix<T>& ) const;
+            #endif
         
     };
     
@@ -221,6 +229,71 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
     }
     
     
+    /** train the prototypes with sparse data (e.g. a TF-IDF document-term matrix). The
+     * distances use only the non-zero elements of the data
+     * @param p_data sparse data matrix
+     * @param p_iterations number of iterations
+     **/
+    template<typename T> inline void kmeans<T>::train( const ublas::compressed_matrix<T>& p_data, const std::size_t& p_iterations )
+    {
+        if (p_iterations == 0)
+            throw exception::runtime(_("iterations must be greater than zero"), *this);
+        if (p_data.size2() != m_prototypes.size2())
+            throw exception::runtime(_("data and prototype dimension are not equal"), *this);
+        if (p_data.size1() < m_prototypes.size1())
+            throw exception::runtime(_("number of datapoints are less than prototypes"), *this);
+        
+        
+        // creates logging
+        if (m_logging) {
+            m_logprototypes.clear();
+            m_quantizationerror.clear();
+            m_logprototypes.reserve(p_iterations);
+            m_quantizationerror.reserve(p_iterations);
+        }
+        
+        
+        // run kmeans
+        ublas::matrix<T> l_distances( m_prototypes.size1(), p_data.size1() );
+        ublas::matrix<T> l_adaptmatrix( m_prototypes.size1(), p_data.size1() );
+        
+        for(std::size_t i=0; i < p_iterations; ++i) {
+            
+            // calculate for every prototype the distance
+            #pragma omp parallel for shared(l_distances)
+            for(std::size_t n=0; n < m_prototypes.size1(); ++n)
+                ublas::row(l_distances, n)  = m_distance.getDistance( p_data,  ublas::row(m_prototypes, n) );
+            
+            // determine winner and set the winner to 1
+            l_adaptmatrix.clear();
+            #pragma omp parallel for shared(l_adaptmatrix)
+            for(std::size_t n=0; n < l_distances.size2(); ++n) {
+                ublas::vector<T> l_vec = ublas::column(l_distances, n);
+                l_adaptmatrix(tools::vector::rankIndex( l_vec )(0), n) = static_cast<T>(1);
+            }
+            
+            
+            // adapt to prototypes and normalize the winner row (row orientated)
+            m_prototypes = tools::matrix::sparseprod( l_adaptmatrix, p_data );
+            
+            #pragma omp parallel for
+            for(std::size_t n=0; n < m_prototypes.size1(); ++n) {
+                const T l_norm = ublas::sum( ublas::row(l_adaptmatrix, n) );
+                
+                if (!tools::function::isNumericalZero(l_norm))
+                    ublas::row(m_prototypes, n) /= l_norm;
+            }
+            
+            
+            // determine quantization error for logging
+            if (m_logging) {
+                m_logprototypes.push_back( m_prototypes );
+                m_quantizationerror.push_back( calculateQuantizationError(p_data) );
+            }
+        }
+    }
+    
+    
     /** returns the dimension of prototypes
      * @return dimension of the prototypes
      **/
@@ -255,6 +328,22 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
     }
     
     
+    /** calculate the quantization error of sparse data
+     * @param p_data sparse matrix with data points
+     * @return quantization error
+     **/    
+    template<typename T> inline T kmeans<T>::calculateQuantizationError( const ublas::compressed_matrix<T>& p_data ) const
+    {
+        ublas::matrix<T> l_distances( m_prototypes.size1(), p_data.size1() );
+        
+        #pragma omp parallel for
+        for(std::size_t i=0; i < m_prototypes.size1(); ++i)
+            ublas::row(l_distances, i) = m_distance.getDistance( p_data, ublas::row(m_prototypes, i) );
+        
+        return 0.5 * ublas::sum(  m_distance.getAbs(tools::matrix::min(l_distances, tools::matrix::column))  );  
+    }
+    
+    
     /** calulates distance between datapoints and prototypes and returns a indirect array
      * with index of the nearest prototype
      * @param p_data matrix
@@ -284,6 +373,36 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
         return l_idx;
         
     }
+    
+    
+    /** calulates distance between sparse datapoints and prototypes and returns a indirect array
+     * with index of the nearest prototype
+     * @param p_data sparse matrix
+     * @return index array of prototype indices
+     **/
+    template<typename T> inline ublas::indirect_array<> kmeans<T>::use( const ublas::compressed_matrix<T>& p_data ) const
+    {
+        if (p_data.size1() < m_prototypes.size1())
+            throw exception::runtime(_("number of datapoints are less than prototypes"), *this);        
+        
+        ublas::indirect_array<> l_idx(p_data.size1());
+        ublas::matrix<T> l_distance(m_prototypes.size1(), p_data.size1());
+        
+        // calculate distance for every prototype
+        #pragma omp parallel for shared(l_distance)
+        for(std::size_t i=0; i < m_prototypes.size1(); ++i)
+            ublas::row(l_distance, i)  = m_distance.getDistance( p_data, ublas::row(m_prototypes, i) );
+        
+        // determine nearest prototype
+        #pragma omp parallel for shared(l_distance, l_idx)
+        for(std::size_t i=0; i < l_distance.size2(); ++i) {
+            ublas::vector<T> l_col                = ublas::column(l_distance, i);
+            const ublas::indirect_array<> l_rank  = tools::vector::rankIndex( l_col );
+            l_idx[i] = l_rank(0);
+        }
+        
+        return l_idx;
+    }
 
     
 
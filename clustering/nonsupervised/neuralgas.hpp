@@ -30,6 +30,7 @@
 
 #include <numeric>
 #include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_sparse.hpp>
 #include <boost/numeric/ublas/vector.hpp>
 #include <boost/numeric/bindings/blas.hpp>
 #ifdef MACHINELEARNING_MPI
@@ -79,6 +80,12 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
             std::vector<T> getLoggedQuantizationError( void ) const;
             ublas::indirect_array<> use( const ublas::matrix<T>& ) const;
         
+            #ifndef SWIG
+            void train( const ublas::compressed_matrix<T>&, const std::size_t& );
+            void train( const ublas::compressed_matrix<T>&, const std::size_t&, const T& );
+            ublas::indirect_array<> use( const ublas::compressed_matrix<T>& ) const;
+            #endif
+        
             // derived from patch clustering
             ublas::vector<T> getPrototypeWeights( void ) const;
             void trainpatch( const ublas::matrix<T>&, const std::size_t& );
@@ -123,6 +130,9 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
             bool m_firstpatch;
             
             T calculateQuantizationError( const ublas::matrix<T>&, const ublas::matrix<T>& ) const;
+            #ifndef SWIG
+            T calculateQuantizationError( const ublas::compressed_matrix<T>&, const ublas::matrix<T>& ) const;
+            #endif
             
             #ifdef MACHINELEARNING_MPI
             /** map with information to every process and prototype**/
@@ -342,6 +352,97 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
     }
     
     
+    /** train the prototypes with sparse data (e.g. a TF-IDF document-term matrix)
+     * @param p_data sparse data matrix
+     * @param p_iterations number of iterations
+     **/
+    template<typename T> inline void neuralgas<T>::train( const ublas::compressed_matrix<T>& p_data, const std::size_t& p_iterations )
+    {
+        train(p_data, p_iterations, m_prototypes.size1() * 0.5);
+    }
+    
+    
+    /** training the prototypes with sparse data. The distances and the adaption
+     * use only the non-zero elements of the data
+     * @param p_data sparse datapoints
+     * @param p_iterations iterations
+     * @param p_lambda max adapet size
+     **/
+    template<typename T> inline void neuralgas<T>::train( const ublas::compressed_matrix<T>& p_data, const std::size_t& p_iterations, const T& p_lambda )
+    {
+        if (m_prototypes.size1() == 0)
+            throw exception::runtime(_("number of prototypes must be greater than zero"), *this);
+        if (p_data.size1() < m_prototypes.size1())
+            throw exception::runtime(_("number of datapoints are less than prototypes"), *this);
+        if (p_iterations == 0)
+            throw exception::runtime(_("iterations must be greater than zero"), *this);
+        if (p_data.size2() != m_prototypes.size2())
+            throw exception::runtime(_("data and prototype dimension are not equal"), *this);
+        if (p_lambda <= 0)
+            throw exception::runtime(_("lambda must be greater than zero"), *this);
+        
+        // creates logging
+        if (m_logging) {
+            m_logprototypes.clear();
+            m_quantizationerror.clear();
+            m_logprototypes.reserve(p_iterations);
+            m_quantizationerror.reserve(p_iterations);
+        }
+        
+        
+        // run neural gas       
+        const T l_multi = 0.01/p_lambda;
+        ublas::matrix<T> l_adaptmatrix( m_prototypes.size1(), p_data.size1() );
+        ublas::vector<T> l_lambda(m_prototypes.size1());
+        
+        for(std::size_t i=0; i < p_iterations; ++i) {
+            
+            // determine quantization error for logging
+            if (m_logging) {
+                m_logprototypes.push_back( m_prototypes );
+                m_quantizationerror.push_back( calculateQuantizationError(p_data, m_prototypes) );
+            }
+            
+            
+            // create adapt values
+            const T l_lambdahelp = p_lambda * std::pow(l_multi, static_cast<T>(i)/static_cast<T>(p_iterations));
+            
+            #pragma omp parallel for shared(l_lambda)
+            for(std::size_t n=0; n < l_lambda.size(); ++n)
+                l_lambda(n) = std::exp( -static_cast<T>(n) / l_lambdahelp );
+            
+            
+            // calculate for every prototype the distance
+            #pragma omp parallel for shared(l_adaptmatrix)
+            for(std::size_t n=0; n < m_prototypes.size1(); ++n)
+                ublas::row(l_adaptmatrix, n)  = m_distance.getDistance( p_data, ublas::row(m_prototypes, n) );
+            
+            
+            // for every column ranks values and create adapts
+            #pragma omp parallel for shared(l_adaptmatrix)
+            for(std::size_t n=0; n < l_adaptmatrix.size2(); ++n) {
+                ublas::vector<T> l_column                = ublas::column(l_adaptmatrix, n);
+                const ublas::vector<std::size_t> l_rank  = tools::vector::rank(l_column);
+                
+                for(std::size_t j=0; j < l_rank.size(); ++j)
+                    l_adaptmatrix(j,n) = l_lambda(l_rank(j));
+            }
+            
+            
+            // create and normalize prototypes
+            m_prototypes = tools::matrix::sparseprod( l_adaptmatrix, p_data );
+            
+            #pragma omp parallel for
+            for(std::size_t n=0; n < m_prototypes.size1(); ++n) {
+                const T l_norm = ublas::sum( ublas::row(l_adaptmatrix, n) );
+                
+                if (!tools::function::isNumericalZero(l_norm))
+                    ublas::row(m_prototypes, n) /= l_norm;
+            }
+        }
+    }
+    
+    
     /** calculate the quantization error
      * @param p_data matrix with data points
      * @param p_prototypes prototype matrix
@@ -359,6 +460,23 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
     }
     
     
+    /** calculate the quantization error of sparse data
+     * @param p_data sparse matrix with data points
+     * @param p_prototypes prototype matrix
+     * @return quantization error
+     **/    
+    template<typename T> inline T neuralgas<T>::calculateQuantizationError( const ublas::compressed_matrix<T>& p_data, const ublas::matrix<T>& p_prototypes ) const
+    {
+        ublas::matrix<T> l_distances( p_prototypes.size1(), p_data.size1() );
+        
+        #pragma omp parallel for shared(l_distances)
+        for(std::size_t i=0; i < p_prototypes.size1(); ++i)
+            ublas::row(l_distances, i) = m_distance.getDistance( p_data, ublas::row(p_prototypes, i) );
+        
+        return 0.5 * ublas::sum(  m_distance.getAbs(tools::matrix::min(l_distances, tools::matrix::column))  );  
+    }
+    
+    
     /** calulates distance between datapoints and prototypes and returns a indirect array
      * with index of the nearest prototype
      * @param p_data matrix
@@ -389,6 +507,38 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
         
         return l_idx;
     }
+    
+    
+    /** calulates distance between sparse datapoints and prototypes and returns a indirect array
+     * with index of the nearest prototype
+     * @param p_data sparse matrix
+     * @return index array of prototype indices
+     **/
+    template<typename T> inline ublas::indirect_array<> neuralgas<T>::use( const ublas::compressed_matrix<T>& p_data ) const
+    {
+        if (m_prototypes.size1() == 0)
+            throw exception::runtime(_("number of prototypes must be greater than zero"), *this);
+        if (p_data.size2() != m_prototypes.size2())
+            throw exception::runtime(_("data and prototype dimension are not equal"), *this);
+        
+        ublas::indirect_array<> l_idx(p_data.size1());
+        ublas::matrix<T> l_distance(m_prototypes.size1(), p_data.size1());
+        
+        // calculate distance for every prototype
+        #pragma omp parallel for shared(l_distance)
+        for(std::size_t i=0; i < m_prototypes.size1(); ++i)
+            ublas::row(l_distance, i)  = m_distance.getDistance( p_data, ublas::row(m_prototypes, i) );
+        
+        // determine nearest prototype
+        #pragma omp parallel for shared(l_idx)
+        for(std::size_t i=0; i < l_distance.size2(); ++i) {
+            ublas::vector<T> l_col                = ublas::column(l_distance, i);
+            const ublas::indirect_array<> l_rank  = tools::vector::rankIndex( l_col );
+            l_idx[i] = l_rank(0);
+        }
+        
+        return l_idx;
+    }
   
     
     /** train a patch (input data) with the data (include the weights)
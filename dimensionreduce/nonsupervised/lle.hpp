@@ -25,6 +25,10 @@
 #define __MACHINELEARNING_DIMENSIONREDUCE_NONSUPERVISED_LLE_HPP
 
 
+#include <vector>
+#include <algorithm>
+#include <omp.h>
+
 #include <boost/numeric/ublas/vector.hpp>
 #include <boost/numeric/ublas/matrix.hpp>
 #include <boost/numeric/ublas/matrix_sparse.hpp>
@@ -34,16 +38,15 @@
 #include "../../errorhandling/exception.hpp"
 #include "../../tools/tools.h"
 
-#include <iostream>
-#include <boost/numeric/ublas/io.hpp>
-
 
 namespace machinelearning { namespace dimensionreduce { namespace nonsupervised {
     
     namespace ublas  = boost::numeric::ublas;
     
     
-    /** create the local linear embedding (LLE) **/
+    /** create the local linear embedding (LLE). The embedding matrix is stored sparse
+     * and the bottom eigenvectors are calculated with the LOBPCG solver
+     **/
     template<typename T> class lle : public reduce<T>
     {
         
@@ -52,6 +55,8 @@ namespace machinelearning { namespace dimensionreduce { namespace nonsupervised
             lle( const neighborhood::neighborhood<T>&, const std::size_t& );
             ublas::matrix<T> map( const ublas::matrix<T>& );
             std::size_t getDimension( void ) const;
+            void setIteration( const std::size_t& );
+            void setTolerance( const T& );
         
         
         private :
@@ -60,6 +65,13 @@ namespace machinelearning { namespace dimensionreduce { namespace nonsupervised
             const neighborhood::neighborhood<T>& m_neighborhood;
             /** target dimension **/
             const std::size_t m_dim;
+            /** maximum iterations of the eigensolver **/
+            std::size_t m_iteration;
+            /** residual tolerance of the eigensolver **/
+            T m_tolerance;
+        
+            bool cholesky_solve( ublas::matrix<T>&, ublas::vector<T>& ) const;
+            ublas::compressed_matrix<T> embedding_matrix( const ublas::matrix<std::size_t>&, const ublas::matrix<T>& ) const;
         
     };
 
@@ -71,7 +83,9 @@ namespace machinelearning { namespace dimensionreduce { namespace nonsupervised
      **/
     template<typename T> inline lle<T>::lle( const neighborhood::neighborhood<T>& p_neighborhood, const std::size_t& p_dim ) :
         m_neighborhood( p_neighborhood ),
-        m_dim( p_dim )
+        m_dim( p_dim ),
+        m_iteration( 1000 ),
+        m_tolerance( 1e-5 )
     {
         if (p_dim == 0)
             throw exception::runtime(_("dimension must be greater than zero"), *this);
@@ -87,9 +101,31 @@ namespace machinelearning { namespace dimensionreduce { namespace nonsupervised
     }
     
     
+    /** sets the maximum number of iterations of the eigensolver (the eigensolver throws an exception, if it does not converge)
+     * @param p_iteration number of iterations
+     **/
+    template<typename T> inline void lle<T>::setIteration( const std::size_t& p_iteration )
+    {
+        if (p_iteration == 0)
+            throw exception::runtime(_("iterations must be greater than zero"), *this);
+        
+        m_iteration = p_iteration;
+    }
+    
+    
+    /** sets the residual tolerance of the eigensolver relative to the matrix norm (default 1e-5)
+     * @param p_tolerance tolerance value
+     **/
+    template<typename T> inline void lle<T>::setTolerance( const T& p_tolerance )
+    {
+        if (p_tolerance <= 0)
+            throw exception::runtime(_("tolerance must be greater than zero"), *this);
+        
+        m_tolerance = p_tolerance;
+    }
+    
+    
     /** caluate and project the input data
-     * @todo project matrix change to a sparse matrix if arpack can used with boost
-     * @bug it is uncomplete
      * @param p_data input datamatrix
      * @return matrix with mapped points
      **/
@@ -97,65 +133,202 @@ namespace machinelearning { namespace dimensionreduce { namespace nonsupervised
     {
         if (p_data.size2() <= m_dim)
             throw exception::runtime(_("data points are less than target dimension"), *this);
+        if (p_data.size1() < 3*(m_dim+1))
+            throw exception::runtime(_("number of data points is too small for the target dimension"), *this);
         
         // if number of neighborhood greate than data dimension (column size)
         // regularize weight-matrix
         const T l_tolerance = 1.0/10000.0;
-        const ublas::matrix<T> l_regular = tools::matrix::diag<T>( ublas::vector<T>(m_neighborhood.getNeighborCount(), l_tolerance) );
-        const bool l_regularize = m_neighborhood.getNeighborCount() > p_data.size2();
+        const std::size_t l_count = m_neighborhood.getNeighborCount();
+        const bool l_regularize = l_count > p_data.size2();
         
         // calculate neighborhood index and create some structires
-        const ublas::scalar_vector<T> l_ones(m_neighborhood.getNeighborCount(), 1);
         const ublas::matrix<std::size_t> l_neighborhood = m_neighborhood.get( p_data );
-        ublas::matrix<T> l_weight(p_data.size1(), m_neighborhood.getNeighborCount());
+        ublas::matrix<T> l_weight(p_data.size1(), l_count);
         
-        // calculate weight matrix
+        // calculate weight matrix, every local system is independent
+        #pragma omp parallel for shared(l_weight)
         for(std::size_t i=0; i < p_data.size1(); ++i) {
         
             // subtract every point from their neighbors (centering neighbors to the point)
-            ublas::matrix<T> l_local( m_neighborhood.getNeighborCount(), p_data.size2() );
-            for(std::size_t j=0; j < m_neighborhood.getNeighborCount(); ++j)
+            ublas::matrix<T> l_local( l_count, p_data.size2() );
+            for(std::size_t j=0; j < l_count; ++j)
                 ublas::row(l_local, j) = ublas::row(p_data, l_neighborhood(i, j)) - ublas::row(p_data, i);
                     
-            // symmetrize matrix (add tolerance)
+            // symmetric local gram matrix (add tolerance)
+            const ublas::matrix<T> l_gram = ublas::prod(l_local, ublas::trans(l_local));
+            T l_regular = l_regularize ? l_tolerance * tools::matrix::trace<T>(l_gram) : static_cast<T>(0);
+            
+            // solve the lineare equation, if the matrix is not positive definite the regularization is increased
             ublas::vector<T> l_result;
-            ublas::matrix<T> l_localweight = ublas::prod(l_local, ublas::trans(l_local));
+            for(bool l_solved = false; !l_solved; ) {
+                ublas::matrix<T> l_localweight = l_gram;
+                for(std::size_t j=0; j < l_count; ++j)
+                    l_localweight(j, j) += l_regular;
+                
+                l_result = ublas::scalar_vector<T>(l_count, 1);
+                l_solved = cholesky_solve( l_localweight, l_result );
+                
+                l_regular = std::max( 10 * l_regular, l_tolerance * std::max(static_cast<T>(1), tools::matrix::trace<T>(l_gram)) );
+            }
             
-            if (l_regularize)
-                l_localweight += l_regular * tools::matrix::trace<T>(l_localweight);
-
-            // solve the lineare equation and normalize
-            tools::lapack::solve<T>( l_localweight, l_ones, l_result );
+            // normalize
             ublas::row(l_weight, i) = l_result / ublas::sum(l_result);
         }
- 
         
-        // create weight matrix (I-W)' * (I-W) for the data
-        ublas::mapped_matrix<T> l_project = tools::matrix::eye<T>(p_data.size1());
-        for(std::size_t i=0; i < l_weight.size1(); ++i) {
+        // calculate the bottom eigenvalues & -vectors of the sparse matrix (I-W)' * (I-W),
+        // the smallest eigenvector is the constant vector, so it is removed
+        ublas::vector<T> l_eigenvalues;
+        ublas::matrix<T> l_eigenvectors;
+        tools::lapack::lobpcg<T>( embedding_matrix(l_neighborhood, l_weight), m_dim+1, l_eigenvalues, l_eigenvectors, m_iteration, m_tolerance );
+        
+        return ublas::project( l_eigenvectors, ublas::range(0, l_eigenvectors.size1()), ublas::range(1, m_dim+1) );
+    }
+    
+    
+    /** solves a symmetric positive definite system in-place with Cholesky decomposition
+     * @param p_matrix symmetric matrix, will be overwritten by the decomposition
+     * @param p_vec right-hand side, will be overwritten by the solution
+     * @return false if the matrix is not positive definite
+     **/
+    template<typename T> inline bool lle<T>::cholesky_solve( ublas::matrix<T>& p_matrix, ublas::vector<T>& p_vec ) const
+    {
+        // decomposition A = L * L' (L is stored in the lower triangle)
+        for(std::size_t j=0; j < p_matrix.size1(); ++j) {
+            T l_diag = p_matrix(j, j);
+            for(std::size_t k=0; k < j; ++k)
+                l_diag -= p_matrix(j, k) * p_matrix(j, k);
+            
+            if ( (l_diag <= 0) || (tools::function::isNumericalZero(l_diag)) )
+                return false;
+            p_matrix(j, j) = std::sqrt(l_diag);
             
-            const ublas::vector<std::size_t> l_ndidx = ublas::row(l_neighborhood, i);
-            const ublas::vector<T> l_pointweights    = ublas::row(l_weight, i);
-            const ublas::matrix<T> l_mat             = ublas::outer_prod(l_pointweights, l_pointweights);
+            for(std::size_t i=j+1; i < p_matrix.size1(); ++i) {
+                T l_val = p_matrix(i, j);
+                for(std::size_t k=0; k < j; ++k)
+                    l_val -= p_matrix(i, k) * p_matrix(j, k);
+                p_matrix(i, j) = l_val / p_matrix(j, j);
+            }
+        }
+        
+        // forward substitution L * y = b
+        for(std::size_t i=0; i < p_vec.size(); ++i) {
+            for(std::size_t k=0; k < i; ++k)
+                p_vec(i) -= p_matrix(i, k) * p_vec(k);
+            p_vec(i) /= p_matrix(i, i);
+        }
+        
+        // backward substitution L' * x = y
+        for(std::size_t i=p_vec.size(); i > 0; --i) {
+            for(std::size_t k=i; k < p_vec.size(); ++k)
+                p_vec(i-1) -= p_matrix(k, i-1) * p_vec(k);
+            p_vec(i-1) /= p_matrix(i-1, i-1);
+        }
+        
+        return true;
+    }
+    
+    
+    /** creates the sparse embedding matrix M = (I-W)' * (I-W). Every row of M is build independently
+     * with the reverse neighborhood (all points which use the row point as neighbor)
+     * @param p_neighborhood neighborhood index matrix
+     * @param p_weight weight matrix
+     * @return row compressed matrix
+     **/
+    template<typename T> inline ublas::compressed_matrix<T> lle<T>::embedding_matrix( const ublas::matrix<std::size_t>& p_neighborhood, const ublas::matrix<T>& p_weight ) const
+    {
+        const std::size_t l_size = p_neighborhood.size1();
+        
+        // reverse neighborhood in compressed form (point index and neighbor position)
+        std::vector<std::size_t> l_reverseptr(l_size+1, 0);
+        for(std::size_t i=0; i < l_size; ++i)
+            for(std::size_t j=0; j < p_neighborhood.size2(); ++j)
+                l_reverseptr[p_neighborhood(i, j)+1]++;
+        for(std::size_t i=0; i < l_size; ++i)
+            l_reverseptr[i+1] += l_reverseptr[i];
+        
+        std::vector<std::size_t> l_reversepoint(l_reverseptr[l_size]);
+        std::vector<std::size_t> l_reversepos(l_reverseptr[l_size]);
+        std::vector<std::size_t> l_fill(l_reverseptr.begin(), l_reverseptr.end()-1);
+        for(std::size_t i=0; i < l_size; ++i)
+            for(std::size_t j=0; j < p_neighborhood.size2(); ++j) {
+                const std::size_t l_idx = l_fill[p_neighborhood(i, j)]++;
+                l_reversepoint[l_idx]   = i;
+                l_reversepos[l_idx]     = j;
+            }
+        
+        
+        // create rows: M(a,b) = delta(a,b) - W(a,b) - W(b,a) + sum_i W(i,a) * W(i,b)
+        std::vector< std::vector<std::size_t> > l_columns(l_size);
+        std::vector< std::vector<T> > l_values(l_size);
+        
+        #pragma omp parallel shared(l_columns, l_values)
+        {
+            std::vector<T> l_accumulate(l_size, static_cast<T>(0));
+            std::vector<bool> l_used(l_size, false);
+            std::vector<std::size_t> l_touched;
             
-            for(std::size_t j=0; j < l_pointweights.size(); ++j) {
-                l_project(i, l_ndidx(j)) -= l_pointweights(j);
-                l_project(l_ndidx(j), i) -= l_pointweights(j);
+            #pragma omp for
+            for(std::size_t a=0; a < l_size; ++a) {
+                l_touched.clear();
+                
+                l_touched.push_back(a);
+                l_used[a] = true;
+                l_accumulate[a] = static_cast<T>(1);
                 
-                for(std::size_t n=0; n < l_pointweights.size(); ++n)
-                    l_project(l_ndidx(j),l_ndidx(n))    += l_mat(j, n);
+                for(std::size_t j=0; j < p_neighborhood.size2(); ++j) {
+                    const std::size_t b = p_neighborhood(a, j);
+                    if (!l_used[b]) {
+                        l_used[b] = true;
+                        l_touched.push_back(b);
+                    }
+                    l_accumulate[b] -= p_weight(a, j);
+                }
+                
+                for(std::size_t n=l_reverseptr[a]; n < l_reverseptr[a+1]; ++n) {
+                    const std::size_t i = l_reversepoint[n];
+                    const T l_wia       = p_weight(i, l_reversepos[n]);
+                    
+                    if (!l_used[i]) {
+                        l_used[i] = true;
+                        l_touched.push_back(i);
+                    }
+                    l_accumulate[i] -= l_wia;
+                    
+                    for(std::size_t j=0; j < p_neighborhood.size2(); ++j) {
+                        const std::size_t b = p_neighborhood(i, j);
+                        if (!l_used[b]) {
+                            l_used[b] = true;
+                            l_touched.push_back(b);
+                        }
+                        l_accumulate[b] += l_wia * p_weight(i, j);
+                    }
+                }
+                
+                // copy the row in column order and reset the accumulator
+                std::sort(l_touched.begin(), l_touched.end());
+                l_columns[a] = l_touched;
+                l_values[a].resize(l_touched.size());
+                for(std::size_t n=0; n < l_touched.size(); ++n) {
+                    l_values[a][n]                = l_accumulate[l_touched[n]];
+                    l_accumulate[l_touched[n]]    = static_cast<T>(0);
+                    l_used[l_touched[n]]          = false;
+                }
             }
         }
         
-        // calculate the eigenvalues & -vectors
-        ublas::vector<T> l_eigenvalues;
-        ublas::matrix<T> l_eigenvectors;
-        tools::lapack::eigen<T>(l_project, l_eigenvalues, l_eigenvectors);
-         
-        std::cout << l_eigenvalues << std::endl;
         
-        return l_eigenvectors;
+        // the compressed matrix is filled row by row
+        std::size_t l_nonzero = 0;
+        for(std::size_t i=0; i < l_size; ++i)
+            l_nonzero += l_columns[i].size();
+        
+        ublas::compressed_matrix<T> l_matrix(l_size, l_size, l_nonzero);
+        for(std::size_t i=0; i < l_size; ++i)
+            for(std::size_t j=0; j < l_columns[i].size(); ++j)
+                l_matrix.push_back(i, l_columns[i][j], l_values[i][j]);
         
+        return l_matrix;
     }
 
 }}}
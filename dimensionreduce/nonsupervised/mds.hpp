@@ -27,7 +27,10 @@
 #include <omp.h>
 
 #include <limits>
+#include <vector>
+#include <algorithm>
 #include <boost/static_assert.hpp>
+#include <boost/math/special_functions/fpclassify.hpp>
 #include <boost/numeric/ublas/matrix.hpp>
 
 #ifdef MACHINELEARNING_MPI
@@ -49,8 +52,11 @@ namespace machinelearning { namespace dimensionreduce { namespace nonsupervised
     #endif
     
     
-    /** create the multidimensional scaling (MDS) with different algorithms **/
-    template<typename T> class mds : public reduce<T>
+    /** create the multidimensional scaling (MDS) with different algorithms. Only the landmark
+     * projection supports fit / transform, the input of transform are the dissimilarities of the
+     * new points to the landmarks, fit throws for the other algorithms
+     **/
+    template<typename T> class mds : public reduce<T>, public reducefit<T>
         #ifdef MACHINELEARNING_MPI
         , public reducempi<T>
         #endif
@@ -65,7 +71,9 @@ namespace machinelearning { namespace dimensionreduce { namespace nonsupervised
             enum project {
                 metric              = 0,
                 sammon              = 1,
-                hit                 = 2
+                hit                 = 2,
+                smacof              = 3,
+                landmark            = 4
             };
             
             enum centeroption {
@@ -77,11 +85,22 @@ namespace machinelearning { namespace dimensionreduce { namespace nonsupervised
         
             mds( const std::size_t&, const project& = metric );
             ublas::matrix<T> map( const ublas::matrix<T>& );
+            void fit( const ublas::matrix<T>& );
+            ublas::matrix<T> transform( const ublas::matrix<T>& ) const;
+            std::vector<std::size_t> getLandmarks( void ) const;
             std::size_t getDimension( void ) const;
             void setIteration( const std::size_t& );
             void setStep( const std::size_t& );
             void setRate( const T& );
             void setCentering( const centeroption& );
+            void setTolerance( const T& );
+            void setWeights( const ublas::matrix<T>& );
+            void setLandmarks( const std::size_t& );
+        
+            #ifndef SWIG
+            template<typename F> ublas::matrix<T> map( const std::size_t&, const F& );
+            template<typename F> void fit( const std::size_t&, const F& );
+            #endif
         
             #ifdef MACHINELEARNING_MPI
             ublas::matrix<T> map( const mpi::communicator&, const ublas::matrix<T>& );
@@ -96,21 +115,72 @@ namespace machinelearning { namespace dimensionreduce { namespace nonsupervised
             std::size_t m_step;
             /** rate value for hit **/
             T m_rate;
+            /** relative stress tolerance for early stopping of smacof **/
+            T m_tolerance;
+            /** weight matrix for smacof (empty matrix for unweighted) **/
+            ublas::matrix<T> m_weights;
+            /** number of landmarks **/
+            std::size_t m_landmarks;
+            /** point indices of the fitted landmarks **/
+            std::vector<std::size_t> m_landmarkindex;
+            /** mean squared distance of each fitted landmark to the other landmarks **/
+            ublas::vector<T> m_landmarkmean;
+            /** triangulation matrix of the fitted landmarks **/
+            ublas::matrix<T> m_landmarkproject;
             /** target dimension **/
             const std::size_t m_dim;
             /** project type **/
             const project m_type;
             /** centering **/
             centeroption m_centering;
+            /** number of rows / columns, that are processed together within the blocked kernels **/
+            static const std::size_t m_blocksize = 256;
+            
+            
+            #ifndef SWIG
+            /** distance callback for a dissimilarity matrix **/
+            class matrixdistance
+            {
+                public :
+                
+                    /** constructor
+                     * @param p_matrix dissimilarity matrix
+                     **/
+                    matrixdistance( const ublas::matrix<T>& p_matrix ) : m_matrix( p_matrix ) {}
+                
+                    /** returns the dissimilarity
+                     * @param p_first first index
+                     * @param p_second second index
+                     * @return dissimilarity value
+                     **/
+                    T operator()( const std::size_t& p_first, const std::size_t& p_second ) const { return m_matrix(p_first, p_second); }
+                
+                private :
+                
+                    /** reference to the matrix **/
+                    const ublas::matrix<T>& m_matrix;
+            };
+            #endif
             
             
             ublas::matrix<T> project_metric( const ublas::matrix<T>& ) const;
             ublas::matrix<T> project_sammon( const ublas::matrix<T>& ) const;
             ublas::matrix<T> project_hit( const ublas::matrix<T>& ) const;
+            ublas::matrix<T> project_smacof( const ublas::matrix<T>& ) const;
         
             ublas::matrix<T> sammon_distance( const ublas::matrix<T>& ) const;
             T sammon_calculateQuantizationError( const ublas::matrix<T>&, const ublas::matrix<T>& ) const;
             void hit_setZeros(const std::vector< std::pair<std::size_t, std::size_t> >&, ublas::matrix<T>& ) const;
+            T target_distance( const ublas::matrix<T>&, const std::size_t&, const std::size_t& ) const;
+            T smacof_transform( const ublas::matrix<T>&, const ublas::matrix<T>&, ublas::matrix<T>& ) const;
+            void smacof_weightprod( const ublas::matrix<T>&, ublas::matrix<T>& ) const;
+            T smacof_inner( const ublas::matrix<T>&, const ublas::matrix<T>& ) const;
+            void smacof_solve( const ublas::matrix<T>&, ublas::matrix<T>&, ublas::matrix<T>&, ublas::matrix<T>&, ublas::matrix<T>& ) const;
+            void landmark_fit( const ublas::matrix<T>&, const std::vector<std::size_t>& );
+        
+            #ifndef SWIG
+            template<typename F> ublas::matrix<T> landmark_select( const std::size_t&, const F& );
+            #endif
         
             #ifdef MACHINELEARNING_MPI
             ublas::matrix<T> project_hit( const mpi::communicator&, const ublas::matrix<T>& ) const;
@@ -121,6 +191,10 @@ namespace machinelearning { namespace dimensionreduce { namespace nonsupervised
     };
     
     
+    /** definition of the kernel block size **/
+    template<typename T> const std::size_t mds<T>::m_blocksize;
+    
+    
     /** constructor
      * @param p_dim target dimension
      * @param p_type project type
@@ -129,6 +203,12 @@ namespace machinelearning { namespace dimensionreduce { namespace nonsupervised
         m_iteration( 500 ),
         m_step( 20 ),
         m_rate( 1 ),
+        m_tolerance( static_cast<T>(1e-6) ),
+        m_weights( ublas::matrix<T>() ),
+        m_landmarks( 50 ),
+        m_landmarkindex(),
+        m_landmarkmean(),
+        m_landmarkproject(),
         m_dim( p_dim ),
         m_type( p_type ),
         m_centering( none )
@@ -173,6 +253,51 @@ namespace machinelearning { namespace dimensionreduce { namespace nonsupervised
     }
     
     
+    /** sets the relative tolerance of the stress for early stopping of smacof
+     * @param p_tolerance tolerance value (zero runs all iterations)
+     **/
+    template<typename T> inline void mds<T>::setTolerance( const T& p_tolerance )
+    {
+        if (p_tolerance < 0)
+            throw exception::runtime(_("tolerance must be greater or equal than zero"), *this);
+        
+        m_tolerance = p_tolerance;
+    }
+    
+    
+    /** sets the weight matrix for smacof (an empty matrix disables the weighting)
+     * @param p_weights symmetric matrix with non-negative weights for each dissimilarity
+     **/
+    template<typename T> inline void mds<T>::setWeights( const ublas::matrix<T>& p_weights )
+    {
+        if (p_weights.size1() != p_weights.size2())
+            throw exception::runtime(_("weight matrix must be square"), *this);
+        
+        // the laplacian of the weights is positive semi-definite only with symmetric non-negative weights
+        for(std::size_t i=0; i < p_weights.size1(); ++i)
+            for(std::size_t j=i; j < p_weights.size2(); ++j) {
+                if ( (!boost::math::isfinite(p_weights(i,j))) || (p_weights(i,j) < 0) )
+                    throw exception::runtime(_("weights must be finite and greater or equal than zero"), *this);
+                if (p_weights(i,j) != p_weights(j,i))
+                    throw exception::runtime(_("weight matrix must be symmetric"), *this);
+            }
+        
+        m_weights = p_weights;
+    }
+    
+    
+    /** sets the number of landmarks for the landmark projection
+     * @param p_landmarks number of landmarks (must be greater than the target dimension)
+     **/
+    template<typename T> inline void mds<T>::setLandmarks( const std::size_t& p_landmarks )
+    {
+        if (p_landmarks <= m_dim)
+            throw exception::runtime(_("number of landmarks must be greater than target dimension"), *this);
+        
+        m_landmarks = p_landmarks;
+    }
+    
+    
     /** enables / disables centering before mapping
      * @param p_center centering option
      **/
@@ -220,6 +345,12 @@ namespace machinelearning { namespace dimensionreduce { namespace nonsupervised
                 
             case hit :
                 return project_hit(l_data);
+                
+            case smacof :
+                return project_smacof(l_data);
+                
+            case landmark :
+                return map( l_data.size1(), matrixdistance(l_data) );
                        
             default :
                 throw exception::runtime(_("project option is unkown"), *this);
@@ -229,6 +360,155 @@ namespace machinelearning { namespace dimensionreduce { namespace nonsupervised
     
     
     
+    /** caluate the landmark projection with a distance callback, so only the distances between each point and the landmarks
+     * are calculated (the dissimilarity matrix is never created). The landmarks are selected with the max-min strategy
+     * @note the callback is called in parallel, so it must be thread-safe
+     * @see http://graphics.stanford.edu/courses/cs468-05-winter/Papers/Landmarks/Silva_landmarks5.pdf
+     * @param p_size number of data points
+     * @param p_distance distance function object with the signature T operator()( const std::size_t&, const std::size_t& ) const
+     * @return mapped data
+     **/
+    template<typename T> template<typename F> inline ublas::matrix<T> mds<T>::map( const std::size_t& p_size, const F& p_distance )
+    {
+        const ublas::matrix<T> l_distance = landmark_select( p_size, p_distance );
+        return tools::matrix::blockprod<T>( l_distance, m_landmarkproject, m_landmarkmean );
+    }
+    
+    
+    /** fits the landmark projection with a distance callback, new points can be projected with transform
+     * @note the callback is called in parallel, so it must be thread-safe
+     * @param p_size number of data points
+     * @param p_distance distance function object with the signature T operator()( const std::size_t&, const std::size_t& ) const
+     **/
+    template<typename T> template<typename F> inline void mds<T>::fit( const std::size_t& p_size, const F& p_distance )
+    {
+        landmark_select( p_size, p_distance );
+    }
+    
+    
+    /** fits the landmark projection with a dissimilarity matrix (the centering option is not used)
+     * @param p_data dissimilarity matrix
+     **/
+    template<typename T> inline void mds<T>::fit( const ublas::matrix<T>& p_data )
+    {
+        if (p_data.size1() != p_data.size2())
+            throw exception::runtime( _("matrix must be square"), *this );
+        
+        landmark_select( p_data.size1(), matrixdistance(p_data) );
+    }
+    
+    
+    /** projects new points with the fitted landmarks (triangulation)
+     * @param p_distance dissimilarities between each new point (row) and the landmarks (columns in the order of getLandmarks)
+     * @return mapped data
+     **/
+    template<typename T> inline ublas::matrix<T> mds<T>::transform( const ublas::matrix<T>& p_distance ) const
+    {
+        if (m_landmarkindex.size() == 0)
+            throw exception::runtime(_("projection is not fitted"), *this);
+        if (p_distance.size2() != m_landmarkindex.size())
+            throw exception::runtime(_("column size must be equal to the number of landmarks"), *this);
+        
+        return tools::matrix::blockprod<T>( ublas::element_prod(p_distance, p_distance), m_landmarkproject, m_landmarkmean );
+    }
+    
+    
+    /** returns the point indices of the fitted landmarks
+     * @return index vector
+     **/
+    template<typename T> inline std::vector<std::size_t> mds<T>::getLandmarks( void ) const
+    {
+        return m_landmarkindex;
+    }
+    
+    
+    /** selects the landmarks, the next landmark is the point with the maximum distance to the nearest landmark,
+     * and fits the projection of the landmarks
+     * @param p_size number of data points
+     * @param p_distance distance function object
+     * @return squared distances of all points to the landmarks (column-wise)
+     **/
+    template<typename T> template<typename F> inline ublas::matrix<T> mds<T>::landmark_select( const std::size_t& p_size, const F& p_distance )
+    {
+        if (m_type != landmark)
+            throw exception::runtime(_("distance callback and fit can be used only with the landmark projection"), *this);
+        if (p_size <= m_dim)
+            throw exception::runtime(_("datapoint dimension are less than target dimension"), *this);
+        
+        const std::size_t l_count = std::min(m_landmarks, p_size);
+        ublas::matrix<T> l_distance( p_size, l_count );
+        ublas::vector<T> l_nearest( p_size, std::numeric_limits<T>::max() );
+        std::vector<std::size_t> l_landmarks;
+        
+        std::size_t l_next = 0;
+        for(std::size_t j=0; j < l_count; ++j) {
+            l_landmarks.push_back( l_next );
+            
+            #pragma omp parallel for shared(l_distance, l_nearest)
+            for(std::size_t i=0; i < p_size; ++i) {
+                const T l_value = p_distance(i, l_landmarks[j]);
+                l_distance(i,j) = l_value * l_value;
+                l_nearest(i)    = std::min( l_nearest(i), l_value );
+            }
+            
+            l_next = static_cast<std::size_t>( std::max_element(l_nearest.begin(), l_nearest.end()) - l_nearest.begin() );
+            if (tools::function::isNumericalZero(l_nearest(l_next)))
+                break;
+        }
+        
+        if (l_landmarks.size() <= m_dim)
+            throw exception::runtime(_("number of landmarks must be greater than target dimension"), *this);
+        if (l_landmarks.size() < l_count)
+            l_distance.resize( p_size, l_landmarks.size(), true );
+        
+        landmark_fit( l_distance, l_landmarks );
+        return l_distance;
+    }
+    
+    
+    /** calculates the classical scaling of the landmarks and creates the triangulation matrix
+     * @param p_distance squared distances between each point and the landmarks
+     * @param p_landmarks point indices of the landmarks
+     **/
+    template<typename T> inline void mds<T>::landmark_fit( const ublas::matrix<T>& p_distance, const std::vector<std::size_t>& p_landmarks )
+    {
+        // create the symmetric squared distance matrix of the landmarks
+        ublas::matrix<T> l_landmark( p_landmarks.size(), p_landmarks.size() );
+        for(std::size_t i=0; i < l_landmark.size1(); ++i)
+            for(std::size_t j=0; j < l_landmark.size2(); ++j)
+                l_landmark(i,j) = static_cast<T>(0.5) * (p_distance(p_landmarks[i], j) + p_distance(p_landmarks[j], i));
+        
+        // classical scaling of the landmarks (double centered inner product matrix)
+        const ublas::vector<T> l_mean  = tools::matrix::mean(l_landmark, tools::matrix::column);
+        const T l_fullmean             = ublas::sum(l_mean) / l_mean.size();
+        
+        ublas::matrix<T> l_inner( l_landmark.size1(), l_landmark.size2() );
+        for(std::size_t i=0; i < l_inner.size1(); ++i)
+            for(std::size_t j=0; j < l_inner.size2(); ++j)
+                l_inner(i,j) = static_cast<T>(-0.5) * (l_landmark(i,j) - l_mean(i) - l_mean(j) + l_fullmean);
+        
+        ublas::vector<T> l_eigenvalues;
+        ublas::matrix<T> l_eigenvectors;
+        tools::lapack::eigen<T>(l_inner, l_eigenvalues, l_eigenvectors);
+        const ublas::indirect_array<> l_rank = tools::vector::rankIndex( l_eigenvalues );
+        
+        // create pseudo inverse of the landmark projection (largest eigenvectors scaled with the inverse square root of the eigenvalues),
+        // the factor of the triangulation is stored within the matrix
+        ublas::matrix<T> l_project( l_eigenvectors.size1(), m_dim );
+        for(std::size_t i=0; i < m_dim; ++i) {
+            const T l_value = l_eigenvalues(l_rank(l_rank.size()-i-1));
+            if ( (l_value < 0) || (tools::function::isNumericalZero(l_value)) )
+                throw exception::runtime(_("landmarks have less positive eigenvalues than target dimension"), *this);
+            
+            ublas::column(l_project, i) = static_cast<T>(-0.5) * ublas::column(l_eigenvectors, l_rank(l_rank.size()-i-1)) / std::sqrt(l_value);
+        }
+        
+        m_landmarkindex   = p_landmarks;
+        m_landmarkmean    = l_mean;
+        m_landmarkproject = l_project;
+    }
+    
+    
     /** caluate the metric MDS (for metric we use eigenvalues)
      * @param p_data input datamatrix (dissimilarity matrix)
      * @return mapped data
@@ -342,30 +622,66 @@ namespace machinelearning { namespace dimensionreduce { namespace nonsupervised
     }
     
     
-    /** calculate the distance between every row of the matrix and the other rows
+    /** calculate the distance between every row of the matrix and the other rows. The distances are calculated
+     * on tiles of the upper triangle and mirrored into the lower triangle, on square matrices the inner products
+     * are created with one matrix product
      * @param p_matrix input matrix
      * @return distance matrix
      **/
     template<typename T> inline ublas::matrix<T> mds<T>::sammon_distance( const ublas::matrix<T>& p_matrix ) const
     {
-        ublas::matrix<T> l_sse( p_matrix.size1(), p_matrix.size1(), 0 );
-        if ( p_matrix.size1() == p_matrix.size2() ) {
-            l_sse = tools::matrix::pow(p_matrix, static_cast<T>(2));
-            const ublas::matrix<T> l_mat = ublas::outer_prod(tools::matrix::sum(l_sse), ublas::scalar_vector<T>(p_matrix.size1(),1));
-            l_sse = l_mat + ublas::trans(l_mat) - 2*ublas::prod(p_matrix, ublas::trans(p_matrix));
-            l_sse = tools::matrix::pow(l_sse, static_cast<T>(0.5));                       
-        } else 
-            #pragma omp parallel for shared(l_sse)
-            for(std::size_t i=0; i < l_sse.size1(); ++i)
-                for(std::size_t j=0; j < l_sse.size2(); ++j)
-                    l_sse(i,j) = std::pow(ublas::sum( tools::vector::pow( static_cast< ublas::vector<T> >(ublas::row(p_matrix, j)-ublas::row(p_matrix, i)), static_cast<T>(2)) ), static_cast<T>(0.5));
+        ublas::matrix<T> l_sse( p_matrix.size1(), p_matrix.size1() );
+        
+        const bool l_square = p_matrix.size1() == p_matrix.size2();
+        ublas::matrix<T> l_gram;
+        if (l_square)
+            l_gram = ublas::prod(p_matrix, ublas::trans(p_matrix));
+        
+        // the linear tile index is mapped to the upper tile position (row block <= column block)
+        const std::size_t l_blocks = (p_matrix.size1() + m_blocksize - 1) / m_blocksize;
+        const std::size_t l_tiles  = l_blocks * (l_blocks + 1) / 2;
+        
+        #pragma omp parallel for shared(l_sse, l_gram) schedule(dynamic)
+        for(std::size_t t=0; t < l_tiles; ++t) {
+            std::size_t l_rowblock = 0;
+            std::size_t l_rest     = t;
+            while (l_rest >= l_blocks - l_rowblock) {
+                l_rest -= l_blocks - l_rowblock;
+                l_rowblock++;
+            }
+            
+            const std::size_t l_rowend = std::min( (l_rowblock+1) * m_blocksize, p_matrix.size1() );
+            const std::size_t l_colend = std::min( (l_rowblock+l_rest+1) * m_blocksize, p_matrix.size1() );
+            
+            for(std::size_t i=l_rowblock * m_blocksize; i < l_rowend; ++i) {
+                if (l_rest == 0)
+                    l_sse(i,i) = static_cast<T>(0);
+                
+                const T* l_first = &p_matrix(i,0);
+                for(std::size_t j=std::max(i+1, (l_rowblock+l_rest) * m_blocksize); j < l_colend; ++j) {
+                    T l_value = static_cast<T>(0);
+                    
+                    if (l_square)
+                        l_value = std::max( static_cast<T>(0), l_gram(i,i) + l_gram(j,j) - static_cast<T>(2) * l_gram(i,j) );
+                    else {
+                        const T* l_second = &p_matrix(j,0);
+                        for(std::size_t k=0; k < p_matrix.size2(); ++k)
+                            l_value += (l_first[k] - l_second[k]) * (l_first[k] - l_second[k]);
+                    }
+                    
+                    l_sse(i,j) = std::sqrt(l_value);
+                    l_sse(j,i) = l_sse(i,j);
+                }
+            }
+        }
         
         return l_sse;
     }
     
-
-    /** caluate the High-Throughput Dimensional Scaling (HIT-MDS)
-     * @todo optimize matrix with temporary assignment
+    
+    /** caluate the High-Throughput Dimensional Scaling (HIT-MDS). The iteration is calculated with a fused kernel, so
+     * the pairwise target distances, the moment sums and the update vectors are created in two streaming passes over the
+     * data matrix without any n x n temporary matrix (numerical zero entries of the data matrix are skipped)
      * @note the actual position of data points is dependent on the template type of the class, because the accuracy of the type of influence on the optimization
      * @see http://dig.ipk-gatersleben.de/hitmds/hitmds.html
      * @param p_data input datamatrix (dissimilarity matrix)
@@ -374,96 +690,85 @@ namespace machinelearning { namespace dimensionreduce { namespace nonsupervised
     template<typename T> inline ublas::matrix<T> mds<T>::project_hit( const ublas::matrix<T>& p_data ) const
     {
         ublas::matrix<T> l_target = tools::matrix::random( p_data.size1(), m_dim, tools::random::uniform, static_cast<T>(-1), static_cast<T>(1) );
-  
-        // count zero elements
-        std::vector< std::pair<std::size_t, std::size_t> > l_zeros;
-        #pragma omp parallel for shared(l_zeros)
+        
+        // count non-zero elements and sum of the data
+        std::size_t l_count = 0;
+        T l_sum             = static_cast<T>(0);
+        #pragma omp parallel for reduction(+:l_count,l_sum)
         for(std::size_t i=0; i < p_data.size1(); ++i)
             for(std::size_t j=0; j < p_data.size2(); ++j)
-                if (tools::function::isNumericalZero(p_data(i,j)))
-                    #pragma omp critical
-                    l_zeros.push_back( std::pair<std::size_t, std::size_t>(i,j) );
+                if (!tools::function::isNumericalZero(p_data(i,j))) {
+                    l_count++;
+                    l_sum += p_data(i,j);
+                }
         
-        // create init matrix and values
-        if (l_zeros.size() == p_data.size1() * p_data.size2())
+        // create init values (the centered data value is calculated on-the-fly)
+        if (l_count == 0)
             throw exception::runtime(_("data matrix has only zero entries"), *this);
         
-        ublas::matrix<T> l_data = p_data;
-        const T l_datainv       = static_cast<T>(1) / (l_data.size1() * l_data.size2() - l_zeros.size());
-        const T l_mnD           = l_datainv * ublas::sum( tools::matrix::sum(l_data) );
+        const T l_datainv       = static_cast<T>(1) / l_count;
+        const T l_mnD           = l_datainv * l_sum;
+        
+        T l_sumD                = static_cast<T>(0);
+        #pragma omp parallel for reduction(+:l_sumD)
+        for(std::size_t i=0; i < p_data.size1(); ++i)
+            for(std::size_t j=0; j < p_data.size2(); ++j)
+                if (!tools::function::isNumericalZero(p_data(i,j)))
+                    l_sumD += (i == j) ? p_data(i,j) : p_data(i,j) - l_mnD;
         
-        #pragma omp parallel for shared(l_data)
-        for(std::size_t i=0; i < l_data.size1(); ++i)
-            for(std::size_t j=0; j < l_data.size2(); ++j)
-                if (i != j)
-                    l_data(i,j) -= l_mnD;
-        hit_setZeros(l_zeros, l_data);
-
         
         // optimize
+        ublas::matrix<T> l_update(l_target.size1(), l_target.size2());
+        const std::size_t l_blocks = (p_data.size2() + m_blocksize - 1) / m_blocksize;
+        
         for(std::size_t i=0; i < m_iteration; ++i) {
             
-            // create pairs of differences between optimized points and data
-            ublas::matrix<T> l_tmp(l_data.size1(), l_data.size2(), static_cast<T>(0));
-            for(std::size_t j=0; j < m_dim; ++j) {
-                // create a matrix with columns of the j-th column
-                ublas::matrix<T> l_col = tools::matrix::repeat( static_cast< ublas::vector<T> >(ublas::column(l_target, j)), tools::matrix::column );
-                
-                l_col -= ublas::trans(l_col);
-                l_tmp += ublas::element_prod(l_col, l_col);
-            }
-            
-            // optimize cost function
-            hit_setZeros(l_zeros, l_tmp);
-            for(std::size_t j=0; j < l_tmp.size1(); ++j)
-                for(std::size_t n=0; n < l_tmp.size2(); ++n)
-                    l_tmp(j,n) = std::sqrt( l_tmp(j,n) );
-            
-            const T l_mnT = l_datainv * ublas::sum( tools::matrix::sum(l_tmp) );
+            // first pass: moments of the target distances, the centered distance sums are
+            // expanded, so the target mean is not needed during the pass
+            T l_sumT  = static_cast<T>(0);
+            T l_sumT2 = static_cast<T>(0);
+            T l_sumTD = static_cast<T>(0);
             
-            #pragma omp parallel for shared(l_tmp)
-            for(std::size_t j=0; j < l_tmp.size1(); ++j)
-                for(std::size_t n=0; n < l_tmp.size2(); ++n)
-                    l_tmp(j,n) -= l_mnT;
-            hit_setZeros(l_zeros, l_tmp);
+            #pragma omp parallel for reduction(+:l_sumT,l_sumT2,l_sumTD)
+            for(std::size_t j=0; j < p_data.size1(); ++j)
+                for(std::size_t n=0; n < p_data.size2(); ++n) {
+                    if (tools::function::isNumericalZero(p_data(j,n)))
+                        continue;
+                    
+                    const T l_dist = target_distance(l_target, j, n);
+                    l_sumT  += l_dist;
+                    l_sumT2 += l_dist * l_dist;
+                    l_sumTD += l_dist * ((j == n) ? p_data(j,n) : p_data(j,n) - l_mnD);
+                }
             
-            // create adaption values
-            const ublas::matrix<T> l_el1 = ublas::element_prod(l_tmp, l_data);
-            const ublas::matrix<T> l_el2 = ublas::element_prod(l_tmp, l_tmp);
+            const T l_mnT = l_datainv * l_sumT;
+            T l_miT       = l_sumTD - l_mnT * l_sumD;
+            T l_moT       = l_sumT2 - static_cast<T>(2) * l_mnT * l_sumT + l_count * l_mnT * l_mnT;
             
-            T l_miT = ublas::sum( tools::matrix::sum( l_el1 ) ); 
-            T l_moT = ublas::sum( tools::matrix::sum( l_el2 ) );
- 
             const T l_F  = static_cast<T>(2) / (std::fabs(l_miT) + std::fabs(l_moT));
             l_miT       *= l_F;
             l_moT       *= l_F;
             
             
-            // calculate update strength parts
-            ublas::matrix<T> l_strength = l_tmp * l_miT - l_data * l_moT;
+            // second pass: update vectors of the points, each thread owns a block of columns,
+            // so the rows of the data matrix are read in contiguous segments
+            l_update.clear();
             
-            #pragma omp parallel for shared(l_tmp)
-            for(std::size_t j=0; j < l_tmp.size1(); ++j)
-                for(std::size_t n=0; n < l_tmp.size2(); ++n)
-                    l_tmp(j,n) += static_cast<T>(0.1) + l_mnT;
-            
-            l_strength = ublas::element_div(l_strength, l_tmp);
-          
-
-            // calculate update strength of the points
-            ublas::matrix<T> l_adapt = tools::matrix::repeat( static_cast< ublas::vector<T> >(ublas::column(l_target, m_dim-1)), tools::matrix::column );
-            l_adapt = ublas::element_prod( l_adapt-ublas::trans(l_adapt), l_strength);
-          
-            // create update matrix
-            ublas::matrix<T> l_update(l_target.size1(), l_target.size2(), static_cast<T>(0));
-            ublas::column(l_update, m_dim-1) = tools::matrix::sum(l_adapt, tools::matrix::column);
-
-            for(std::size_t j=0; j < m_dim-1; ++j) {
-                // create a matrix with columns of the j-th column
-                ublas::matrix<T> l_col = tools::matrix::repeat( static_cast< ublas::vector<T> >(ublas::column(l_target, j)), tools::matrix::column );
+            #pragma omp parallel for shared(l_update) schedule(dynamic)
+            for(std::size_t b=0; b < l_blocks; ++b) {
+                const std::size_t l_end = std::min( (b+1) * m_blocksize, p_data.size2() );
                 
-                l_col  = ublas::element_prod(l_col-ublas::trans(l_col), l_strength);
-                ublas::column(l_update, j) = tools::matrix::sum(l_col, tools::matrix::column);
+                for(std::size_t j=0; j < p_data.size1(); ++j)
+                    for(std::size_t n=b * m_blocksize; n < l_end; ++n) {
+                        if (tools::function::isNumericalZero(p_data(j,n)))
+                            continue;
+                        
+                        const T l_dist     = target_distance(l_target, j, n);
+                        const T l_strength = ((l_dist - l_mnT) * l_miT - ((j == n) ? p_data(j,n) : p_data(j,n) - l_mnD) * l_moT) / (l_dist + static_cast<T>(0.1));
+                        
+                        for(std::size_t k=0; k < m_dim; ++k)
+                            l_update(n,k) += (l_target(j,k) - l_target(n,k)) * l_strength;
+                    }
             }
             
             // create new target points
@@ -479,6 +784,199 @@ namespace machinelearning { namespace dimensionreduce { namespace nonsupervised
     }
     
     
+    /** calculates the euclidian distance between two target points
+     * @param p_target target matrix
+     * @param p_first row index of the first point
+     * @param p_second row index of the second point
+     * @return distance
+     **/
+    template<typename T> inline T mds<T>::target_distance( const ublas::matrix<T>& p_target, const std::size_t& p_first, const std::size_t& p_second ) const
+    {
+        T l_dist = static_cast<T>(0);
+        for(std::size_t k=0; k < p_target.size2(); ++k) {
+            const T l_diff = p_target(p_first,k) - p_target(p_second,k);
+            l_dist += l_diff * l_diff;
+        }
+        
+        return std::sqrt(l_dist);
+    }
+    
+    
+    /** calculate the scaling by majorizing a complicated function (SMACOF) of the (weighted) raw stress. Each iteration
+     * runs the Guttman transform, which decreases the stress monotonically. The transform matrix is not created, so
+     * the update is calculated with a blocked pass over the data rows. The weighted transform solves the linear system of the
+     * weight laplacian with conjugate gradients, that are started with the actual target points. The optimization stops if the
+     * relative decrease of the stress is less than the tolerance
+     * @see http://en.wikipedia.org/wiki/Stress_majorization
+     * @param p_data input datamatrix (dissimilarity matrix)
+     * @return mapped data
+     **/
+    template<typename T> inline ublas::matrix<T> mds<T>::project_smacof( const ublas::matrix<T>& p_data ) const
+    {
+        if (m_iteration == 0)
+            throw exception::runtime(_("iterations must be greater than zero"), *this);
+        if ( (m_weights.size1() != 0) && (m_weights.size1() != p_data.size1()) )
+            throw exception::runtime(_("weight matrix and data matrix must have the same size"), *this);
+        
+        // centered initialization, all buffers are reused within the iterations
+        ublas::matrix<T> l_target = tools::matrix::random( p_data.size1(), m_dim, tools::random::uniform, static_cast<T>(-1), static_cast<T>(1) );
+        const ublas::vector<T> l_mean = tools::matrix::mean(l_target, tools::matrix::column);
+        for(std::size_t i=0; i < l_target.size1(); ++i)
+            ublas::row(l_target, i) -= l_mean;
+        
+        ublas::matrix<T> l_transform( l_target.size1(), l_target.size2() );
+        ublas::matrix<T> l_residual, l_direction, l_product;
+        if (m_weights.size1() != 0) {
+            l_residual  = ublas::matrix<T>( l_target.size1(), l_target.size2() );
+            l_direction = ublas::matrix<T>( l_target.size1(), l_target.size2() );
+            l_product   = ublas::matrix<T>( l_target.size1(), l_target.size2() );
+        }
+        
+        
+        // optimize
+        T l_stress = std::numeric_limits<T>::max();
+        for(std::size_t i=0; i < m_iteration; ++i) {
+            
+            // calculates the stress of the actual points and the right side of the Guttman transform
+            const T l_stressnew = smacof_transform( p_data, l_target, l_transform );
+            if ( (i > 0) && ((l_stress - l_stressnew) <= m_tolerance * l_stress) )
+                break;
+            l_stress = l_stressnew;
+            
+            // unweighted the Guttman transform is the scaled product, otherwise
+            // the new points are the solution of the weighted laplacian system
+            if (m_weights.size1() == 0) {
+                l_transform /= static_cast<T>(p_data.size1());
+                l_target.swap(l_transform);
+            } else
+                smacof_solve( l_transform, l_target, l_residual, l_direction, l_product );
+        }
+        
+        return l_target;
+    }
+    
+    
+    /** calculates the product of the Guttman matrix B(X) with the target points X and the raw stress of the target points.
+     * The matrix B(X) is not stored, the rows are calculated blockwise
+     * @param p_data dissimilarity matrix
+     * @param p_target target points
+     * @param p_transform matrix for the product (must have the size of the target points)
+     * @return raw stress of the target points
+     **/
+    template<typename T> inline T mds<T>::smacof_transform( const ublas::matrix<T>& p_data, const ublas::matrix<T>& p_target, ublas::matrix<T>& p_transform ) const
+    {
+        const bool l_weighted      = m_weights.size1() != 0;
+        const std::size_t l_blocks = (p_data.size1() + m_blocksize - 1) / m_blocksize;
+        T l_stress                 = static_cast<T>(0);
+        
+        #pragma omp parallel for shared(p_transform) reduction(+:l_stress) schedule(dynamic)
+        for(std::size_t b=0; b < l_blocks; ++b) {
+            const std::size_t l_end = std::min( (b+1) * m_blocksize, p_data.size1() );
+            
+            for(std::size_t i=b * m_blocksize; i < l_end; ++i) {
+                ublas::row(p_transform, i) = ublas::zero_vector<T>(p_transform.size2());
+                
+                for(std::size_t j=0; j < p_data.size2(); ++j) {
+                    if (i == j)
+                        continue;
+                    
+                    const T l_weight = l_weighted ? m_weights(i,j) : static_cast<T>(1);
+                    const T l_dist   = target_distance(p_target, i, j);
+                    const T l_diff   = p_data(i,j) - l_dist;
+                    l_stress        += l_weight * l_diff * l_diff;
+                    
+                    if (tools::function::isNumericalZero(l_dist))
+                        continue;
+                    
+                    const T l_value = l_weight * p_data(i,j) / l_dist;
+                    for(std::size_t k=0; k < p_target.size2(); ++k)
+                        p_transform(i,k) += l_value * (p_target(i,k) - p_target(j,k));
+                }
+            }
+        }
+        
+        return static_cast<T>(0.5) * l_stress;
+    }
+    
+    
+    /** calculates the product of the weight laplacian V with a matrix (V is not stored)
+     * @param p_matrix input matrix
+     * @param p_result result matrix (must have the size of the input matrix)
+     **/
+    template<typename T> inline void mds<T>::smacof_weightprod( const ublas::matrix<T>& p_matrix, ublas::matrix<T>& p_result ) const
+    {
+        const std::size_t l_blocks = (p_matrix.size1() + m_blocksize - 1) / m_blocksize;
+        
+        #pragma omp parallel for shared(p_result) schedule(dynamic)
+        for(std::size_t b=0; b < l_blocks; ++b) {
+            const std::size_t l_end = std::min( (b+1) * m_blocksize, p_matrix.size1() );
+            
+            for(std::size_t i=b * m_blocksize; i < l_end; ++i) {
+                ublas::row(p_result, i) = ublas::zero_vector<T>(p_result.size2());
+                
+                for(std::size_t j=0; j < p_matrix.size1(); ++j)
+                    if (i != j)
+                        for(std::size_t k=0; k < p_matrix.size2(); ++k)
+                            p_result(i,k) += m_weights(i,j) * (p_matrix(i,k) - p_matrix(j,k));
+            }
+        }
+    }
+    
+    
+    /** calculates the inner product of two matrices (sum of the element products)
+     * @param p_first first matrix
+     * @param p_second second matrix
+     * @return inner product
+     **/
+    template<typename T> inline T mds<T>::smacof_inner( const ublas::matrix<T>& p_first, const ublas::matrix<T>& p_second ) const
+    {
+        T l_sum = static_cast<T>(0);
+        
+        #pragma omp parallel for reduction(+:l_sum)
+        for(std::size_t i=0; i < p_first.size1(); ++i)
+            for(std::size_t j=0; j < p_first.size2(); ++j)
+                l_sum += p_first(i,j) * p_second(i,j);
+        
+        return l_sum;
+    }
+    
+    
+    /** solves the weighted Guttman transform V X = B(X) X with conjugate gradients. The iteration
+     * stops if the residual relative to the right side is below the tolerance (at least the machine
+     * precision), so a warm start needs only a few iterations
+     * @param p_right right side of the system
+     * @param p_target target points, is used as start value and contains the solution
+     * @param p_residual buffer for the residual
+     * @param p_direction buffer for the search direction
+     * @param p_product buffer for the laplacian product
+     **/
+    template<typename T> inline void mds<T>::smacof_solve( const ublas::matrix<T>& p_right, ublas::matrix<T>& p_target, ublas::matrix<T>& p_residual, ublas::matrix<T>& p_direction, ublas::matrix<T>& p_product ) const
+    {
+        smacof_weightprod( p_target, p_product );
+        p_residual  = p_right - p_product;
+        p_direction = p_residual;
+        
+        T l_residual      = smacof_inner(p_residual, p_residual);
+        const T l_epsilon = std::max( m_tolerance * m_tolerance, std::numeric_limits<T>::epsilon() ) * smacof_inner(p_right, p_right);
+        
+        for(std::size_t i=0; (i < p_target.size1()) && (l_residual > l_epsilon); ++i) {
+            smacof_weightprod( p_direction, p_product );
+            
+            const T l_curvature = smacof_inner(p_direction, p_product);
+            if (tools::function::isNumericalZero(l_curvature))
+                break;
+            
+            const T l_alpha = l_residual / l_curvature;
+            p_target       += l_alpha * p_direction;
+            p_residual     -= l_alpha * p_product;
+            
+            const T l_residualnew = smacof_inner(p_residual, p_residual);
+            p_direction           = p_residual + (l_residualnew / l_residual) * p_direction;
+            l_residual            = l_residualnew;
+        }
+    }
+    
+    
     /** sets all elements which are in the vector to zero values
      * @param p_zeros pair vector with indices
      * @param p_matrix referenz of a matrix
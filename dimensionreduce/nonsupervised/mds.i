@@ -28,7 +28,7 @@
 %module "mdsmodule"
 %include "../../swig/java/java.i"
 
-%typemap(javainterfaces) machinelearning::dimensionreduce::nonsupervised::mds<double> "Reduce";
+%typemap(javainterfaces) machinelearning::dimensionreduce::nonsupervised::mds<double> "Reduce, ReduceFit";
 #endif
 
 
@@ -40,7 +40,7 @@ namespace machinelearning { namespace dimensionreduce { namespace nonsupervised
     
     
     /** create the principal component analysis (PCA) **/
-    template<typename T> class pca : public reduce<T>
+    template<typename T> class pca : public reduce<T>, public reducefit<T>
     {
         #ifndef SWIG
         BOOST_STATIC_ASSERT( !boost::is_integral<T>::value );
@@ -51,6 +51,8 @@ namespace machinelearning { namespace dimensionreduce { namespace nonsupervised
             
             pca( const std::size_t& );
             ublas::matrix<T> map( const ublas::matrix<T>& );
+            void fit( const ublas::matrix<T>& );
+            ublas::matrix<T> transform( const ublas::matrix<T>& ) const;
             std::size_t getDimension( void ) const;
             ublas::matrix<T> getProject( void ) const;
         
@@ -61,6 +63,8 @@ namespace machinelearning { namespace dimensionreduce { namespace nonsupervised
             const std::size_t m_dim;
             /** matrix with project vectors **/
             ublas::matrix<T> m_project;
+            /** column mean of the fitted data **/
+            ublas::vector<T> m_center;
         
     };
     
@@ -71,7 +75,8 @@ namespace machinelearning { namespace dimensionreduce { namespace nonsupervised
     **/
     template<typename T> inline pca<T>::pca( const std::size_t& p_dim ) :
         m_dim( p_dim ),
-        m_project()
+        m_project(),
+        m_center()
     {
         if (p_dim == 0)
             throw exception::runtime(_("dimension must be greater than zero"), *this);
@@ -100,6 +105,16 @@ namespace machinelearning { namespace dimensionreduce { namespace nonsupervised
      * @param p_data input datamatrix
     **/
     template<typename T> inline ublas::matrix<T> pca<T>::map( const ublas::matrix<T>& p_data )
+    {
+        fit( p_data );
+        return transform( p_data );
+    }
+    
+    
+    /** calculates the projection of the input data
+     * @param p_data input datamatrix
+     **/
+    template<typename T> inline void pca<T>::fit( const ublas::matrix<T>& p_data )
     {
         if (p_data.size1() == 0)
             throw exception::runtime(_("row size must be greater than zero"), *this);
@@ -109,7 +124,8 @@ namespace machinelearning { namespace dimensionreduce { namespace nonsupervised
             throw exception::runtime(_("datapoint dimension are less than target dimension"), *this);
         
         // centering the data
-        ublas::matrix<T> l_center = tools::matrix::centering<T>(p_data);
+        const ublas::vector<T> l_mean = tools::matrix::mean<T>(p_data, tools::matrix::column);
+        ublas::matrix<T> l_center = p_data - tools::matrix::repeat<T>(l_mean, p_data.size1(), tools::matrix::row);
         
         // creates if needed the covarianz matrix or create matrix product
         ublas::matrix<T> l_data;
@@ -131,7 +147,22 @@ namespace machinelearning { namespace dimensionreduce { namespace nonsupervised
         for(std::size_t i=0; i < m_dim; ++i)
             ublas::column(m_project, i) = ublas::column(l_eigenvectors, l_rank(l_rank.size()-i-1));
         
-        return ublas::prod(l_center, m_project);
+        m_center = l_mean;
+    }
+    
+    
+    /** projects data with the fitted model (data is centered with the mean of the fitted data)
+     * @param p_data input datamatrix
+     * @return matrix with mapped points
+     **/
+    template<typename T> inline ublas::matrix<T> pca<T>::transform( const ublas::matrix<T>& p_data ) const
+    {
+        if (m_project.size1() == 0)
+            throw exception::runtime(_("projection is not fitted"), *this);
+        if (p_data.size2() != m_project.size1())
+            throw exception::runtime(_("column size must be equal to the fitted data"), *this);
+        
+        return tools::matrix::blockprod<T>(p_data, m_project, m_center);
     }
     
 }}}
@@ -28,7 +28,7 @@
 %module "pcamodule"
 %include "../../swig/java/java.i"
 
-%typemap(javainterfaces) machinelearning::dimensionreduce::nonsupervised::pca<double> "Reduce";
+%typemap(javainterfaces) machinelearning::dimensionreduce::nonsupervised::pca<double> "Reduce, ReduceFit";
 #endif
 
 
@@ -69,6 +69,32 @@ namespace machinelearning { namespace dimensionreduce {
         };
         
         
+        /** abstract class for nonsupervised dimension reducing classes, which are fitted once
+         * and project new data with the fitted model (the projection must be thread-safe)
+         **/
+        template<typename T> class reducefit
+        {
+            #ifndef SWIG
+            BOOST_STATIC_ASSERT( !boost::is_integral<T>::value );
+            #endif
+            
+            
+            public :
+            
+                #ifndef SWIG
+                /** destructor, so fitted models can be deleted by the base pointer **/
+                virtual ~reducefit( void ) {}
+                #endif
+            
+                /** fits the model to the data (throws if the model has no out-of-sample projection) **/
+                virtual void fit( const ublas::matrix<T>& ) = 0;
+            
+                /** projects data with the fitted model **/
+                virtual ublas::matrix<T> transform( const ublas::matrix<T>& ) const = 0;
+            
+        };
+        
+        
         #ifdef MACHINELEARNING_MPI
         
         /** abstract class for nonsupervised dimension reducing classes with MPI support **/      
@@ -38,12 +38,23 @@
 
 %typemap(javaout)               ublas::matrix<double> machinelearning::dimensionreduce::nonsupervised::reduce<double>::map  ";"
 %typemap(javaout)               std::size_t machinelearning::dimensionreduce::nonsupervised::reduce<double>::getDimension   ";"
+
+%typemap(javaclassmodifiers)    machinelearning::dimensionreduce::nonsupervised::reducefit<double>                          "public interface"
+%typemap(javabody)              machinelearning::dimensionreduce::nonsupervised::reducefit<double>                          ""
+%typemap(javafinalize)          machinelearning::dimensionreduce::nonsupervised::reducefit<double>                          ""
+%typemap(javadestruct)          machinelearning::dimensionreduce::nonsupervised::reducefit<double>                          ""
+
+%typemap(javaout)               void machinelearning::dimensionreduce::nonsupervised::reducefit<double>::fit                ";"
+%typemap(javaout)               ublas::matrix<double> machinelearning::dimensionreduce::nonsupervised::reducefit<double>::transform ";"
 #endif
 
 
 %nodefaultctor                  machinelearning::dimensionreduce::nonsupervised::reduce<double>;
 %nodefaultdtor                  machinelearning::dimensionreduce::nonsupervised::reduce<double>;
+%nodefaultctor                  machinelearning::dimensionreduce::nonsupervised::reducefit<double>;
+%nodefaultdtor                  machinelearning::dimensionreduce::nonsupervised::reducefit<double>;
 
 
 %include "reduce.hpp"
 %template(Reduce) machinelearning::dimensionreduce::nonsupervised::reduce<double>;
+%template(ReduceFit) machinelearning::dimensionreduce::nonsupervised::reducefit<double>;
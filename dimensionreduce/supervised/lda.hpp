@@ -28,6 +28,7 @@
 #include <omp.h>
 
 #include <map>
+#include <vector>
 #include <boost/numeric/ublas/matrix.hpp>
 #include <boost/numeric/ublas/vector.hpp>
 
@@ -43,16 +44,25 @@ namespace machinelearning { namespace dimensionreduce { namespace supervised {
     #endif
     
     
-    /** class for projection the (Fisher) lineare discriminant analysis (LDA) **/
-    template<typename T, typename L> class lda : public reduce<T,L>
+    /** class for projection the (Fisher) lineare discriminant analysis (LDA).
+     * The scatter matrices are accumulated in one pass over the rows, so the
+     * data can be passed in row batches with update() and the projection is
+     * calculated with solve()
+     **/
+    template<typename T, typename L> class lda : public reduce<T,L>, public reducefit<T,L>
     {
         
         public :
         
             lda( const std::size_t& );
             ublas::matrix<T> map( const ublas::matrix<T>&, const std::vector<L>& );
+            void fit( const ublas::matrix<T>&, const std::vector<L>& );
+            ublas::matrix<T> transform( const ublas::matrix<T>& ) const;
             std::size_t getDimension( void ) const;
             ublas::matrix<T> getProject( void ) const;
+            void update( const ublas::matrix<T>&, const std::vector<L>& );
+            void solve( void );
+            void clear( void );
         
         
         private :
@@ -61,6 +71,16 @@ namespace machinelearning { namespace dimensionreduce { namespace supervised {
             const std::size_t m_dim;
             /** project vectors **/
             ublas::matrix<T> m_project;
+            /** map with label and class index **/
+            std::map<L, std::size_t> m_classindex;
+            /** number of rows of each class **/
+            std::vector<std::size_t> m_count;
+            /** sum of the rows of each class **/
+            std::vector< ublas::vector<T> > m_sum;
+            /** scatter (sum of outer products) of each class as packed upper triangle **/
+            std::vector< ublas::vector<T> > m_scatter;
+            /** shift vector (first row) for numerical stable accumulation **/
+            ublas::vector<T> m_shift;
     };
     
     
@@ -69,7 +89,12 @@ namespace machinelearning { namespace dimensionreduce { namespace supervised {
     **/
     template<typename T, typename L> inline lda<T,L>::lda( const std::size_t& p_dim) :
         m_dim(p_dim),
-        m_project()
+        m_project(),
+        m_classindex(),
+        m_count(),
+        m_sum(),
+        m_scatter(),
+        m_shift()
     {
         if (p_dim == 0)
             throw exception::runtime(_("dimension must be greater than zero"), *this);
@@ -94,53 +119,143 @@ namespace machinelearning { namespace dimensionreduce { namespace supervised {
     }
     
     
-    /** caluate and project the input data
-     * @param p_data input datamatrix
-     * @param p_label labeling for matrix rows
-     * @return matrix with mapped points
-     * @todo change matrix copy with ublas ranges
+    /** removes all accumulated class statistics **/
+    template<typename T, typename L> inline void lda<T,L>::clear( void )
+    {
+        m_classindex.clear();
+        m_count.clear();
+        m_sum.clear();
+        m_scatter.clear();
+        m_shift.resize(0, false);
+    }
+    
+    
+    /** accumulates the class statistics of a row batch. Each thread
+     * accumulates into own buffers, which are reduced at the end
+     * @param p_data row batch
+     * @param p_label labeling for the batch rows
      **/
-    template<typename T, typename L> inline ublas::matrix<T> lda<T, L>::map( const ublas::matrix<T>& p_data, const std::vector<L>& p_label )
+    template<typename T, typename L> inline void lda<T, L>::update( const ublas::matrix<T>& p_data, const std::vector<L>& p_label )
     {
         if (p_data.size1() != p_label.size())
             throw exception::runtime(_("matrix rows and label size are not equal"), *this);
+        if (p_data.size1() == 0)
+            return;
         
-        // create a unique label vector
-        std::vector<L> l_uniquelabel = tools::vector::unique<L>(p_label);
+        if (m_shift.size() == 0)
+            m_shift = ublas::row(p_data, 0);
+        else
+            if (m_shift.size() != p_data.size2())
+                throw exception::runtime(_("column size is not equal to the previous data"), *this);
         
-        // we can only reduce to length(classes)-1
-        if (m_dim >= l_uniquelabel.size())
-            throw exception::runtime(_("target dimension must be less than unique data classes"), *this);
-        // centering the data
-        ublas::matrix<T> l_center = tools::matrix::centering<T>(p_data);        
+        const std::size_t l_dim    = p_data.size2();
+        const std::size_t l_packed = l_dim * (l_dim+1) / 2;
         
-        // we create a map for indexing the rows of the matrix with their labels
-        std::multimap<L, std::size_t> l_index;
-        for(std::size_t i=0; i < p_label.size(); ++i)
-            l_index.insert( std::make_pair(p_label[i], i) );
-
-        // calculate covarianz for every class and all data
-        ublas::matrix<T> l_sb = tools::matrix::cov(l_center);
-        ublas::matrix<T> l_sw(l_sb.size1(), l_sb.size2());
-        const T l_classes = static_cast<T>(l_uniquelabel.size()-1);
-    
-        #pragma omp parallel for shared(l_uniquelabel, l_sw)
-        for(std::size_t i=0; i < l_uniquelabel.size(); ++i) {
+        // dense class index for every row (new classes are added)
+        std::vector<std::size_t> l_class( p_label.size() );
+        for(std::size_t i=0; i < p_label.size(); ++i) {
+            typename std::map<L, std::size_t>::const_iterator it = m_classindex.find(p_label[i]);
+            if (it == m_classindex.end()) {
+                it = m_classindex.insert( std::make_pair(p_label[i], m_count.size()) ).first;
+                m_count.push_back(0);
+                m_sum.push_back( ublas::zero_vector<T>(l_dim) );
+                m_scatter.push_back( ublas::zero_vector<T>(l_packed) );
+            }
+            l_class[i] = it->second;
+        }
+        
+        #pragma omp parallel
+        {
+            // thread local buffers are created only for classes, which are used by the thread
+            std::vector<std::size_t> l_count( m_count.size(), 0 );
+            std::vector< ublas::vector<T> > l_sum( m_count.size() );
+            std::vector< ublas::vector<T> > l_scatter( m_count.size() );
+            std::vector<T> l_row( l_dim );
             
-            // extract index from map | typename must be first, because is a exotic structure of C++ :-)
-            // create a matrix whitch holds the rows for every class. Create a matrix with index elements for the rows
-            std::size_t n=0;
-            ublas::matrix<T> l_cluster(  std::distance(l_index.lower_bound(l_uniquelabel[i]), l_index.upper_bound(l_uniquelabel[i])),  l_center.size2()  );
-            for( typename std::multimap<L, std::size_t>::iterator it = l_index.lower_bound(l_uniquelabel[i]); it != l_index.upper_bound(l_uniquelabel[i]); ++it )
-                // -> do this with range
-                ublas::row(l_cluster, n++) = ublas::row(l_center, it->second);
+            #pragma omp for
+            for(std::size_t n=0; n < p_data.size1(); ++n) {
+                const std::size_t l_idx = l_class[n];
+                if (l_count[l_idx] == 0) {
+                    l_sum[l_idx]     = ublas::zero_vector<T>(l_dim);
+                    l_scatter[l_idx] = ublas::zero_vector<T>(l_packed);
+                }
+                
+                const T* l_data = &p_data.data()[n * l_dim];
+                T* l_sumdata    = &l_sum[l_idx].data()[0];
+                for(std::size_t i=0; i < l_dim; ++i) {
+                    l_row[i]      = l_data[i] - m_shift(i);
+                    l_sumdata[i] += l_row[i];
+                }
+                l_count[l_idx]++;
+                
+                // rank-one update of the upper triangle
+                T* l_scatterdata = &l_scatter[l_idx].data()[0];
+                for(std::size_t i=0; i < l_dim; ++i) {
+                    const T l_value = l_row[i];
+                    if (!tools::function::isNumericalZero(l_value))
+                        for(std::size_t j=i; j < l_dim; ++j)
+                            l_scatterdata[j-i] += l_value * l_row[j];
+                    l_scatterdata += l_dim - i;
+                }
+            }
             
-            // calculate covarianz for the cluster
-            #pragma omp critical 
-            l_sw     += l_cluster.size1() / l_classes * tools::matrix::cov(l_cluster);
+            #pragma omp critical
+            for(std::size_t i=0; i < l_count.size(); ++i)
+                if (l_count[i] > 0) {
+                    m_count[i]   += l_count[i];
+                    m_sum[i]     += l_sum[i];
+                    m_scatter[i] += l_scatter[i];
+                }
+        }
+    }
+    
+    
+    /** calculates the projection of the accumulated class statistics **/
+    template<typename T, typename L> inline void lda<T, L>::solve( void )
+    {
+        // we can only reduce to length(classes)-1
+        if (m_count.empty())
+            throw exception::runtime(_("no data for calculating the projection"), *this);
+        if (m_dim >= m_count.size())
+            throw exception::runtime(_("target dimension must be less than unique data classes"), *this);
+        
+        const std::size_t l_dim = m_shift.size();
+        const T l_classes       = static_cast<T>(m_count.size()-1);
+        
+        // total scatter and sum of all classes
+        std::size_t l_count = 0;
+        ublas::vector<T> l_sum = ublas::zero_vector<T>(l_dim);
+        ublas::vector<T> l_scatter = ublas::zero_vector<T>(m_scatter[0].size());
+        for(std::size_t i=0; i < m_count.size(); ++i) {
+            l_count   += m_count[i];
+            l_sum     += m_sum[i];
+            l_scatter += m_scatter[i];
+        }
+        if (l_count < 2)
+            throw exception::runtime(_("number of data points must be greater than one"), *this);
+        
+        // calculate covarianz for all data and for every class (a class with one element has no covarianz)
+        ublas::matrix<T> l_sb(l_dim, l_dim);
+        ublas::matrix<T> l_sw(l_dim, l_dim);
+        
+        #pragma omp parallel for shared(l_sb, l_sw, l_sum, l_scatter)
+        for(std::size_t i=0; i < l_dim; ++i) {
+            const std::size_t l_offset = i * l_dim - i * (i-1) / 2;
             
+            for(std::size_t j=i; j < l_dim; ++j) {
+                l_sb(i, j) = (l_scatter(l_offset+j-i) - l_sum(i) * l_sum(j) / l_count) / (l_count-1);
+                l_sb(j, i) = l_sb(i, j);
+                
+                T l_within = static_cast<T>(0);
+                for(std::size_t n=0; n < m_count.size(); ++n)
+                    if (m_count[n] > 1)
+                        l_within += m_count[n] / l_classes * (m_scatter[n](l_offset+j-i) - m_sum[n](i) * m_sum[n](j) / m_count[n]) / (m_count[n]-1);
+                
+                l_sw(i, j) = l_within;
+                l_sw(j, i) = l_within;
+            }
         }
-
+        
         // calculate the eigenvalues & -vectors
         ublas::vector<T> l_eigenvalues;
         ublas::matrix<T> l_eigenvectors;
@@ -154,8 +269,47 @@ namespace machinelearning { namespace dimensionreduce { namespace supervised {
         m_project = ublas::matrix<T>( l_eigenvectors.size2(), m_dim );
         for(std::size_t i=0; i < m_dim; ++i)
             ublas::column(m_project, i) = ublas::column(l_eigenvectors, l_rank(l_rank.size()-i-1));
+    }
+    
+    
+    /** caluate and project the input data
+     * @param p_data input datamatrix
+     * @param p_label labeling for matrix rows
+     * @return matrix with mapped points
+     **/
+    template<typename T, typename L> inline ublas::matrix<T> lda<T, L>::map( const ublas::matrix<T>& p_data, const std::vector<L>& p_label )
+    {
+        fit( p_data, p_label );
+        return transform( p_data );
+    }
+    
+    
+    /** calculates the projection of the input data (accumulated
+     * statistics of previous update calls are removed)
+     * @param p_data input datamatrix
+     * @param p_label labeling for matrix rows
+     **/
+    template<typename T, typename L> inline void lda<T, L>::fit( const ublas::matrix<T>& p_data, const std::vector<L>& p_label )
+    {
+        clear();
+        update( p_data, p_label );
+        solve();
+        clear();
+    }
+    
+    
+    /** projects data with the fitted model
+     * @param p_data input datamatrix
+     * @return matrix with mapped points
+     **/
+    template<typename T, typename L> inline ublas::matrix<T> lda<T, L>::transform( const ublas::matrix<T>& p_data ) const
+    {
+        if (m_project.size1() == 0)
+            throw exception::runtime(_("projection is not fitted"), *this);
+        if (p_data.size2() != m_project.size1())
+            throw exception::runtime(_("column size must be equal to the fitted data"), *this);
         
-        return ublas::prod(p_data, m_project);
+        return tools::matrix::blockprod<T>(p_data, m_project);
     }
     
 
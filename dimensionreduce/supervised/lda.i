@@ -28,8 +28,8 @@
 %module "ldamodule"
 %include "../../swig/java/java.i"
 
-%typemap(javainterfaces) machinelearning::dimensionreduce::supervised::lda<double, std::string> "ReduceString";
-%typemap(javainterfaces) machinelearning::dimensionreduce::supervised::lda<double, std::size_t> "ReduceLong";
+%typemap(javainterfaces) machinelearning::dimensionreduce::supervised::lda<double, std::string> "ReduceString, ReduceFitString";
+%typemap(javainterfaces) machinelearning::dimensionreduce::supervised::lda<double, std::size_t> "ReduceLong, ReduceFitLong";
 #endif
 
 
@@ -39,6 +39,14 @@
 %typemap(javaout)            ublas::matrix<double> machinelearning::dimensionreduce::supervised::reduce<double, std::string>::map    ";"
 %typemap(javaout)            std::size_t machinelearning::dimensionreduce::supervised::reduce<double, std::string>::getDimension     ";"
 
+%typemap(javaclassmodifiers) machinelearning::dimensionreduce::supervised::reducefit<double, std::string>                            "public interface"
+%typemap(javabody)           machinelearning::dimensionreduce::supervised::reducefit<double, std::string>                            ""
+%typemap(javafinalize)       machinelearning::dimensionreduce::supervised::reducefit<double, std::string>                            ""
+%typemap(javadestruct)       machinelearning::dimensionreduce::supervised::reducefit<double, std::string>                            ""
+
+%typemap(javaout)            void machinelearning::dimensionreduce::supervised::reducefit<double, std::string>::fit                  ";"
+%typemap(javaout)            ublas::matrix<double> machinelearning::dimensionreduce::supervised::reducefit<double, std::string>::transform ";"
+
 
 %typemap(javaclassmodifiers) machinelearning::dimensionreduce::supervised::reduce<double, std::size_t>                               "public interface"
 %typemap(javabody)           machinelearning::dimensionreduce::supervised::reduce<double, std::size_t>                               ""
@@ -47,16 +55,30 @@
 
 %typemap(javaout)            ublas::matrix<double> machinelearning::dimensionreduce::supervised::reduce<double, std::size_t>::map    ";"
 %typemap(javaout)            std::size_t machinelearning::dimensionreduce::supervised::reduce<double, std::size_t>::getDimension     ";"
+
+%typemap(javaclassmodifiers) machinelearning::dimensionreduce::supervised::reducefit<double, std::size_t>                            "public interface"
+%typemap(javabody)           machinelearning::dimensionreduce::supervised::reducefit<double, std::size_t>                            ""
+%typemap(javafinalize)       machinelearning::dimensionreduce::supervised::reducefit<double, std::size_t>                            ""
+%typemap(javadestruct)       machinelearning::dimensionreduce::supervised::reducefit<double, std::size_t>                            ""
+
+%typemap(javaout)            void machinelearning::dimensionreduce::supervised::reducefit<double, std::size_t>::fit                  ";"
+%typemap(javaout)            ublas::matrix<double> machinelearning::dimensionreduce::supervised::reducefit<double, std::size_t>::transform ";"
 #endif
 
 
 %nodefaultctor              machinelearning::dimensionreduce::supervised::reduce<double, std::string>;
 %nodefaultdtor              machinelearning::dimensionreduce::supervised::reduce<double, std::string>;
+%nodefaultctor              machinelearning::dimensionreduce::supervised::reducefit<double, std::string>;
+%nodefaultdtor              machinelearning::dimensionreduce::supervised::reducefit<double, std::string>;
 
 %nodefaultctor              machinelearning::dimensionreduce::supervised::reduce<double, std::size_t>;
 %nodefaultdtor              machinelearning::dimensionreduce::supervised::reduce<double, std::size_t>;
+%nodefaultctor              machinelearning::dimensionreduce::supervised::reducefit<double, std::size_t>;
+%nodefaultdtor              machinelearning::dimensionreduce::supervised::reducefit<double, std::size_t>;
 
 
 %include "reduce.hpp"
 %template(ReduceString) machinelearning::dimensionreduce::supervised::reduce<double, std::string>;
-%template(ReduceLong) machinelearning::dimensionreduce::supervised::reduce<double, std::size_t>;
\ No newline at end of file
+%template(ReduceLong) machinelearning::dimensionreduce::supervised::reduce<double, std::size_t>;
+%template(ReduceFitString) machinelearning::dimensionreduce::supervised::reducefit<double, std::string>;
+%template(ReduceFitLong) machinelearning::dimensionreduce::supervised::reducefit<double, std::size_t>;
\ No newline at end of file
@@ -28,6 +28,7 @@
 #include <boost/static_assert.hpp>
 #include <boost/numeric/ublas/vector.hpp>
 #include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_sparse.hpp>
 
 #include "../tools/tools.h"
 
@@ -97,6 +98,10 @@ namespace machinelearning { namespace distances {
                 /** distances between row / column vectors of matrix and  row / column vectors of the other matrix **/
                 virtual ublas::vector<T> getDistance( const ublas::matrix<T>&, const ublas::matrix<T>&, const tools::matrix::rowtype& = tools::matrix::row ) const = 0;
             
+                #ifndef SWIG
+                virtual ublas::vector<T> getDistance( const ublas::compressed_matrix<T>&, const ublas::vector<T>& ) const;
+                #endif
+            
             
                 #ifndef SWIG
                 /** weight distance between two vectors **/
@@ -113,6 +118,21 @@ namespace machinelearning { namespace distances {
                 #endif
 
         };
+    
+    
+    
+        #ifndef SWIG
+        /** distances between row vectors of a sparse matrix and vector. The default implementation
+         * creates the dense matrix, distances with a sparse calculation should overwrite it
+         * @param p_data sparse matrix
+         * @param p_vec vector
+         * @return distance vector
+         **/
+        template<typename T> inline ublas::vector<T> distance<T>::getDistance( const ublas::compressed_matrix<T>& p_data, const ublas::vector<T>& p_vec ) const
+        {
+            return getDistance( ublas::matrix<T>(p_data), p_vec, tools::matrix::row );
+        }
+        #endif
 
 } }
 #endif
@@ -27,29 +27,43 @@
 #define __MACHINELEARNING_DISTANCES_NCD_HPP
 
 #include <omp.h>
+#include <zlib.h>
+#include <bzlib.h>
 #include <string>
-#include <sstream>
-#include <iostream>
-#include <ostream>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <iterator>
 #include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
 
 #ifdef MACHINELEARNING_MPI
+#include <map>
+#include <set>
+#include <deque>
+#include <cmath>
+#include <numeric>
 #include <boost/mpi.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
 #endif
 
 #include <boost/static_assert.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/cstdint.hpp>
 #include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_proxy.hpp>
 #include <boost/numeric/ublas/symmetric.hpp>
 
 #include <boost/iostreams/filter/gzip.hpp>
 #include <boost/iostreams/filter/bzip2.hpp>
-
-#include <boost/iostreams/stream.hpp>
-#include <boost/iostreams/device/null.hpp>
-#include <boost/iostreams/filtering_streambuf.hpp>
-#include <boost/iostreams/filter/counter.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/filesystem.hpp>
 
 #include "../errorhandling/exception.hpp"
+#include "../tools/files/hdf.hpp"
 
 
 
@@ -59,6 +73,7 @@ namespace machinelearning { namespace distances {
     #ifndef SWIG
     namespace ublas = boost::numeric::ublas;
     namespace bio   = boost::iostreams;
+    namespace fsys  = boost::filesystem;
     #ifdef MACHINELEARNING_MPI
     namespace mpi   = boost::mpi;
     #endif
@@ -81,7 +96,8 @@ namespace machinelearning { namespace distances {
             enum compresstype
             {
                 gzip, 
-                bzip2
+                bzip2,
+                lz
             };
             
             enum compresslevel
@@ -98,7 +114,19 @@ namespace machinelearning { namespace distances {
             ublas::matrix<T> unsymmetric ( const std::vector<std::string>&, const bool& = false ) const;
             ublas::symmetric_matrix<T, ublas::upper> symmetric ( const std::vector<std::string>&, const bool& = false ) const;
             T calculate ( const std::string&, const std::string&, const bool& = false ) const;
+            #ifndef SWIG
+            T calculate ( const char*, const std::size_t&, const char*, const std::size_t& ) const;
+            #endif
             void setCompressionLevel( const compresslevel& = defaultcompression );
+            void setStateSnapshot( const bool& = true );
+            void setCache( const std::string& = "", const std::size_t& = 1048576 );
+            void setTileSize( const std::size_t& = 1024 );
+            
+            #if defined(MACHINELEARNING_FILES) && defined(MACHINELEARNING_FILES_HDF) && !defined(SWIG)
+            void unsquare ( tools::files::hdf&, const std::string&, const tools::files::hdf::datatype&, const std::vector<std::string>&, const std::vector<std::string>&, const bool& = false ) const;
+            void unsymmetric ( tools::files::hdf&, const std::string&, const tools::files::hdf::datatype&, const std::vector<std::string>&, const bool& = false ) const;
+            void symmetric ( tools::files::hdf&, const std::string&, const tools::files::hdf::datatype&, const std::vector<std::string>&, const bool& = false ) const;
+            #endif
             
             #ifdef MACHINELEARNING_MPI
             ublas::matrix<T> unsquare ( const mpi::communicator&, const std::vector<std::string>&, const bool& = false ) const;
@@ -112,9 +140,149 @@ namespace machinelearning { namespace distances {
             bio::gzip_params m_gzipparam;
             /** parameter for bzip2 **/
             bio::bzip2_params m_bzip2param;
+            /** search depth of the lz compressor **/
+            std::size_t m_lzdepth;
+            /** flag for using the compressor state snapshot **/
+            bool m_snapshot;
+            /** tile size of the HDF output **/
+            std::size_t m_tilesize;
+            
+            #ifndef SWIG
+            class sizecache;
+            /** persistent cache of the compressed sizes **/
+            boost::shared_ptr<sizecache> m_cache;
+            #endif
+            
+            
+            #ifndef SWIG
+            /** persistent cache of compressed sizes. The entries are stored sorted within a file, which
+             * is memory-mapped, so the lookups are read-only and can be run concurrently. New entries
+             * are collected and merged into the file on flush
+             **/
+            class sizecache
+            {
+                public :
+                
+                    /** content key of a data (hash, crc and length) **/
+                    struct key
+                    {
+                        boost::uint64_t hash;
+                        boost::uint64_t crc;
+                        boost::uint64_t length;
+                    };
+                    
+                    /** cache entry, the key is the content key of both data and the compressor settings **/
+                    struct entry
+                    {
+                        /** key of the first data **/
+                        key first;
+                        /** key of the second data (zero for a single data) **/
+                        key second;
+                        /** key of the compressor settings **/
+                        boost::uint64_t settings;
+                        /** compressed size **/
+                        boost::uint64_t size;
+                        
+                        bool operator< ( const entry& ) const;
+                        bool operator== ( const entry& ) const;
+                    };
+                    
+                    sizecache( const std::string&, const std::size_t& );
+                    ~sizecache( void );
+                    bool find( entry& ) const;
+                    void insert( const entry& );
+                    void flush( const bool& = true );
+                    void open( void );
+                    std::vector<entry> release( void );
+                
+                private :
+                
+                    /** filename **/
+                    const std::string m_filename;
+                    /** mapped file **/
+                    bio::mapped_file_source m_file;
+                    /** first mapped entry **/
+                    const entry* m_begin;
+                    /** end of the mapped entries **/
+                    const entry* m_end;
+                    /** new entries **/
+                    std::vector<entry> m_new;
+                    /** maximum number of new entries **/
+                    const std::size_t m_limit;
+            };
+            
+            
+            /** read-only view of a string or a memory-mapped file, so the data is not copied **/
+            class dataview
+            {
+                public :
+                
+                    dataview( const bool&, const std::string& );
+                    /** returns the pointer to the data **/
+                    const char* data( void ) const { return m_data; }
+                    /** returns the data size **/
+                    std::size_t size( void ) const { return m_size; }
+                
+                private :
+                
+                    /** mapped file **/
+                    bio::mapped_file_source m_file;
+                    /** pointer to the data **/
+                    const char* m_data;
+                    /** data size **/
+                    std::size_t m_size;
+            };
+            
+            
+            /** zlib allocator, that keeps the freed memory blocks, so the copies of a compressor
+             * state reuse the memory of the previous copy (must be used by one thread only) **/
+            class statepool
+            {
+                public :
+                
+                    ~statepool( void );
+                    static voidpf allocate( voidpf, uInt, uInt );
+                    static void release( voidpf, voidpf );
+                
+                private :
+                
+                    /** freed blocks with their sizes **/
+                    std::vector< std::pair<std::size_t, void*> > m_free;
+            };
+            
+            typename sizecache::key content_key( const dataview& ) const;
+            boost::uint64_t cache_settings( void ) const;
+            bool cache_find( const typename sizecache::key&, const typename sizecache::key&, std::size_t& ) const;
+            void cache_insert( const typename sizecache::key&, const typename sizecache::key&, const std::size_t& ) const;
+            std::size_t cache_deflate( const typename sizecache::key&, const typename sizecache::key&, const dataview&, const dataview& ) const;
+            ublas::vector<std::size_t> single_deflate( const std::vector<std::string>&, const bool&, std::vector<typename sizecache::key>& ) const;
+            template<typename M> void tile_distance( const std::vector<std::string>&, const std::vector<std::string>&, const ublas::vector<std::size_t>&, const ublas::vector<std::size_t>&, const std::vector<typename sizecache::key>&, const std::vector<typename sizecache::key>&, const bool&, const bool&, const bool&, M& ) const;
+            template<typename M> void snapshot_distance( const std::vector<std::string>&, const std::vector<std::string>&, const ublas::vector<std::size_t>&, const ublas::vector<std::size_t>&, const std::vector<typename sizecache::key>&, const std::vector<typename sizecache::key>&, const bool&, const bool&, const bool&, M& ) const;
+            #endif
             
             std::size_t deflate ( const bool&, const std::string&, const std::string& = "" ) const;        
-            std::multimap<std::size_t, std::pair<std::size_t,std::size_t> > getWavefrontIndex( const std::size_t&, const std::size_t& ) const;
+            std::size_t deflate ( const char*, const std::size_t&, const char* = NULL, const std::size_t& = 0 ) const;
+            void gzip_init( z_stream&, statepool* = NULL ) const;
+            int gzip_process( z_stream&, const char*, const std::size_t&, const int& ) const;
+            std::size_t bzip2_deflate( const char*, const std::size_t&, const char*, const std::size_t& ) const;
+            std::size_t lz_deflate( const char*, const std::size_t&, const char*, const std::size_t& ) const;
+            template<typename M> void pair_distance( const std::vector<std::string>&, const std::vector<std::string>&, const bool&, const bool&, const bool&, M& ) const;
+            std::size_t snapshot_continue( const z_stream&, const char*, const std::size_t& ) const;
+            std::vector<std::string> tile_range( const std::vector<std::string>&, const std::size_t& ) const;
+            
+            #ifdef MACHINELEARNING_MPI
+            void mpi_process( const mpi::communicator&, const std::vector<std::string>&, const ublas::vector<std::size_t>&, const std::vector<typename sizecache::key>&, const std::vector<std::size_t>&, const bool&, std::vector< std::vector<std::size_t> >&, std::vector< std::vector<T> >& ) const;
+            bool mpi_serve( const mpi::communicator&, const std::vector<std::string>&, const std::vector<std::size_t>&, std::vector< std::deque< std::pair<std::size_t,std::size_t> > >&, std::vector<mpi::request>&, std::size_t&, bool& ) const;
+            const std::vector<std::string>& mpi_block( const mpi::communicator&, const std::vector<std::string>&, const std::vector<std::size_t>&, const std::size_t&, std::map<std::size_t, std::vector<std::string> >&, std::vector< std::deque< std::pair<std::size_t,std::size_t> > >&, std::vector<mpi::request>&, std::size_t&, bool& ) const;
+            bool mpi_next( std::vector< std::deque< std::pair<std::size_t,std::size_t> > >&, const std::size_t&, std::pair<std::size_t,std::size_t>& ) const;
+            void mpi_tile( const std::vector<std::size_t>&, const std::size_t&, const std::size_t&, const ublas::matrix<T>&, std::vector< std::vector<std::size_t> >&, std::vector< std::vector<T> >& ) const;
+            void mpi_cache( const mpi::communicator& ) const;
+            #endif
+            
+            #if defined(MACHINELEARNING_FILES) && defined(MACHINELEARNING_FILES_HDF) && !defined(SWIG)
+            ublas::matrix<unsigned char> tile_open( tools::files::hdf&, const std::string&, const tools::files::hdf::datatype&, const std::size_t&, const std::size_t& ) const;
+            void tile_write( tools::files::hdf&, const std::string&, const tools::files::hdf::datatype&, const ublas::matrix<T>&, const std::size_t&, const std::size_t& ) const;
+            #endif
     };
     
     
@@ -124,7 +292,11 @@ namespace machinelearning { namespace distances {
     template<typename T> inline ncd<T>::ncd( void ) :
         m_compress ( gzip ),
         m_gzipparam( bio::gzip::default_compression ),
-        m_bzip2param( 6 )
+        m_bzip2param( 6 ),
+        m_lzdepth( 8 ),
+        m_snapshot( false ),
+        m_tilesize( 1024 ),
+        m_cache()
     {}
     
     
@@ -134,30 +306,14 @@ namespace machinelearning { namespace distances {
     template<typename T> inline ncd<T>::ncd( const compresstype& p_compress ) :
         m_compress ( p_compress ),
         m_gzipparam( bio::gzip::default_compression ),
-        m_bzip2param( 6 )
+        m_bzip2param( 6 ),
+        m_lzdepth( 8 ),
+        m_snapshot( false ),
+        m_tilesize( 1024 ),
+        m_cache()
     {}
     
     
-    /** creates wavefront index pairs for using on multithreaded systems
-     * @param p_size number of rows or columns
-     * @param p_threads number of threads
-     * @return map with indices
-     **/
-    template<typename T> inline std::multimap<std::size_t, std::pair<std::size_t,std::size_t> > ncd<T>::getWavefrontIndex( const std::size_t& p_size, const std::size_t& p_threads ) const
-    {
-        std::multimap<std::size_t, std::pair<std::size_t,std::size_t> > l_wavefront;
-        
-        // create wavefront in this case: (0,n) = 0, (0,n-1) = 1, (1,n) = 2 ...
-        // we must create only the upper or lower index position, the other one can be created of swapping the index position
-        std::size_t n=0;
-        for(std::size_t i=1; i < p_size; ++i)
-            for(std::size_t j=0; (i+j) < p_size; ++j)
-                l_wavefront.insert(  std::pair<std::size_t, std::pair<std::size_t,std::size_t> >(n++ % p_threads, std::pair<std::size_t,std::size_t>(j,i+j))  );
-            
-        return l_wavefront;
-    }
-    
-      
     /** sets the compression level
      * @param  p_level compression level
      **/
@@ -168,21 +324,71 @@ namespace machinelearning { namespace distances {
             case defaultcompression :   
                 m_gzipparam     = bio::gzip_params( bio::gzip::default_compression );
                 m_bzip2param    = bio::bzip2_params( 6 );
+                m_lzdepth       = 8;
                 break;
                 
             case bestspeed          :   
                 m_gzipparam     = bio::gzip_params( bio::gzip::best_speed );
                 m_bzip2param    = bio::bzip2_params( 1 );
+                m_lzdepth       = 1;
                 break;
                 
             case bestcompression    :   
                 m_gzipparam     = bio::gzip_params( bio::gzip::best_compression );
                 m_bzip2param    = bio::bzip2_params( 9 );
+                m_lzdepth       = 64;
                 break;
         }
     }
     
     
+    /** enables / disables the compressor state snapshot. Each string of the rows is compressed
+     * only once and the compressor state is copied for each column string, so only the second
+     * string is compressed for each pair (the sizes are equal to the compression of the
+     * concatenation). The state is large (~256kB), the copies reuse the memory of the thread,
+     * but the state is copied for each pair, so it is useful for long strings
+     * @param p_snapshot enable / disable flag
+     **/
+    template<typename T> inline void ncd<T>::setStateSnapshot( const bool& p_snapshot )
+    {
+        if ( p_snapshot && (m_compress != gzip) )
+            throw exception::runtime(_("state snapshot can be used only with gzip compression"), *this);
+        
+        m_snapshot = p_snapshot;
+    }
+    
+    
+    /** sets the tile size of the HDF output
+     * @param p_size number of rows / columns of a tile
+     **/
+    template<typename T> inline void ncd<T>::setTileSize( const std::size_t& p_size )
+    {
+        if (p_size == 0)
+            throw exception::runtime(_("tile size must be greater than zero"), *this);
+        
+        m_tilesize = p_size;
+    }
+    
+    
+    /** enables / disables the persistent cache of compressed sizes. The single and pair sizes are
+     * stored by the content of the data and the compressor settings, so on a later call with mostly
+     * the same data only the new pairs are compressed. The new entries are merged into the cache file,
+     * if their number reaches the number of stored entries (so the file is rewritten only with doubled
+     * size), at the end of a tiled HDF call and on destruction. The file should not be written by
+     * different processes at the same time, it is memory-mapped, only the new entries are held in memory
+     * @param p_file filename of the cache (an empty name disables the cache)
+     * @param p_entries maximum number of new entries in memory (64 bytes each), further entries
+     * are not stored until the next update of the file
+     **/
+    template<typename T> inline void ncd<T>::setCache( const std::string& p_file, const std::size_t& p_entries )
+    {
+        if (p_file.empty())
+            m_cache.reset();
+        else
+            m_cache = boost::shared_ptr<sizecache>( new sizecache(p_file, p_entries) );
+    }
+    
+    
     
     /** calculate distances between two strings
      * @param p_str1 first string
@@ -199,6 +405,22 @@ namespace machinelearning { namespace distances {
     }
     
     
+    /** calculate distances between two data buffers (the data is not copied)
+     * @param p_data1 first data
+     * @param p_size1 size of the first data
+     * @param p_data2 second data
+     * @param p_size2 size of the second data
+     * @return distance value
+     **/   
+    template<typename T> inline T ncd<T>::calculate( const char* p_data1, const std::size_t& p_size1, const char* p_data2, const std::size_t& p_size2 ) const
+    {
+        const std::size_t l_first  = deflate(p_data1, p_size1);
+        const std::size_t l_second = deflate(p_data2, p_size2);
+        
+        return std::min( static_cast<T>(1),     static_cast<T>(deflate(p_data1, p_size1, p_data2, p_size2) - std::min(l_first, l_second)) / std::max(l_first, l_second) );
+    }
+    
+    
     
     /** calculate all distances of the string vector (first item in the vector is
      * first row and colum in the returning matrix)
@@ -211,56 +433,11 @@ namespace machinelearning { namespace distances {
         if (p_strvec.size() == 0)
             throw exception::runtime(_("vector size must be greater than zero"), *this);
         
-        // init data
-        ublas::vector<std::size_t> l_cache(p_strvec.size(), 0);
         ublas::matrix<T> l_result(p_strvec.size(), p_strvec.size(), static_cast<T>(0));
+        pair_distance( p_strvec, p_strvec, p_isfile, true, false, l_result );
         
-        // the first and last element are calculated in a single run, because
-        // the first two thread are used the data directly
-        l_cache(0)                 = deflate(p_isfile, p_strvec[0]);
-        l_cache(p_strvec.size()-1) = deflate(p_isfile, p_strvec[p_strvec.size()-1]);
-        
-        // create wavefront index position
-        std::multimap<std::size_t, std::pair<std::size_t,std::size_t> > l_wavefront = getWavefrontIndex(p_strvec.size(), omp_get_max_threads());
-        
-        #pragma omp parallel shared(l_cache, l_result)
-        {
-            for(std::multimap<std::size_t, std::pair<std::size_t,std::size_t> >::iterator it=l_wavefront.lower_bound(omp_get_thread_num()); it != l_wavefront.upper_bound(omp_get_thread_num()); ++it) {
-                
-                // read cache data
-                std::size_t l_first=0, l_second=0;
-                
-                #pragma omp critical
-                {
-                    l_first  = l_cache(it->second.first);
-                    l_second = l_cache(it->second.second);
-                }
-                
-                // check for both index positions the cache and adds the data
-                if (l_first == 0) {
-                    l_first = deflate(p_isfile, p_strvec[it->second.first]);
-                    
-                    #pragma omp critical
-                    l_cache(it->second.first) = l_first;
-                }
-                
-                if (l_second == 0) {
-                    l_second = deflate(p_isfile, p_strvec[it->second.second]);
-                    
-                    #pragma omp critical 
-                    l_cache(it->second.second) = l_second;
-                }
-                
-                
-                // determin min and max
-                const std::size_t l_min = std::min(l_first, l_second);
-                const std::size_t l_max = std::max(l_first, l_second);
-                
-                // calculate NCD
-                l_result(it->second.first, it->second.second) = std::min( static_cast<T>(1), static_cast<T>(deflate(p_isfile, p_strvec[it->second.first], p_strvec[it->second.second]) - l_min) / l_max );
-                l_result(it->second.second, it->second.first) = std::min( static_cast<T>(1), static_cast<T>(deflate(p_isfile, p_strvec[it->second.second], p_strvec[it->second.first]) - l_min) / l_max );
-            }
-        }
+        if (m_cache)
+            m_cache->flush(false);
         
         return l_result;
     }
@@ -277,66 +454,14 @@ namespace machinelearning { namespace distances {
          if (p_strvec.size() == 0)
              throw exception::runtime(_("vector size must be greater than zero"), *this);
          
-         // init data
-         ublas::vector<std::size_t> l_cache(p_strvec.size(), 0);
-         ublas::symmetric_matrix<T, ublas::upper> l_result(p_strvec.size(), p_strvec.size());
+        ublas::symmetric_matrix<T, ublas::upper> l_result(p_strvec.size(), p_strvec.size());
+        l_result.clear();
+        pair_distance( p_strvec, p_strvec, p_isfile, true, true, l_result );
         
-        // the first and last element are calculated in a single run, because
-        // the first two thread are used the data directly
-        l_cache(0)                 = deflate(p_isfile, p_strvec[0]);
-        l_cache(p_strvec.size()-1) = deflate(p_isfile, p_strvec[p_strvec.size()-1]);
-        
-        // create wavefront index position
-        std::multimap<std::size_t, std::pair<std::size_t,std::size_t> > l_wavefront = getWavefrontIndex(p_strvec.size(), omp_get_max_threads());
-        
-        #pragma omp parallel shared(l_cache, l_result)
-        {
-            for(std::multimap<std::size_t, std::pair<std::size_t,std::size_t> >::iterator it=l_wavefront.lower_bound(omp_get_thread_num()); it != l_wavefront.upper_bound(omp_get_thread_num()); ++it) {
-                
-                // read cache data
-                std::size_t l_first=0, l_second=0;
-                
-                #pragma omp critical
-                {
-                    l_first  = l_cache(it->second.first);
-                    l_second = l_cache(it->second.second);
-                }
-                
-                // check for both index positions the cache and adds the data
-                if (l_first == 0) {
-                    l_first = deflate(p_isfile, p_strvec[it->second.first]);
-                    
-                    #pragma omp critical
-                    l_cache(it->second.first) = l_first;
-                }
-                
-                if (l_second == 0) {
-                    l_second = deflate(p_isfile, p_strvec[it->second.second]);
-                    
-                    #pragma omp critical 
-                    l_cache(it->second.second) = l_second;
-                }
-                
-                
-                // determin min and max
-                const std::size_t l_min = std::min(l_first, l_second);
-                const std::size_t l_max = std::max(l_first, l_second);
-                
-                // calculate NCD
-                l_result(it->second.first, it->second.second) = std::min( static_cast<T>(1),
-                             0.5 * (static_cast<T>(deflate(p_isfile, p_strvec[it->second.first], p_strvec[it->second.second]) - l_min) / l_max + 
-                                    static_cast<T>(deflate(p_isfile, p_strvec[it->second.second], p_strvec[it->second.first]) - l_min) / l_max)
-                             );
-
-            }
-        }
+        if (m_cache)
+            m_cache->flush(false);
         
-         // we set the diagonal elements to zero, because constructor has no parameter for initialization value
-         #pragma omp for
-         for(std::size_t i=0; i < l_result.size1(); ++i)
-             l_result(i,i) = static_cast<T>(0);
-         
-         return l_result;
+        return l_result;
     }
     
     
@@ -351,80 +476,189 @@ namespace machinelearning { namespace distances {
         if ( (p_strvec1.size() == 0) || (p_strvec2.size() == 0) )
             throw exception::runtime(_("vector size must be greater than zero"), *this);
         
-        // init data
-        ublas::vector<std::size_t> l_cache(p_strvec1.size() + p_strvec2.size(), 0);
-        ublas::matrix<T> l_result( p_strvec1.size(), p_strvec2.size() );
+        ublas::matrix<T> l_result( p_strvec1.size(), p_strvec2.size(), static_cast<T>(0) );
+        pair_distance( p_strvec1, p_strvec2, p_isfile, false, false, l_result );
+        
+        if (m_cache)
+            m_cache->flush(false);
+        
+        return l_result;
+    }
     
-        // we create the map for threads (on the contrary to wavefront we cut patches for each thread, because we must calculate each element without any topographical order)
-        // The map element has in the std::pair within the first position the index of the first vector
-        std::multimap<std::size_t, std::pair<std::size_t,std::size_t> > l_map;
+    
+    #if defined(MACHINELEARNING_FILES) && defined(MACHINELEARNING_FILES_HDF) && !defined(SWIG)
+    
+    /** calculate all distances between each element of both string vectors and writes
+     * each tile into a chunked HDF dataset, so the matrix need not be fit into the memory.
+     * The finished tiles are stored in the dataset <path>_tiles, so an interrupted run
+     * is resumed with the missing tiles
+     * @param p_file HDF file
+     * @param p_path dataset path
+     * @param p_datatype HDF datatype of the matrix
+     * @param p_strvec1 string vector
+     * @param p_strvec2 string vector
+     * @param p_isfile parameter for interpreting the string as a file with path
+     **/
+    template<typename T> inline void ncd<T>::unsquare( tools::files::hdf& p_file, const std::string& p_path, const tools::files::hdf::datatype& p_datatype, const std::vector<std::string>& p_strvec1, const std::vector<std::string>& p_strvec2, const bool& p_isfile ) const
+    {
+        if ( (p_strvec1.size() == 0) || (p_strvec2.size() == 0) )
+            throw exception::runtime(_("vector size must be greater than zero"), *this);
         
-        #pragma omp parallel shared(l_map, l_cache, l_result)
-        {
-            if (p_strvec1.size() < p_strvec2.size())
-                
-                #pragma omp for
-                for(std::size_t j=0; j < p_strvec1.size(); ++j)
-                    for(std::size_t i=0; i < p_strvec2.size(); ++i)
-                        
-                        #pragma omp critical
-                        l_map.insert(  std::pair<std::size_t, std::pair<std::size_t,std::size_t> >(i % omp_get_max_threads(), std::pair<std::size_t,std::size_t>(j,i))  );
-            
-            else
-                
-                #pragma omp for
-                for(std::size_t j=0; j < p_strvec2.size(); ++j)
-                    for(std::size_t i=0; i < p_strvec1.size(); ++i)
-                        
-                        #pragma omp critical
-                        l_map.insert(  std::pair<std::size_t, std::pair<std::size_t,std::size_t> >(i % omp_get_max_threads(), std::pair<std::size_t,std::size_t>(i,j))  );
-
-            
-            #pragma omp barrier
-            
-            for(std::multimap<std::size_t, std::pair<std::size_t,std::size_t> >::iterator it=l_map.lower_bound(omp_get_thread_num()); it != l_map.upper_bound(omp_get_thread_num()); ++it) {
+        const ublas::matrix<unsigned char> l_done = tile_open( p_file, p_path, p_datatype, p_strvec1.size(), p_strvec2.size() );
         
-                // read cache data
-                std::size_t l_first=0, l_second=0;
-                
-                #pragma omp critical
-                {
-                    l_first  = l_cache(it->second.first);
-                    l_second = l_cache(p_strvec1.size()+it->second.second);
-                }
-                
-                // check for both index positions the cache and adds the data
-                if (l_first == 0) {
-                    l_first = deflate(p_isfile, p_strvec1[it->second.first]);
-                    
-                    #pragma omp critical
-                    l_cache(it->second.first) = l_first;
-                }
-                
-                if (l_second == 0) {
-                    l_second = deflate(p_isfile, p_strvec2[it->second.second]);
-                    
-                    #pragma omp critical 
-                    l_cache(p_strvec1.size()+it->second.second) = l_second;
-                }
+        for(std::size_t i=0; i < l_done.size1(); ++i)
+            for(std::size_t j=0; j < l_done.size2(); ++j)
+                if (!l_done(i, j))
+                    tile_write( p_file, p_path, p_datatype, unsquare(tile_range(p_strvec1, i), tile_range(p_strvec2, j), p_isfile), i, j );
+        
+        if (m_cache)
+            m_cache->flush();
+    }
+    
+    
+    /** calculate all distances of the string vector and writes each tile into
+     * a chunked HDF dataset (see unsquare)
+     * @param p_file HDF file
+     * @param p_path dataset path
+     * @param p_datatype HDF datatype of the matrix
+     * @param p_strvec string vector
+     * @param p_isfile parameter for interpreting the string as a file with path
+     **/
+    template<typename T> inline void ncd<T>::unsymmetric( tools::files::hdf& p_file, const std::string& p_path, const tools::files::hdf::datatype& p_datatype, const std::vector<std::string>& p_strvec, const bool& p_isfile ) const
+    {
+        if (p_strvec.size() == 0)
+            throw exception::runtime(_("vector size must be greater than zero"), *this);
+        
+        const ublas::matrix<unsigned char> l_done = tile_open( p_file, p_path, p_datatype, p_strvec.size(), p_strvec.size() );
+        
+        for(std::size_t i=0; i < l_done.size1(); ++i)
+            for(std::size_t j=0; j < l_done.size2(); ++j)
+                if (!l_done(i, j))
+                    tile_write( p_file, p_path, p_datatype, (i == j) ? unsymmetric(tile_range(p_strvec, i), p_isfile) : unsquare(tile_range(p_strvec, i), tile_range(p_strvec, j), p_isfile), i, j );
+        
+        if (m_cache)
+            m_cache->flush();
+    }
+    
+    
+    /** calculate all distances of the string vector and writes each tile into
+     * a chunked HDF dataset (see unsquare). Only the upper tiles are calculated,
+     * the lower tiles are written transposed
+     * @param p_file HDF file
+     * @param p_path dataset path
+     * @param p_datatype HDF datatype of the matrix
+     * @param p_strvec string vector
+     * @param p_isfile parameter for interpreting the string as a file with path
+     **/
+    template<typename T> inline void ncd<T>::symmetric( tools::files::hdf& p_file, const std::string& p_path, const tools::files::hdf::datatype& p_datatype, const std::vector<std::string>& p_strvec, const bool& p_isfile ) const
+    {
+        if (p_strvec.size() == 0)
+            throw exception::runtime(_("vector size must be greater than zero"), *this);
+        
+        const ublas::matrix<unsigned char> l_done = tile_open( p_file, p_path, p_datatype, p_strvec.size(), p_strvec.size() );
+        
+        for(std::size_t i=0; i < l_done.size1(); ++i) {
+            if (!l_done(i, i))
+                tile_write( p_file, p_path, p_datatype, symmetric(tile_range(p_strvec, i), p_isfile), i, i );
+            
+            for(std::size_t j=i+1; j < l_done.size2(); ++j) {
+                if (l_done(i, j))
+                    continue;
                 
+                // both concatenation orders are needed for the symmetric value
+                ublas::matrix<T> l_result( std::min(m_tilesize, p_strvec.size() - i * m_tilesize), std::min(m_tilesize, p_strvec.size() - j * m_tilesize), static_cast<T>(0) );
+                pair_distance( tile_range(p_strvec, i), tile_range(p_strvec, j), p_isfile, false, true, l_result );
+                if (m_cache)
+                    m_cache->flush(false);
                 
-                // determin min and max
-                const std::size_t l_min = std::min(l_first, l_second);
-                const std::size_t l_max = std::max(l_first, l_second);
-        
-                // calculate NCD
-                l_result(it->second.first, it->second.second) = std::min( static_cast<T>(1), static_cast<T>(deflate(p_isfile, p_strvec1[it->second.first], p_strvec2[it->second.second]) - l_min) / l_max );
+                // the transposed tile is written first, so the flag of the upper tile marks both tiles
+                tile_write( p_file, p_path, p_datatype, ublas::trans(l_result), j, i );
+                tile_write( p_file, p_path, p_datatype, l_result, i, j );
             }
         }
-                
-        return l_result;
+        
+        if (m_cache)
+            m_cache->flush();
+    }
+    
+    
+    /** creates the HDF datasets of the tiled output or reads the flags of the finished tiles
+     * @param p_file HDF file
+     * @param p_path dataset path
+     * @param p_datatype HDF datatype of the matrix
+     * @param p_rows number of rows
+     * @param p_columns number of columns
+     * @return matrix with a flag for each tile
+     **/
+    template<typename T> inline ublas::matrix<unsigned char> ncd<T>::tile_open( tools::files::hdf& p_file, const std::string& p_path, const tools::files::hdf::datatype& p_datatype, const std::size_t& p_rows, const std::size_t& p_columns ) const
+    {
+        const std::size_t l_tilerows    = (p_rows + m_tilesize - 1) / m_tilesize;
+        const std::size_t l_tilecolumns = (p_columns + m_tilesize - 1) / m_tilesize;
+        
+        if (!p_file.pathexists(p_path)) {
+            p_file.createBlasMatrix( p_path, p_rows, p_columns, m_tilesize, m_tilesize, p_datatype );
+            p_file.writeBlasMatrix<unsigned char>( p_path+"_tiles", ublas::matrix<unsigned char>(l_tilerows, l_tilecolumns, 0), tools::files::hdf::NATIVE_UINT8 );
+            p_file.flush();
+            
+            return ublas::matrix<unsigned char>(l_tilerows, l_tilecolumns, 0);
+        }
+        
+        // resume an existing output, so the sizes must be equal
+        if (!p_file.pathexists(p_path+"_tiles"))
+            throw exception::runtime(_("dataset exists without tile information"), *this);
+        
+        const ublas::vector<std::size_t> l_size = p_file.getBlasMatrixSize(p_path);
+        const ublas::matrix<unsigned char> l_done = p_file.readBlasMatrix<unsigned char>( p_path+"_tiles", tools::files::hdf::NATIVE_UINT8 );
+        if ( (l_size(0) != p_rows) || (l_size(1) != p_columns) || (l_done.size1() != l_tilerows) || (l_done.size2() != l_tilecolumns) )
+            throw exception::runtime(_("existing dataset does not match the data or tile size"), *this);
+        
+        return l_done;
+    }
+    
+    
+    /** writes a tile into the HDF dataset and sets the tile flag
+     * @param p_file HDF file
+     * @param p_path dataset path
+     * @param p_datatype HDF datatype of the matrix
+     * @param p_tile tile data
+     * @param p_row tile row index
+     * @param p_column tile column index
+     **/
+    template<typename T> inline void ncd<T>::tile_write( tools::files::hdf& p_file, const std::string& p_path, const tools::files::hdf::datatype& p_datatype, const ublas::matrix<T>& p_tile, const std::size_t& p_row, const std::size_t& p_column ) const
+    {
+        p_file.writeBlasMatrixBlock<T>( p_path, p_tile, p_row * m_tilesize, p_column * m_tilesize, p_datatype );
+        p_file.flush();
+        
+        p_file.writeBlasMatrixBlock<unsigned char>( p_path+"_tiles", ublas::matrix<unsigned char>(1, 1, 1), p_row, p_column, tools::files::hdf::NATIVE_UINT8 );
+        p_file.flush();
+    }
+    
+    #endif
+    
+    
+    /** returns the strings of a tile
+     * @param p_strvec string vector
+     * @param p_tile tile index
+     * @return strings of the tile
+     **/
+    template<typename T> inline std::vector<std::string> ncd<T>::tile_range( const std::vector<std::string>& p_strvec, const std::size_t& p_tile ) const
+    {
+        return std::vector<std::string>( p_strvec.begin() + p_tile * m_tilesize, p_strvec.begin() + std::min(p_strvec.size(), (p_tile+1) * m_tilesize) );
     }
     
     
     #ifdef MACHINELEARNING_MPI
     
-    /** creates a distance matrix with shared data
+    /** creates a distance matrix with shared data. The pair space of all strings is cut into
+     * tiles of setTileSize() rows / columns, that are distributed by a queue of tile indices on
+     * the first process, all processes request tiles. Each process gets first the tiles of its own
+     * block of a 2D block-cyclic process grid, after that it takes tiles from the longest queue of
+     * the other processes. The strings stay on the process that holds them, a process fetches the
+     * strings of its tiles from the holding processes (each string block only once) and answers the
+     * requests of the other processes between the rows of a tile. The single compressed sizes are
+     * created by the holding process and are exchanged with one allgather, the tiles are sent at
+     * the end to the processes that hold the columns. The new cache entries of all processes are
+     * written by the first process
      * @param p_mpi MPI object
      * @param p_strvec local dataset
      * @param p_isfile parameter for interpreting the string as a file with path
@@ -438,115 +672,1285 @@ namespace machinelearning { namespace distances {
         // synchronize the isFile parameter
         const bool l_isfile = mpi::all_reduce(p_mpi, p_isfile, std::multiplies<bool>());
         
-        // we detect the matrix row size (sum over each CPU data - we don't use the all_reduce,
-        // because the different datasizes of each CPU data is needed later)
-        std::vector<std::size_t> l_datasize;
-        mpi::all_gather(p_mpi, p_strvec.size(), l_datasize );
-        const std::size_t l_rowsize = std::accumulate( l_datasize.begin(), l_datasize.end(), 0 );
+        if (p_mpi.size() == 1) {
+            ublas::matrix<T> l_result = unsquare(p_strvec, p_strvec, l_isfile);
+            for(std::size_t i = 0; i < l_result.size1(); ++i)
+                l_result(i,i) = 0;
+            return l_result;
+        }
         
-        // create the target matrix (rows = all data size, column local data size)
-        ublas::matrix<T> l_result( l_rowsize, p_strvec.size() );
+        // the single sizes are created by the process, that holds the string, and are exchanged with one allgather
+        std::vector<typename sizecache::key> l_localkeys;
+        const ublas::vector<std::size_t> l_localsingle = single_deflate(p_strvec, l_isfile, l_localkeys);
+        std::vector< std::vector<std::size_t> > l_gather;
+        mpi::all_gather(p_mpi, std::vector<std::size_t>(l_localsingle.begin(), l_localsingle.end()), l_gather );
         
+        std::vector<std::size_t> l_offset(1, 0);
+        for(std::size_t i=0; i < l_gather.size(); ++i)
+            l_offset.push_back( l_offset.back() + l_gather[i].size() );
         
-        // create the local distances
-        const std::size_t l_localrow = std::accumulate( l_datasize.begin(), l_datasize.begin() + static_cast<std::size_t>(p_mpi.rank()), 0 );
-        ublas::matrix_range< ublas::matrix<T> > l_rangelocal(l_result, 
-                                                                  ublas::range( l_localrow, l_localrow + p_strvec.size() ), 
-                                                                  ublas::range( 0, l_result.size2() )
-                                                                  );
-        l_rangelocal.assign( unsquare(p_strvec, p_strvec, l_isfile) );
+        ublas::vector<std::size_t> l_single( l_offset.back() );
+        for(std::size_t i=0; i < l_gather.size(); ++i)
+            std::copy( l_gather[i].begin(), l_gather[i].end(), l_single.begin() + l_offset[i] );
         
-        // create distance to the local articles and the articless of the neighborhood CPU
-        for(std::size_t i=1; i < static_cast<std::size_t>(p_mpi.size()); ++i)
-        {
-            // get start index on the matrix
-            const std::size_t l_successor   = (static_cast<std::size_t>(p_mpi.rank())+i) % static_cast<std::size_t>(p_mpi.size());
-            const std::size_t l_predecessor = (static_cast<std::size_t>(p_mpi.rank())+p_mpi.size()-i) % static_cast<std::size_t>(p_mpi.size());
-            
-            // send and receive with non-blocking operation and wait for both request
-            mpi::request l_req[2];
-            std::vector<std::string> l_neighbourdata;
-            l_req[0] = p_mpi.isend(l_successor, 0, p_strvec);
-            l_req[1] = p_mpi.irecv(l_predecessor, 0, l_neighbourdata);
-            mpi::wait_all(l_req, l_req+2);
-            
-            // get position within the matrix and create distance values
-            const std::size_t l_startrow = std::accumulate( l_datasize.begin(), l_datasize.begin() + l_predecessor, 0 );
-            ublas::matrix_range< ublas::matrix<T> > l_range( l_result, 
-                                                             ublas::range( l_startrow, l_startrow+l_neighbourdata.size() ), 
-                                                             ublas::range( 0, l_result.size2() )
-                                                           );
-            l_range.assign( unsquare(l_neighbourdata, p_strvec, l_isfile) );
+        // the content keys are needed only for the cache, they are sent as plain 64 bit values
+        std::vector<typename sizecache::key> l_keys( l_offset.back(), typename sizecache::key() );
+        if (m_cache) {
+            std::vector<boost::uint64_t> l_send( l_localkeys.size() * sizeof(typename sizecache::key) / sizeof(boost::uint64_t) );
+            if (!l_localkeys.empty())
+                std::memcpy( &l_send[0], &l_localkeys[0], l_localkeys.size() * sizeof(typename sizecache::key) );
+            
+            std::vector< std::vector<boost::uint64_t> > l_receive;
+            mpi::all_gather(p_mpi, l_send, l_receive);
+            for(std::size_t i=0; i < l_receive.size(); ++i)
+                if (!l_receive[i].empty())
+                    std::memcpy( &l_keys[l_offset[i]], &l_receive[i][0], l_receive[i].size() * sizeof(boost::uint64_t) );
         }
         
-        // set the main diagonal zero values
-        #pragma omp parallel for shared(l_result)
-        for(std::size_t i = 0; i < l_result.size2(); ++i)
-            l_result(l_localrow+i,i) = 0;
+        
+        // the result tiles are stored for each target process as header (row, number of rows, column, number of columns) and values
+        std::vector< std::vector<std::size_t> > l_header( static_cast<std::size_t>(p_mpi.size()) );
+        std::vector< std::vector<T> > l_values( static_cast<std::size_t>(p_mpi.size()) );
+        
+        mpi_process(p_mpi, p_strvec, l_single, l_keys, l_offset, l_isfile, l_header, l_values);
+        
+        if (m_cache)
+            mpi_cache(p_mpi);
+        
+        
+        // send the tiles to the processes of the columns
+        std::vector< std::vector<std::size_t> > l_receiveheader;
+        std::vector< std::vector<T> > l_receivevalues;
+        mpi::all_to_all(p_mpi, l_header, l_receiveheader);
+        mpi::all_to_all(p_mpi, l_values, l_receivevalues);
+        
+        const std::size_t l_localcolumn = l_offset[static_cast<std::size_t>(p_mpi.rank())];
+        ublas::matrix<T> l_result( l_offset.back(), p_strvec.size(), static_cast<T>(0) );
+        
+        for(std::size_t n=0; n < l_receiveheader.size(); ++n) {
+            std::size_t l_value = 0;
+            for(std::size_t k=0; k < l_receiveheader[n].size(); k += 4)
+                for(std::size_t i=0; i < l_receiveheader[n][k+1]; ++i)
+                    for(std::size_t j=0; j < l_receiveheader[n][k+3]; ++j)
+                        l_result(l_receiveheader[n][k]+i, l_receiveheader[n][k+2]-l_localcolumn+j) = l_receivevalues[n][l_value++];
+        }
         
         return l_result;
     }
-    #endif
     
     
-    /** deflate a string or file with the algorithm
-     * @param p_isfile bool for interpret input string like filenames
-     * @param p_str1 first string to compress
-     * @param p_str2 optional second string to compress
-     * @return number of bytes 
-     **/    
-    template<typename T> inline std::size_t ncd<T>::deflate( const bool& p_isfile, const std::string& p_str1, const std::string& p_str2 ) const
+    /** calculates the tiles of a process. The first process holds the tile queue, the other
+     * processes request the tiles. Between the row steps of a tile and during waiting each process
+     * answers the requests of the other processes, so the strings are fetched from the holding
+     * processes. At the end each process answers requests until all processes have finished
+     * @param p_mpi MPI object
+     * @param p_strvec local strings
+     * @param p_single single compressed sizes of all strings
+     * @param p_keys content keys of all strings (zero keys without cache)
+     * @param p_offset index of the first string of each process (last element is the number of all strings)
+     * @param p_isfile parameter for interpreting the string as a file with path
+     * @param p_header header of the result tiles for each process (row, number of rows, column, number of columns)
+     * @param p_values values of the result tiles for each process
+     **/
+    template<typename T> inline void ncd<T>::mpi_process( const mpi::communicator& p_mpi, const std::vector<std::string>& p_strvec, const ublas::vector<std::size_t>& p_single, const std::vector<typename sizecache::key>& p_keys, const std::vector<std::size_t>& p_offset, const bool& p_isfile, std::vector< std::vector<std::size_t> >& p_header, std::vector< std::vector<T> >& p_values ) const
     {
-        if (p_str1.empty())
-            throw exception::runtime(_("string size must be greater than zero"), *this);
-
-        // for each compress algorithm we removed the header & footer size of the resulting count
-        // @see http://en.wikipedia.org/wiki/Bzip2#File_format
-        // @see http://en.wikipedia.org/wiki/Gzip#File_format
-        std::size_t l_removesize = 0;
-        
-        // create output null stream, compressor and counter structure
-        bio::counter l_counter;
-        bio::basic_null_sink<char> l_null;
-        bio::filtering_streambuf< bio::output > l_deflate;
+        const std::size_t l_processes = static_cast<std::size_t>(p_mpi.size());
+        std::vector< std::deque< std::pair<std::size_t,std::size_t> > > l_queue;
         
-        switch (m_compress) {
-            case gzip   : l_deflate.push( bio::gzip_compressor( m_gzipparam ) );      l_removesize = 18; break;
-            case bzip2  : l_deflate.push( bio::bzip2_compressor( m_bzip2param ) );    l_removesize = 8; break;
+        // block-cyclic queue of each process on a grid of all processes (rows x columns)
+        if (p_mpi.rank() == 0) {
+            std::size_t l_gridrows = static_cast<std::size_t>(std::sqrt(static_cast<double>(l_processes)));
+            while (l_processes % l_gridrows)
+                --l_gridrows;
+            const std::size_t l_gridcolumns = l_processes / l_gridrows;
+            
+            const std::size_t l_blocks = (p_offset.back() + m_tilesize - 1) / m_tilesize;
+            l_queue.resize( l_processes );
+            for(std::size_t i=0; i < l_blocks; ++i)
+                for(std::size_t j=0; j < l_blocks; ++j)
+                    l_queue[ (i % l_gridrows) * l_gridcolumns + (j % l_gridcolumns) ].push_back( std::pair<std::size_t,std::size_t>(i, j) );
         }
-        l_deflate.push( boost::ref(l_counter) );        
-        l_deflate.push( l_null );
-        
-        // create stream for data and copy streamdata to output
-        if (p_isfile) {
-            // for filestreams copy data manually to deflate stream, cause boost::iostreams::copy close
-            // source and destination stream after copy is finished, so we copy only data from first
-            // stream into deflate and than from second stream
-            
-            std::ifstream l_file1(p_str1.c_str(), std::ifstream::binary);
-            if (!l_file1.is_open())
-                throw exception::runtime(_("file can not be opened"), *this);
-            std::copy( std::istream_iterator<char>(l_file1), std::istream_iterator<char>(), std::ostreambuf_iterator<char>(&l_deflate) );
-            
-            if (!p_str2.empty()) {
-                std::ifstream l_file2(p_str2.c_str(), std::ifstream::binary);
-                if (!l_file2.is_open())
-                    throw exception::runtime(_("file can not be opened"), *this);
-                std::copy( std::istream_iterator<char>(l_file2), std::istream_iterator<char>(), std::ostreambuf_iterator<char>(&l_deflate) );
+        
+        // number of rows, that are calculated before the requests are answered
+        const std::size_t l_step = std::max( static_cast<std::size_t>(16), static_cast<std::size_t>(omp_get_max_threads()) );
+        std::map<std::size_t, std::vector<std::string> > l_blocks;
+        std::vector<mpi::request> l_pending;
+        std::size_t l_finished = 0;
+        bool l_stop = false;
+        
+        while (true) {
+            
+            // the first process takes its tiles directly, the other processes request them
+            std::vector<std::size_t> l_index;
+            if (p_mpi.rank() == 0) {
+                std::pair<std::size_t,std::size_t> l_tile;
+                if (mpi_next(l_queue, 0, l_tile)) {
+                    l_index.push_back(l_tile.first);
+                    l_index.push_back(l_tile.second);
+                }
+            } else {
+                p_mpi.send(0, 0, true);
+                while (!p_mpi.iprobe(0, 1))
+                    mpi_serve(p_mpi, p_strvec, p_offset, l_queue, l_pending, l_finished, l_stop);
+                p_mpi.recv(0, 1, l_index);
             }
             
-        } else {
-          
-            // we read binary data and don't skip any whitespaces
-            std::stringstream l_sstream( std::stringstream::in | std::stringstream::out | std::stringstream::binary );
-            l_sstream << std::noskipws << p_str1 << p_str2;
-            std::copy( std::istream_iterator<char>(l_sstream), std::istream_iterator<char>(), std::ostreambuf_iterator<char>(&l_deflate) );
+            if (l_index.empty())
+                break;
+            
+            const std::vector<std::string>& l_rows    = mpi_block(p_mpi, p_strvec, p_offset, l_index[0], l_blocks, l_queue, l_pending, l_finished, l_stop);
+            const std::vector<std::string>& l_columns = mpi_block(p_mpi, p_strvec, p_offset, l_index[1], l_blocks, l_queue, l_pending, l_finished, l_stop);
+            const std::size_t l_rowfirst    = l_index[0] * m_tilesize;
+            const std::size_t l_columnfirst = l_index[1] * m_tilesize;
+            
+            const ublas::vector<std::size_t> l_columnsize( ublas::subrange(p_single, l_columnfirst, l_columnfirst + l_columns.size()) );
+            const std::vector<typename sizecache::key> l_columnkeys( p_keys.begin() + l_columnfirst, p_keys.begin() + (l_columnfirst + l_columns.size()) );
+            ublas::matrix<T> l_distance( l_rows.size(), l_columns.size(), static_cast<T>(0) );
+            
+            // the tile is calculated in row steps, the pairs (i,i) are set to zero by mpi_tile
+            for(std::size_t i=0; i < l_rows.size(); i += l_step) {
+                const std::size_t l_end = std::min( i + l_step, l_rows.size() );
+                const std::vector<std::string> l_current( l_rows.begin() + i, l_rows.begin() + l_end );
+                const ublas::vector<std::size_t> l_currentsize( ublas::subrange(p_single, l_rowfirst + i, l_rowfirst + l_end) );
+                const std::vector<typename sizecache::key> l_currentkeys( p_keys.begin() + (l_rowfirst + i), p_keys.begin() + (l_rowfirst + l_end) );
+                ublas::matrix_range< ublas::matrix<T> > l_currentdistance( l_distance, ublas::range(i, l_end), ublas::range(0, l_columns.size()) );
+                
+                if (m_snapshot)
+                    snapshot_distance( l_current, l_columns, l_currentsize, l_columnsize, l_currentkeys, l_columnkeys, p_isfile, false, false, l_currentdistance );
+                else
+                    tile_distance( l_current, l_columns, l_currentsize, l_columnsize, l_currentkeys, l_columnkeys, p_isfile, false, false, l_currentdistance );
+                
+                while (mpi_serve(p_mpi, p_strvec, p_offset, l_queue, l_pending, l_finished, l_stop));
+            }
+            
+            mpi_tile( p_offset, l_index[0], l_index[1], l_distance, p_header, p_values );
+        }
+        
+        // a process, that has got no tile, does not fetch strings anymore, so the
+        // first process stops all processes after all processes have got no tile
+        if (p_mpi.rank() == 0) {
+            while (l_finished < l_processes-1)
+                mpi_serve(p_mpi, p_strvec, p_offset, l_queue, l_pending, l_finished, l_stop);
+            for(std::size_t i=1; i < l_processes; ++i)
+                p_mpi.send(static_cast<int>(i), 3, true);
+        } else
+            while (!l_stop)
+                mpi_serve(p_mpi, p_strvec, p_offset, l_queue, l_pending, l_finished, l_stop);
+        
+        mpi::wait_all( l_pending.begin(), l_pending.end() );
+    }
+    
+    
+    /** answers one pending request of another process: a tile request (only on the first process),
+     * a string request or the stop message. The replies of the own requests are not received
+     * @param p_mpi MPI object
+     * @param p_strvec local strings
+     * @param p_offset index of the first string of each process (last element is the number of all strings)
+     * @param p_queue tile queues of all processes (only on the first process)
+     * @param p_pending requests of the sent strings, the finished requests are removed
+     * @param p_finished number of processes, that have got no tile
+     * @param p_stop stop flag, that is set by the stop message
+     * @return existance of a request
+     **/
+    template<typename T> inline bool ncd<T>::mpi_serve( const mpi::communicator& p_mpi, const std::vector<std::string>& p_strvec, const std::vector<std::size_t>& p_offset, std::vector< std::deque< std::pair<std::size_t,std::size_t> > >& p_queue, std::vector<mpi::request>& p_pending, std::size_t& p_finished, bool& p_stop ) const
+    {
+        for(std::size_t i=0; i < p_pending.size(); )
+            if (p_pending[i].test()) {
+                p_pending[i] = p_pending.back();
+                p_pending.pop_back();
+            } else
+                ++i;
+        
+        // the strings are sent non-blocking, so two processes, that request strings of each other, do not block
+        if (const boost::optional<mpi::status> l_status = p_mpi.iprobe(mpi::any_source, 2)) {
+            std::vector<std::size_t> l_range;
+            p_mpi.recv(l_status->source(), 2, l_range);
+            
+            const std::size_t l_first = p_offset[static_cast<std::size_t>(p_mpi.rank())];
+            p_pending.push_back( p_mpi.isend(l_status->source(), 4, std::vector<std::string>(p_strvec.begin() + (l_range[0] - l_first), p_strvec.begin() + (l_range[1] - l_first))) );
+            return true;
+        }
+        
+        if (p_mpi.rank() == 0)
+            if (const boost::optional<mpi::status> l_status = p_mpi.iprobe(mpi::any_source, 0)) {
+                bool l_request;
+                p_mpi.recv(l_status->source(), 0, l_request);
+                
+                std::vector<std::size_t> l_index;
+                std::pair<std::size_t,std::size_t> l_tile;
+                if (mpi_next(p_queue, static_cast<std::size_t>(l_status->source()), l_tile)) {
+                    l_index.push_back(l_tile.first);
+                    l_index.push_back(l_tile.second);
+                } else
+                    p_finished++;
+                
+                p_mpi.send(l_status->source(), 1, l_index);
+                return true;
+            }
+        
+        if (p_mpi.iprobe(0, 3)) {
+            p_mpi.recv(0, 3, p_stop);
+            return true;
+        }
+        
+        return false;
+    }
+    
+    
+    /** returns the strings of a tile block, the parts of the other processes are requested from
+     * the holding process and each block is requested only once
+     * @param p_mpi MPI object
+     * @param p_strvec local strings
+     * @param p_offset index of the first string of each process (last element is the number of all strings)
+     * @param p_block block index
+     * @param p_blocks received blocks
+     * @param p_queue tile queues of all processes (only on the first process)
+     * @param p_pending requests of the sent strings
+     * @param p_finished number of processes, that have got no tile
+     * @param p_stop stop flag
+     * @return strings of the block
+     **/
+    template<typename T> inline const std::vector<std::string>& ncd<T>::mpi_block( const mpi::communicator& p_mpi, const std::vector<std::string>& p_strvec, const std::vector<std::size_t>& p_offset, const std::size_t& p_block, std::map<std::size_t, std::vector<std::string> >& p_blocks, std::vector< std::deque< std::pair<std::size_t,std::size_t> > >& p_queue, std::vector<mpi::request>& p_pending, std::size_t& p_finished, bool& p_stop ) const
+    {
+        typename std::map<std::size_t, std::vector<std::string> >::iterator l_block = p_blocks.find(p_block);
+        if (l_block != p_blocks.end())
+            return l_block->second;
+        
+        std::vector<std::string>& l_result = p_blocks[p_block];
+        const std::size_t l_rank = static_cast<std::size_t>(p_mpi.rank());
+        const std::size_t l_end  = std::min( p_offset.back(), (p_block+1) * m_tilesize );
+        
+        for(std::size_t l_first = p_block * m_tilesize, l_process = 0; l_first < l_end; ) {
+            while (p_offset[l_process+1] <= l_first)
+                ++l_process;
+            const std::size_t l_last = std::min( l_end, p_offset[l_process+1] );
+            
+            if (l_process == l_rank)
+                l_result.insert( l_result.end(), p_strvec.begin() + (l_first - p_offset[l_rank]), p_strvec.begin() + (l_last - p_offset[l_rank]) );
+            else {
+                std::vector<std::size_t> l_range;
+                l_range.push_back(l_first);
+                l_range.push_back(l_last);
+                p_mpi.send(static_cast<int>(l_process), 2, l_range);
+                
+                while (!p_mpi.iprobe(static_cast<int>(l_process), 4))
+                    mpi_serve(p_mpi, p_strvec, p_offset, p_queue, p_pending, p_finished, p_stop);
+                
+                std::vector<std::string> l_part;
+                p_mpi.recv(static_cast<int>(l_process), 4, l_part);
+                l_result.insert( l_result.end(), l_part.begin(), l_part.end() );
+            }
+            
+            l_first = l_last;
+        }
+        
+        return l_result;
+    }
+    
+    
+    /** takes the next tile of a process from its own queue or steals it from the longest queue
+     * @param p_queue tile queues of all processes
+     * @param p_process process index
+     * @param p_tile reference for the tile index (row, column)
+     * @return existance of a tile
+     **/
+    template<typename T> inline bool ncd<T>::mpi_next( std::vector< std::deque< std::pair<std::size_t,std::size_t> > >& p_queue, const std::size_t& p_process, std::pair<std::size_t,std::size_t>& p_tile ) const
+    {
+        std::size_t l_source = p_process;
+        if (p_queue[p_process].empty())
+            for(std::size_t i=0; i < p_queue.size(); ++i)
+                if (p_queue[i].size() > p_queue[l_source].size())
+                    l_source = i;
+        
+        if (p_queue[l_source].empty())
+            return false;
+        
+        if (l_source == p_process) {
+            p_tile = p_queue[l_source].front();
+            p_queue[l_source].pop_front();
+        } else {
+            p_tile = p_queue[l_source].back();
+            p_queue[l_source].pop_back();
+        }
+        
+        return true;
+    }
+    
+    
+    /** splits a distance tile by the processes of the columns
+     * @param p_offset index of the first string of each process (last element is the number of all strings)
+     * @param p_tilerow row index of the tile
+     * @param p_tilecolumn column index of the tile
+     * @param p_distance distances of the tile
+     * @param p_header header of the result tiles for each process (row, number of rows, column, number of columns)
+     * @param p_values values of the result tiles for each process
+     **/
+    template<typename T> inline void ncd<T>::mpi_tile( const std::vector<std::size_t>& p_offset, const std::size_t& p_tilerow, const std::size_t& p_tilecolumn, const ublas::matrix<T>& p_distance, std::vector< std::vector<std::size_t> >& p_header, std::vector< std::vector<T> >& p_values ) const
+    {
+        const std::size_t l_row    = p_tilerow * m_tilesize;
+        const std::size_t l_column = p_tilecolumn * m_tilesize;
+        
+        for(std::size_t j=0, l_process=0; j < p_distance.size2(); ) {
+            while (p_offset[l_process+1] <= l_column+j)
+                ++l_process;
+            const std::size_t l_end = std::min( p_distance.size2(), p_offset[l_process+1] - l_column );
+            
+            p_header[l_process].push_back( l_row );
+            p_header[l_process].push_back( p_distance.size1() );
+            p_header[l_process].push_back( l_column+j );
+            p_header[l_process].push_back( l_end-j );
+            
+            for(std::size_t n=0; n < p_distance.size1(); ++n)
+                for(std::size_t m=j; m < l_end; ++m)
+                    p_values[l_process].push_back( (l_row+n == l_column+m) ? static_cast<T>(0) : p_distance(n, m) );
+            
+            j = l_end;
+        }
+    }
+    
+    
+    /** collects the new cache entries of all processes and writes them by the first process,
+     * so the cache file is written only once. After that all processes reopen the file
+     * @param p_mpi MPI object
+     **/
+    template<typename T> inline void ncd<T>::mpi_cache( const mpi::communicator& p_mpi ) const
+    {
+        // the entries are plain 64 bit values, so they are sent as a value vector
+        const std::vector<typename sizecache::entry> l_entries = m_cache->release();
+        std::vector<boost::uint64_t> l_send( l_entries.size() * sizeof(typename sizecache::entry) / sizeof(boost::uint64_t) );
+        if (!l_entries.empty())
+            std::memcpy( &l_send[0], &l_entries[0], l_entries.size() * sizeof(typename sizecache::entry) );
+        
+        std::vector< std::vector<boost::uint64_t> > l_receive;
+        mpi::gather(p_mpi, l_send, l_receive, 0);
+        
+        // the write error is sent to all processes, so no process waits for the first one
+        bool l_written = true;
+        if (p_mpi.rank() == 0)
+            try {
+                for(std::size_t i=0; i < l_receive.size(); ++i)
+                    for(std::size_t j=0; j < l_receive[i].size(); j += sizeof(typename sizecache::entry) / sizeof(boost::uint64_t)) {
+                        typename sizecache::entry l_entry;
+                        std::memcpy( &l_entry, &l_receive[i][j], sizeof(l_entry) );
+                        m_cache->insert( l_entry );
+                    }
+                m_cache->flush();
+            } catch (...) {
+                l_written = false;
+            }
+        
+        mpi::broadcast(p_mpi, l_written, 0);
+        if (!l_written)
+            throw exception::runtime(_("cache file can not be written"), *this);
+        
+        if (p_mpi.rank() != 0)
+            m_cache->open();
+    }
+    
+    #endif
+    
+    
+    /** constructor of the data view
+     * @param p_isfile bool for interpret input string like filenames
+     * @param p_str string or filename
+     **/
+    template<typename T> inline ncd<T>::dataview::dataview( const bool& p_isfile, const std::string& p_str ) :
+        m_file(),
+        m_data( p_str.data() ),
+        m_size( p_str.size() )
+    {
+        if (!p_isfile)
+            return;
+        
+        try {
+            m_file.open( p_str );
+        } catch (...) {
+            throw exception::runtime(_("file can not be opened"));
+        }
+        
+        m_data = m_file.data();
+        m_size = m_file.size();
+    }
+    
+    
+    /** destructor of the state pool, that frees all kept blocks **/
+    template<typename T> inline ncd<T>::statepool::~statepool( void )
+    {
+        for(std::size_t i=0; i < m_free.size(); ++i)
+            std::free( static_cast<char*>(m_free[i].second) - 2*sizeof(std::size_t) );
+    }
+    
+    
+    /** zlib allocation function, that returns a kept block of the same size or allocates a new one.
+     * The size is stored in front of the block
+     * @param p_pool pointer to the pool
+     * @param p_items number of items
+     * @param p_size size of an item
+     * @return pointer to the block or Z_NULL
+     **/
+    template<typename T> inline voidpf ncd<T>::statepool::allocate( voidpf p_pool, uInt p_items, uInt p_size )
+    {
+        std::vector< std::pair<std::size_t, void*> >& l_free = static_cast<statepool*>(p_pool)->m_free;
+        const std::size_t l_size = static_cast<std::size_t>(p_items) * p_size;
+        
+        for(std::size_t i=0; i < l_free.size(); ++i)
+            if (l_free[i].first == l_size) {
+                void* const l_block = l_free[i].second;
+                l_free[i] = l_free.back();
+                l_free.pop_back();
+                return l_block;
+            }
+        
+        // two size_t values are used for the header, so the alignment of malloc is kept
+        char* const l_block = static_cast<char*>( std::malloc(l_size + 2*sizeof(std::size_t)) );
+        if (!l_block)
+            return Z_NULL;
+        
+        *reinterpret_cast<std::size_t*>(l_block) = l_size;
+        return l_block + 2*sizeof(std::size_t);
+    }
+    
+    
+    /** zlib free function, that keeps the block for the next allocation
+     * @param p_pool pointer to the pool
+     * @param p_block pointer to the block
+     **/
+    template<typename T> inline void ncd<T>::statepool::release( voidpf p_pool, voidpf p_block )
+    {
+        const std::size_t l_size = *reinterpret_cast<std::size_t*>( static_cast<char*>(p_block) - 2*sizeof(std::size_t) );
+        static_cast<statepool*>(p_pool)->m_free.push_back( std::pair<std::size_t, void*>(l_size, p_block) );
+    }
+    
+    
+    /** deflate a string or file with the algorithm
+     * @param p_isfile bool for interpret input string like filenames
+     * @param p_str1 first string to compress
+     * @param p_str2 optional second string to compress
+     * @return number of bytes 
+     **/    
+    template<typename T> inline std::size_t ncd<T>::deflate( const bool& p_isfile, const std::string& p_str1, const std::string& p_str2 ) const
+    {
+        if (p_str1.empty())
+            throw exception::runtime(_("string size must be greater than zero"), *this);
+        
+        const dataview l_first( p_isfile, p_str1 );
+        if (p_str2.empty())
+            return deflate( l_first.data(), l_first.size() );
+        
+        const dataview l_second( p_isfile, p_str2 );
+        return deflate( l_first.data(), l_first.size(), l_second.data(), l_second.size() );
+    }
+    
+    
+    /** deflate the concatenation of two buffers, the compressed data is only counted
+     * @param p_data1 first data
+     * @param p_size1 size of the first data
+     * @param p_data2 optional second data
+     * @param p_size2 size of the second data
+     * @return number of bytes 
+     **/    
+    template<typename T> inline std::size_t ncd<T>::deflate( const char* p_data1, const std::size_t& p_size1, const char* p_data2, const std::size_t& p_size2 ) const
+    {
+        if ( (!p_data1) || (p_size1 == 0) )
+            throw exception::runtime(_("string size must be greater than zero"), *this);
+        
+        switch (m_compress) {
+            
+            // the gzip format is a raw deflate stream with header & footer, so only the
+            // raw deflate stream is counted
+            // @see http://en.wikipedia.org/wiki/Gzip#File_format
+            case gzip : {
+                z_stream l_stream;
+                gzip_init( l_stream );
+                gzip_process( l_stream, p_data1, p_size1, Z_NO_FLUSH );
+                const int l_status = gzip_process( l_stream, p_data2, p_size2, Z_FINISH );
+                
+                const std::size_t l_size = static_cast<std::size_t>(l_stream.total_out);
+                deflateEnd( &l_stream );
+                
+                if (l_status != Z_STREAM_END)
+                    throw exception::runtime(_("compression failed"), *this);
+                return l_size;
+            }
+            
+            case bzip2 :
+                return bzip2_deflate( p_data1, p_size1, p_data2, p_size2 );
+                
+            case lz :
+                return lz_deflate( p_data1, p_size1, p_data2, p_size2 );
+        }
+        
+        throw exception::runtime(_("compression type is unknown"), *this);
+    }
+    
+    
+    /** initializes a raw deflate stream with the gzip parameter
+     * @param p_stream uninitialized zlib stream
+     * @param p_pool optional allocator, that is also used by the copies of the stream
+     **/
+    template<typename T> inline void ncd<T>::gzip_init( z_stream& p_stream, statepool* p_pool ) const
+    {
+        p_stream.zalloc = p_pool ? &statepool::allocate : Z_NULL;
+        p_stream.zfree  = p_pool ? &statepool::release : Z_NULL;
+        p_stream.opaque = p_pool;
+        
+        if (deflateInit2( &p_stream, m_gzipparam.level, m_gzipparam.method, -m_gzipparam.window_bits, m_gzipparam.mem_level, m_gzipparam.strategy ) != Z_OK)
+            throw exception::runtime(_("compressor can not be initialized"), *this);
+    }
+    
+    
+    /** pushes a buffer into the deflate stream, the output is written into a local
+     * buffer and is discarded (only the size is needed)
+     * @param p_stream zlib stream
+     * @param p_data data
+     * @param p_size data size
+     * @param p_flush zlib flush option
+     * @return last zlib status
+     **/
+    template<typename T> inline int ncd<T>::gzip_process( z_stream& p_stream, const char* p_data, const std::size_t& p_size, const int& p_flush ) const
+    {
+        Bytef l_buffer[16384];
+        int l_status         = Z_OK;
+        std::size_t l_offset = 0;
+        
+        // zlib uses 32 bit sizes, so large buffers are pushed in chunks
+        do {
+            const std::size_t l_chunk = std::min( p_size - l_offset, static_cast<std::size_t>(std::numeric_limits<uInt>::max()) );
+            const bool l_last         = l_offset + l_chunk == p_size;
+            
+            p_stream.next_in  = reinterpret_cast<Bytef*>( const_cast<char*>(p_data) ) + l_offset;
+            p_stream.avail_in = static_cast<uInt>(l_chunk);
+            l_offset         += l_chunk;
+            
+            do {
+                p_stream.next_out  = l_buffer;
+                p_stream.avail_out = sizeof(l_buffer);
+                l_status = ::deflate( &p_stream, l_last ? p_flush : Z_NO_FLUSH );
+            } while ( (p_stream.avail_in > 0) || ((p_flush == Z_FINISH) && l_last && (l_status == Z_OK)) );
+            
+        } while (l_offset < p_size);
+        
+        return l_status;
+    }
+    
+    
+    /** deflate the concatenation of two buffers with bzip2
+     * @param p_data1 first data
+     * @param p_size1 size of the first data
+     * @param p_data2 second data
+     * @param p_size2 size of the second data
+     * @return number of bytes without the stream header & footer
+     * @see http://en.wikipedia.org/wiki/Bzip2#File_format
+     **/
+    template<typename T> inline std::size_t ncd<T>::bzip2_deflate( const char* p_data1, const std::size_t& p_size1, const char* p_data2, const std::size_t& p_size2 ) const
+    {
+        bz_stream l_stream;
+        l_stream.bzalloc = NULL;
+        l_stream.bzfree  = NULL;
+        l_stream.opaque  = NULL;
+        
+        if (BZ2_bzCompressInit( &l_stream, m_bzip2param.block_size, 0, m_bzip2param.work_factor ) != BZ_OK)
+            throw exception::runtime(_("compressor can not be initialized"), *this);
+        
+        char l_buffer[16384];
+        int l_status = BZ_RUN_OK;
+        const char* l_data[] = { p_data1, p_data2 };
+        const std::size_t l_size[] = { p_size1, p_size2 };
+        
+        for(std::size_t i=0; i < 2; ++i) {
+            std::size_t l_offset = 0;
+            
+            while (l_offset < l_size[i]) {
+                const std::size_t l_chunk = std::min( l_size[i] - l_offset, static_cast<std::size_t>(std::numeric_limits<unsigned int>::max()) );
+                l_stream.next_in  = const_cast<char*>(l_data[i]) + l_offset;
+                l_stream.avail_in = static_cast<unsigned int>(l_chunk);
+                l_offset         += l_chunk;
+                
+                while (l_stream.avail_in > 0) {
+                    l_stream.next_out  = l_buffer;
+                    l_stream.avail_out = sizeof(l_buffer);
+                    BZ2_bzCompress( &l_stream, BZ_RUN );
+                }
+            }
+        }
+        
+        do {
+            l_stream.next_out  = l_buffer;
+            l_stream.avail_out = sizeof(l_buffer);
+            l_status = BZ2_bzCompress( &l_stream, BZ_FINISH );
+        } while (l_status == BZ_FINISH_OK);
+        
+        const std::size_t l_bytes = (static_cast<std::size_t>(l_stream.total_out_hi32) << 32) + l_stream.total_out_lo32;
+        BZ2_bzCompressEnd( &l_stream );
+        
+        if (l_status != BZ_STREAM_END)
+            throw exception::runtime(_("compression failed"), *this);
+        
+        return (l_bytes >= 8) ? l_bytes-8 : l_bytes;
+    }
+    
+    
+    /** deflate the concatenation of two buffers with a fast LZ77 compressor (greedy parsing
+     * with hash chains and a 64kB window). The size is counted with the LZ4 block format,
+     * which has no header & footer, so the compressed data is not written
+     * @param p_data1 first data
+     * @param p_size1 size of the first data
+     * @param p_data2 second data
+     * @param p_size2 size of the second data
+     * @return number of bytes
+     * @see http://code.google.com/p/lz4/
+     **/
+    template<typename T> inline std::size_t ncd<T>::lz_deflate( const char* p_data1, const std::size_t& p_size1, const char* p_data2, const std::size_t& p_size2 ) const
+    {
+        // matches can cross the border, so the data must be contiguous
+        std::vector<unsigned char> l_concat;
+        const unsigned char* l_data = reinterpret_cast<const unsigned char*>(p_data1);
+        if (p_size2 > 0) {
+            l_concat.reserve( p_size1 + p_size2 );
+            l_concat.insert( l_concat.end(), p_data1, p_data1 + p_size1 );
+            l_concat.insert( l_concat.end(), p_data2, p_data2 + p_size2 );
+            l_data = &l_concat[0];
+        }
+        
+        const std::size_t l_length = p_size1 + p_size2;
+        const std::size_t l_window = 65535;
+        const std::size_t l_none   = std::numeric_limits<std::size_t>::max();
+        
+        // hash table and chain are sized by the data, so short strings need only small tables
+        std::size_t l_bits = 8;
+        while ( (l_bits < 16) && ((static_cast<std::size_t>(1) << l_bits) < l_length) )
+            ++l_bits;
+        std::size_t l_chainsize = 256;
+        while ( (l_chainsize <= l_window) && (l_chainsize < l_length) )
+            l_chainsize <<= 1;
+        
+        std::vector<std::size_t> l_head( static_cast<std::size_t>(1) << l_bits, l_none );
+        std::vector<std::size_t> l_chain( l_chainsize, l_none );
+        
+        // the last match must start 12 bytes and end 5 bytes before the end
+        const std::size_t l_matchlimit = (l_length > 12) ? l_length - 12 : 0;
+        const std::size_t l_endlimit   = (l_length > 5) ? l_length - 5 : 0;
+        std::size_t l_size   = 0;
+        std::size_t l_anchor = 0;
+        
+        for(std::size_t i=0; i < l_matchlimit; ) {
+            
+            // search the longest match within the chain of the hash
+            boost::uint32_t l_sequence;
+            std::memcpy( &l_sequence, l_data+i, sizeof(l_sequence) );
+            const std::size_t l_hash = static_cast<std::size_t>( static_cast<boost::uint32_t>(l_sequence * 2654435761U) >> (32 - l_bits) );
+            
+            std::size_t l_matchlength = 0;
+            std::size_t l_candidate   = l_head[l_hash];
+            for(std::size_t n=0; (n < m_lzdepth) && (l_candidate != l_none) && (i - l_candidate <= l_window); ++n) {
+                boost::uint32_t l_compare;
+                std::memcpy( &l_compare, l_data+l_candidate, sizeof(l_compare) );
+                
+                if (l_compare == l_sequence) {
+                    std::size_t l_matched = 4;
+                    while ( (i+l_matched < l_endlimit) && (l_data[l_candidate+l_matched] == l_data[i+l_matched]) )
+                        ++l_matched;
+                    l_matchlength = std::max( l_matchlength, l_matched );
+                }
+                
+                const std::size_t l_next = l_chain[l_candidate & (l_chainsize-1)];
+                if ( (l_next == l_none) || (l_next >= l_candidate) )
+                    break;
+                l_candidate = l_next;
+            }
+            
+            l_chain[i & (l_chainsize-1)] = l_head[l_hash];
+            l_head[l_hash]               = i;
+            
+            if (l_matchlength < 4) {
+                ++i;
+                continue;
+            }
+            
+            // sequence: token, literal length, literals, offset and match length
+            const std::size_t l_literals = i - l_anchor;
+            l_size += 3 + l_literals + ((l_literals >= 15) ? (l_literals-15) / 255 + 1 : 0) + ((l_matchlength >= 19) ? (l_matchlength-19) / 255 + 1 : 0);
+            
+            // positions within the match are added to the chains, except for the fastest search
+            const std::size_t l_end = i + l_matchlength;
+            for(++i; (m_lzdepth > 1) && (i < std::min(l_end, l_matchlimit)); ++i) {
+                std::memcpy( &l_sequence, l_data+i, sizeof(l_sequence) );
+                const std::size_t l_inside = static_cast<std::size_t>( static_cast<boost::uint32_t>(l_sequence * 2654435761U) >> (32 - l_bits) );
+                
+                l_chain[i & (l_chainsize-1)] = l_head[l_inside];
+                l_head[l_inside]             = i;
+            }
+            
+            i = l_anchor = l_end;
+        }
+        
+        // last sequence contains only literals
+        const std::size_t l_literals = l_length - l_anchor;
+        return l_size + 1 + l_literals + ((l_literals >= 15) ? (l_literals-15) / 255 + 1 : 0);
+    }
+    
+    
+    /** creates the compressed sizes of each string in one parallel pass
+     * @param p_strvec string vector
+     * @param p_isfile parameter for interpreting the string as a file with path
+     * @param p_keys content keys of the strings (zero keys without cache)
+     * @return vector with compressed sizes
+     **/
+    template<typename T> inline ublas::vector<std::size_t> ncd<T>::single_deflate( const std::vector<std::string>& p_strvec, const bool& p_isfile, std::vector<typename sizecache::key>& p_keys ) const
+    {
+        ublas::vector<std::size_t> l_size( p_strvec.size() );
+        p_keys = std::vector<typename sizecache::key>( p_strvec.size(), typename sizecache::key() );
+        
+        // exceptions must not leave the parallel region, so the first error is thrown after it
+        std::string l_error;
+        
+        #pragma omp parallel for shared(l_size, p_keys, l_error) schedule(dynamic)
+        for(std::size_t i=0; i < p_strvec.size(); ++i)
+            try {
+                if (p_strvec[i].empty())
+                    throw exception::runtime(_("string size must be greater than zero"), *this);
+                
+                const dataview l_data( p_isfile, p_strvec[i] );
+                if (m_cache)
+                    p_keys[i] = content_key(l_data);
+                
+                l_size(i) = cache_deflate( p_keys[i], typename sizecache::key(), l_data, dataview(false, std::string()) );
+            } catch (const std::exception& l_exception) {
+                #pragma omp critical(ncderror)
+                if (l_error.empty())
+                    l_error = l_exception.what();
+            }
+        
+        if (!l_error.empty())
+            throw exception::runtime(l_error);
+        
+        return l_size;
+    }
+    
+    
+    /** creates the distances of all pairs of the rows and columns. The single compressed sizes
+     * are created once, the pair sizes are not stored, so each distance is written into the result
+     * directly after the compression
+     * @param p_rows row strings
+     * @param p_columns column strings
+     * @param p_isfile parameter for interpreting the string as a file with path
+     * @param p_same rows and columns are the same strings, so the pair (i,i) is not compressed
+     * @param p_symmetric the distance is the mean of both concatenation orders (with the same
+     * strings only the upper triangle is written)
+     * @param p_result result matrix (rows x columns), that must be initialized with zero
+     **/
+    template<typename T> template<typename M> inline void ncd<T>::pair_distance( const std::vector<std::string>& p_rows, const std::vector<std::string>& p_columns, const bool& p_isfile, const bool& p_same, const bool& p_symmetric, M& p_result ) const
+    {
+        std::vector<typename sizecache::key> l_rowkeys;
+        std::vector<typename sizecache::key> l_columnkeys;
+        const ublas::vector<std::size_t> l_rowsize    = single_deflate(p_rows, p_isfile, l_rowkeys);
+        const ublas::vector<std::size_t> l_columnsize = p_same ? l_rowsize : single_deflate(p_columns, p_isfile, l_columnkeys);
+        if (p_same)
+            l_columnkeys = l_rowkeys;
+        
+        // with snapshot the concatenation sizes are created row-wise, otherwise tile-wise
+        if (m_snapshot)
+            snapshot_distance( p_rows, p_columns, l_rowsize, l_columnsize, l_rowkeys, l_columnkeys, p_isfile, p_same, p_symmetric, p_result );
+        else
+            tile_distance( p_rows, p_columns, l_rowsize, l_columnsize, l_rowkeys, l_columnkeys, p_isfile, p_same, p_symmetric, p_result );
+    }
+    
+    
+    /** creates the distances of all pairs. The pair index space is cut into tiles, each tile is
+     * a task that is taken from the dynamic schedule by the next idle thread, so different string
+     * lengths do not leave threads idle. Each distance is written by exactly one task, so the result
+     * is written without any lock
+     * @param p_rows row strings
+     * @param p_columns column strings
+     * @param p_rowsize compressed sizes of the rows
+     * @param p_columnsize compressed sizes of the columns
+     * @param p_rowkeys content keys of the rows
+     * @param p_columnkeys content keys of the columns
+     * @param p_isfile parameter for interpreting the string as a file with path
+     * @param p_same rows and columns are the same strings
+     * @param p_symmetric the distance is the mean of both concatenation orders
+     * @param p_result result matrix
+     **/
+    template<typename T> template<typename M> inline void ncd<T>::tile_distance( const std::vector<std::string>& p_rows, const std::vector<std::string>& p_columns, const ublas::vector<std::size_t>& p_rowsize, const ublas::vector<std::size_t>& p_columnsize, const std::vector<typename sizecache::key>& p_rowkeys, const std::vector<typename sizecache::key>& p_columnkeys, const bool& p_isfile, const bool& p_same, const bool& p_symmetric, M& p_result ) const
+    {
+        const std::size_t l_tile = 16;
+        const std::size_t l_tilerows    = (p_rows.size() + l_tile - 1) / l_tile;
+        const std::size_t l_tilecolumns = (p_columns.size() + l_tile - 1) / l_tile;
+        
+        // exceptions must not leave the parallel region, so the first error is thrown after it
+        std::string l_error;
+        
+        #pragma omp parallel for shared(p_result, l_error) schedule(dynamic)
+        for(std::size_t n=0; n < l_tilerows * l_tilecolumns; ++n)
+            try {
+                const std::size_t l_rowstart    = (n / l_tilecolumns) * l_tile;
+                const std::size_t l_rowend      = std::min(l_rowstart + l_tile, p_rows.size());
+                const std::size_t l_columnstart = (n % l_tilecolumns) * l_tile;
+                const std::size_t l_columnend   = std::min(l_columnstart + l_tile, p_columns.size());
+                
+                // with the same strings the symmetric distance needs only the upper tiles
+                if ( p_same && p_symmetric && (l_columnend <= l_rowstart) )
+                    continue;
+                
+                // the column data of the tile is read / mapped only once
+                std::vector<dataview> l_columns;
+                for(std::size_t j=l_columnstart; j < l_columnend; ++j)
+                    l_columns.push_back( dataview(p_isfile, p_columns[j]) );
+                
+                for(std::size_t i=l_rowstart; i < l_rowend; ++i) {
+                    const dataview l_row( p_isfile, p_rows[i] );
+                    
+                    for(std::size_t j=l_columnstart; j < l_columnend; ++j) {
+                        if ( p_same && ((i == j) || (p_symmetric && (j < i))) )
+                            continue;
+                        
+                        const dataview& l_column = l_columns[j-l_columnstart];
+                        const std::size_t l_size = cache_deflate( p_rowkeys[i], p_columnkeys[j], l_row, l_column );
+                        
+                        if (!p_symmetric) {
+                            p_result(i, j) = std::min( static_cast<T>(1), static_cast<T>(l_size - std::min(p_rowsize(i), p_columnsize(j))) / std::max(p_rowsize(i), p_columnsize(j)) );
+                            continue;
+                        }
+                        
+                        const std::size_t l_trans = cache_deflate( p_columnkeys[j], p_rowkeys[i], l_column, l_row );
+                        const T l_min = static_cast<T>(std::min(p_rowsize(i), p_columnsize(j)));
+                        const T l_max = static_cast<T>(std::max(p_rowsize(i), p_columnsize(j)));
+                        
+                        p_result(i, j) = std::min( static_cast<T>(1), static_cast<T>(0.5) * ((l_size - l_min) / l_max + (l_trans - l_min) / l_max) );
+                    }
+                }
+            } catch (const std::exception& l_exception) {
+                #pragma omp critical(ncderror)
+                if (l_error.empty())
+                    l_error = l_exception.what();
+            }
+        
+        if (!l_error.empty())
+            throw exception::runtime(l_error);
+    }
+    
+    
+    /** creates the distances with the compressor state snapshot. For each source string the
+     * compressor state is created once and is copied for each target string. The sources are
+     * the rows, for the symmetric distance of different strings also the columns (so both
+     * concatenation orders are created). The symmetric distance is summed with atomic updates,
+     * because both halfs are created by different sources
+     * @param p_rows row strings
+     * @param p_columns column strings
+     * @param p_rowsize compressed sizes of the rows
+     * @param p_columnsize compressed sizes of the columns
+     * @param p_rowkeys content keys of the rows
+     * @param p_columnkeys content keys of the columns
+     * @param p_isfile parameter for interpreting the string as a file with path
+     * @param p_same rows and columns are the same strings
+     * @param p_symmetric the distance is the mean of both concatenation orders
+     * @param p_result result matrix
+     **/
+    template<typename T> template<typename M> inline void ncd<T>::snapshot_distance( const std::vector<std::string>& p_rows, const std::vector<std::string>& p_columns, const ublas::vector<std::size_t>& p_rowsize, const ublas::vector<std::size_t>& p_columnsize, const std::vector<typename sizecache::key>& p_rowkeys, const std::vector<typename sizecache::key>& p_columnkeys, const bool& p_isfile, const bool& p_same, const bool& p_symmetric, M& p_result ) const
+    {
+        // files are mapped only once
+        std::vector<dataview> l_rows;
+        std::vector<dataview> l_columns;
+        for(std::size_t i=0; i < p_rows.size(); ++i)
+            l_rows.push_back( dataview(p_isfile, p_rows[i]) );
+        for(std::size_t j=0; !p_same && (j < p_columns.size()); ++j)
+            l_columns.push_back( dataview(p_isfile, p_columns[j]) );
+        
+        const std::vector<dataview>& l_targetviews = p_same ? l_rows : l_columns;
+        const std::size_t l_sources = p_rows.size() + ((p_symmetric && !p_same) ? p_columns.size() : 0);
+        std::string l_error;
+        
+        #pragma omp parallel shared(p_result, l_rows, l_columns, l_error)
+        {
+            // the copies of the compressor state (~256kB each) reuse the memory blocks of the thread
+            statepool l_pool;
+            
+            #pragma omp for schedule(dynamic)
+            for(std::size_t s=0; s < l_sources; ++s)
+                try {
+                    // the transposed sources are the columns, that are concatenated with the rows
+                    const bool l_transposed = s >= p_rows.size();
+                    const std::size_t l_index = l_transposed ? s - p_rows.size() : s;
+                    const dataview& l_source = l_transposed ? l_columns[l_index] : l_rows[l_index];
+                    const typename sizecache::key& l_sourcekey = l_transposed ? p_columnkeys[l_index] : p_rowkeys[l_index];
+                    const std::size_t l_sourcesize = l_transposed ? p_columnsize(l_index) : p_rowsize(l_index);
+                    const std::vector<dataview>& l_targets = l_transposed ? l_rows : l_targetviews;
+                    const std::vector<typename sizecache::key>& l_targetkeys = l_transposed ? p_rowkeys : p_columnkeys;
+                    const ublas::vector<std::size_t>& l_targetsize = l_transposed ? p_rowsize : p_columnsize;
+                    
+                    // with the cache only the missing sizes are compressed
+                    std::vector<std::size_t> l_size( l_targets.size(), 0 );
+                    std::vector<bool> l_found( l_targets.size(), false );
+                    bool l_complete = true;
+                    for(std::size_t j=0; j < l_targets.size(); ++j)
+                        if ( !p_same || (j != l_index) )
+                            l_complete = (l_found[j] = cache_find( l_sourcekey, l_targetkeys[j], l_size[j] )) && l_complete;
+                    
+                    if (!l_complete) {
+                        z_stream l_state;
+                        gzip_init( l_state, &l_pool );
+                        
+                        try {
+                            gzip_process( l_state, l_source.data(), l_source.size(), Z_NO_FLUSH );
+                            
+                            for(std::size_t j=0; j < l_targets.size(); ++j)
+                                if ( (!l_found[j]) && (!p_same || (j != l_index)) ) {
+                                    l_size[j] = snapshot_continue( l_state, l_targets[j].data(), l_targets[j].size() );
+                                    cache_insert( l_sourcekey, l_targetkeys[j], l_size[j] );
+                                }
+                        } catch (...) {
+                            deflateEnd( &l_state );
+                            throw;
+                        }
+                        
+                        deflateEnd( &l_state );
+                    }
+                    
+                    for(std::size_t j=0; j < l_targets.size(); ++j) {
+                        if ( p_same && (j == l_index) )
+                            continue;
+                        
+                        if (!p_symmetric) {
+                            p_result(l_index, j) = std::min( static_cast<T>(1), static_cast<T>(l_size[j] - std::min(l_sourcesize, l_targetsize(j))) / std::max(l_sourcesize, l_targetsize(j)) );
+                            continue;
+                        }
+                        
+                        // the half of the symmetric distance, the element is written by two sources
+                        const T l_min  = static_cast<T>(std::min(l_sourcesize, l_targetsize(j)));
+                        const T l_max  = static_cast<T>(std::max(l_sourcesize, l_targetsize(j)));
+                        const T l_half = static_cast<T>(0.5) * (l_size[j] - l_min) / l_max;
+                        T* const l_element = l_transposed ? &p_result(j, l_index) : (p_same ? &p_result(std::min(l_index, j), std::max(l_index, j)) : &p_result(l_index, j));
+                        
+                        #pragma omp atomic
+                        *l_element += l_half;
+                    }
+                } catch (const std::exception& l_exception) {
+                    #pragma omp critical(ncderror)
+                    if (l_error.empty())
+                        l_error = l_exception.what();
+                }
+        }
+        
+        if (!l_error.empty())
+            throw exception::runtime(l_error);
+        
+        if (!p_symmetric)
+            return;
+        
+        #pragma omp parallel for shared(p_result)
+        for(std::size_t i=0; i < p_rows.size(); ++i)
+            for(std::size_t j=(p_same ? i+1 : 0); j < p_columns.size(); ++j)
+                p_result(i, j) = std::min( static_cast<T>(1), p_result(i, j) );
+    }
+    
+    
+    /** copies the compressor state and finishes the compression with the second data
+     * @param p_state compressor state
+     * @param p_data second data (can be empty)
+     * @param p_size size of the second data
+     * @return number of bytes
+     **/
+    template<typename T> inline std::size_t ncd<T>::snapshot_continue( const z_stream& p_state, const char* p_data, const std::size_t& p_size ) const
+    {
+        z_stream l_state;
+        if (deflateCopy( &l_state, const_cast<z_stream*>(&p_state) ) != Z_OK)
+            throw exception::runtime(_("compressor state can not be copied"), *this);
+        
+        const int l_status       = gzip_process( l_state, p_data, p_size, Z_FINISH );
+        const std::size_t l_size = static_cast<std::size_t>(l_state.total_out);
+        deflateEnd( &l_state );
+        
+        if (l_status != Z_STREAM_END)
+            throw exception::runtime(_("compression failed"), *this);
+        
+        return l_size;
+    }
+    
+    
+    /** creates the content key of a data
+     * @param p_data data view
+     * @return key with FNV-1a hash, CRC32 and length
+     **/
+    template<typename T> inline typename ncd<T>::sizecache::key ncd<T>::content_key( const dataview& p_data ) const
+    {
+        typename sizecache::key l_key;
+        l_key.hash   = 14695981039346656037ULL;
+        l_key.crc    = crc32(0, Z_NULL, 0);
+        l_key.length = p_data.size();
+        
+        const unsigned char* l_data = reinterpret_cast<const unsigned char*>(p_data.data());
+        for(std::size_t i=0; i < p_data.size(); ++i)
+            l_key.hash = (l_key.hash ^ l_data[i]) * 1099511628211ULL;
+        
+        for(std::size_t i=0; i < p_data.size(); ) {
+            const std::size_t l_chunk = std::min( p_data.size() - i, static_cast<std::size_t>(std::numeric_limits<uInt>::max()) );
+            l_key.crc = crc32( static_cast<uLong>(l_key.crc), l_data+i, static_cast<uInt>(l_chunk) );
+            i += l_chunk;
+        }
+        
+        return l_key;
+    }
+    
+    
+    /** creates the key of the compressor settings
+     * @return key value
+     **/
+    template<typename T> inline boost::uint64_t ncd<T>::cache_settings( void ) const
+    {
+        return static_cast<boost::uint64_t>(m_compress) | 
+               (static_cast<boost::uint64_t>(m_gzipparam.level+1) << 8) | (static_cast<boost::uint64_t>(m_gzipparam.window_bits) << 16) |
+               (static_cast<boost::uint64_t>(m_gzipparam.mem_level) << 24) | (static_cast<boost::uint64_t>(m_gzipparam.strategy) << 32) | 
+               (static_cast<boost::uint64_t>(m_bzip2param.block_size) << 40) | (static_cast<boost::uint64_t>(m_bzip2param.work_factor) << 48) |
+               (static_cast<boost::uint64_t>(m_lzdepth) << 56);
+    }
+    
+    
+    /** reads a size from the cache
+     * @param p_first key of the first data
+     * @param p_second key of the second data
+     * @param p_size reference for the size, is set if the entry exists
+     * @return existance of the entry
+     **/
+    template<typename T> inline bool ncd<T>::cache_find( const typename sizecache::key& p_first, const typename sizecache::key& p_second, std::size_t& p_size ) const
+    {
+        if (!m_cache)
+            return false;
+        
+        typename sizecache::entry l_entry;
+        l_entry.first    = p_first;
+        l_entry.second   = p_second;
+        l_entry.settings = cache_settings();
+        
+        if (!m_cache->find(l_entry))
+            return false;
+        
+        p_size = static_cast<std::size_t>(l_entry.size);
+        return true;
+    }
+    
+    
+    /** adds a size to the cache
+     * @param p_first key of the first data
+     * @param p_second key of the second data
+     * @param p_size compressed size
+     **/
+    template<typename T> inline void ncd<T>::cache_insert( const typename sizecache::key& p_first, const typename sizecache::key& p_second, const std::size_t& p_size ) const
+    {
+        if (!m_cache)
+            return;
+        
+        typename sizecache::entry l_entry;
+        l_entry.first    = p_first;
+        l_entry.second   = p_second;
+        l_entry.settings = cache_settings();
+        l_entry.size     = p_size;
+        
+        m_cache->insert(l_entry);
+    }
+    
+    
+    /** deflates two data and uses the cache if it is enabled
+     * @param p_first key of the first data
+     * @param p_second key of the second data
+     * @param p_data1 first data
+     * @param p_data2 second data
+     * @return number of bytes
+     **/
+    template<typename T> inline std::size_t ncd<T>::cache_deflate( const typename sizecache::key& p_first, const typename sizecache::key& p_second, const dataview& p_data1, const dataview& p_data2 ) const
+    {
+        std::size_t l_size = 0;
+        if (cache_find(p_first, p_second, l_size))
+            return l_size;
+        
+        l_size = deflate( p_data1.data(), p_data1.size(), p_data2.data(), p_data2.size() );
+        cache_insert( p_first, p_second, l_size );
+        
+        return l_size;
+    }
+    
+    
+    /** compares the keys of two entries
+     * @param p_entry entry
+     * @return less flag
+     **/
+    template<typename T> inline bool ncd<T>::sizecache::entry::operator< ( const entry& p_entry ) const
+    {
+        const boost::uint64_t l_left[]  = { first.hash, first.crc, first.length, second.hash, second.crc, second.length, settings };
+        const boost::uint64_t l_right[] = { p_entry.first.hash, p_entry.first.crc, p_entry.first.length, p_entry.second.hash, p_entry.second.crc, p_entry.second.length, p_entry.settings };
+        
+        return std::lexicographical_compare( l_left, l_left+7, l_right, l_right+7 );
+    }
+    
+    
+    /** checks the equality of the keys of two entries
+     * @param p_entry entry
+     * @return equality flag
+     **/
+    template<typename T> inline bool ncd<T>::sizecache::entry::operator== ( const entry& p_entry ) const
+    {
+        return !((*this) < p_entry) && !(p_entry < (*this));
+    }
+    
+    
+    /** constructor of the cache
+     * @param p_file filename
+     * @param p_limit maximum number of new entries
+     **/
+    template<typename T> inline ncd<T>::sizecache::sizecache( const std::string& p_file, const std::size_t& p_limit ) :
+        m_filename( p_file ),
+        m_file(),
+        m_begin( NULL ),
+        m_end( NULL ),
+        m_new(),
+        m_limit( p_limit )
+    {
+        open();
+    }
+    
+    
+    /** destructor, that writes the new entries **/
+    template<typename T> inline ncd<T>::sizecache::~sizecache( void )
+    {
+        try {
+            flush();
+        } catch (...) {}
+    }
+    
+    
+    /** maps the cache file if it exists. The file contains an 8 byte header,
+     * the number of entries and the sorted entries
+     **/
+    template<typename T> inline void ncd<T>::sizecache::open( void )
+    {
+        m_begin = m_end = NULL;
+        if (m_file.is_open())
+            m_file.close();
+        
+        if (!std::ifstream(m_filename.c_str(), std::ios::binary).good())
+            return;
+        
+        try {
+            m_file.open( m_filename );
+        } catch (...) {
+            throw exception::runtime(_("cache file can not be opened"));
+        }
+        
+        boost::uint64_t l_count = 0;
+        if ( (m_file.size() < 8+sizeof(l_count)) || (std::memcmp(m_file.data(), "MLNCDSC1", 8) != 0) )
+            throw exception::runtime(_("cache file is not valid"));
+        
+        std::memcpy( &l_count, m_file.data()+8, sizeof(l_count) );
+        if (m_file.size() != 8+sizeof(l_count)+l_count*sizeof(entry))
+            throw exception::runtime(_("cache file is not valid"));
+        
+        m_begin = reinterpret_cast<const entry*>(m_file.data()+8+sizeof(l_count));
+        m_end   = m_begin + l_count;
+    }
+    
+    
+    /** searches an entry within the mapped file (the lookup is read-only, so
+     * it can be run concurrently)
+     * @param p_entry entry with key, the size is set if the entry exists
+     * @return existance of the entry
+     **/
+    template<typename T> inline bool ncd<T>::sizecache::find( entry& p_entry ) const
+    {
+        const entry* l_it = std::lower_bound( m_begin, m_end, p_entry );
+        if ( (l_it == m_end) || !((*l_it) == p_entry) )
+            return false;
+        
+        p_entry.size = l_it->size;
+        return true;
+    }
+    
+    
+    /** adds a new entry, the entry can be found after the next flush. If the
+     * maximum number of new entries is reached, the entry is discarded
+     * @param p_entry entry
+     **/
+    template<typename T> inline void ncd<T>::sizecache::insert( const entry& p_entry )
+    {
+        #pragma omp critical(ncdsizecache)
+        if (m_new.size() < m_limit)
+            m_new.push_back( p_entry );
+    }
+    
+    
+    /** removes the new entries, so they can be merged by another process
+     * @return new entries
+     **/
+    template<typename T> inline std::vector<typename ncd<T>::sizecache::entry> ncd<T>::sizecache::release( void )
+    {
+        std::vector<entry> l_entries;
+        l_entries.swap( m_new );
+        return l_entries;
+    }
+    
+    
+    /** merges the new entries into the file. The merge is written directly from the mapped
+     * file into a temporary file with an unique name, that replaces the old file by a rename,
+     * so the old file is valid until the new one is complete. Without force the file is written
+     * only, if the new entries are not less than the stored entries or the maximum is reached, so
+     * the file size is doubled on each write and the whole I/O is linear to the final size
+     * @param p_force write the new entries in any case
+     **/
+    template<typename T> inline void ncd<T>::sizecache::flush( const bool& p_force )
+    {
+        if ( m_new.empty() || (!p_force && (m_new.size() < static_cast<std::size_t>(m_end-m_begin)) && (m_new.size() < m_limit)) )
+            return;
+        
+        std::sort( m_new.begin(), m_new.end() );
+        m_new.erase( std::unique(m_new.begin(), m_new.end()), m_new.end() );
+        
+        const fsys::path l_temp = fsys::unique_path( m_filename + ".%%%%-%%%%-%%%%.tmp" );
+        {
+            std::ofstream l_file( l_temp.string().c_str(), std::ios::binary | std::ios::trunc );
+            boost::uint64_t l_count = 0;
+            
+            l_file.write( "MLNCDSC1", 8 );
+            l_file.write( reinterpret_cast<const char*>(&l_count), sizeof(l_count) );
+            
+            // merge of both sorted ranges, an existing entry is written only once
+            const entry* l_old = m_begin;
+            typename std::vector<entry>::const_iterator l_new = m_new.begin();
+            for( ; (l_old != m_end) || (l_new != m_new.end()); ++l_count) {
+                const entry* l_entry = NULL;
+                if ( (l_new == m_new.end()) || ((l_old != m_end) && ((*l_old) < (*l_new))) )
+                    l_entry = l_old++;
+                else {
+                    if ( (l_old != m_end) && ((*l_old) == (*l_new)) )
+                        ++l_old;
+                    l_entry = &(*l_new++);
+                }
+                
+                l_file.write( reinterpret_cast<const char*>(l_entry), sizeof(entry) );
+            }
+            
+            l_file.seekp( 8 );
+            l_file.write( reinterpret_cast<const char*>(&l_count), sizeof(l_count) );
+            l_file.close();
+            
+            if (l_file.fail()) {
+                std::remove( l_temp.string().c_str() );
+                throw exception::runtime(_("cache file can not be written"));
+            }
+        }
+        
+        // the mapping is closed before the rename, because some systems can not replace a mapped file
+        m_begin = m_end = NULL;
+        if (m_file.is_open())
+            m_file.close();
+        
+        try {
+            fsys::rename( l_temp, m_filename );
+        } catch (...) {
+            std::remove( l_temp.string().c_str() );
+            open();
+            throw exception::runtime(_("cache file can not be written"));
         }
-
-        // close deflate stream, cause only than counter returns correct value
-        bio::close(l_deflate);
         
-        return (static_cast<std::size_t>(l_counter.characters()) >= l_removesize) ? l_counter.characters()-l_removesize*sizeof(char) : l_counter.characters();
+        m_new.clear();
+        open();
     }
     
     
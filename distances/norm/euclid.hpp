@@ -28,6 +28,7 @@
 
 #include <boost/numeric/ublas/vector.hpp>
 #include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_sparse.hpp>
 #include <boost/numeric/bindings/blas.hpp>
 #include <boost/numeric/bindings/ublas/vector.hpp>
 #include <boost/numeric/bindings/ublas/matrix.hpp>
@@ -72,6 +73,9 @@ namespace machinelearning { namespace distances { namespace norm {
             T getDistance( const ublas::vector<T>&, const ublas::vector<T>& ) const;        
             ublas::vector<T> getDistance( const ublas::matrix<T>&, const ublas::vector<T>&, const tools::matrix::rowtype& = tools::matrix::row ) const;
             ublas::vector<T> getDistance( const ublas::matrix<T>&, const ublas::matrix<T>&, const tools::matrix::rowtype& = tools::matrix::row ) const;
+            #ifndef SWIG
+            ublas::vector<T> getDistance( const ublas::compressed_matrix<T>&, const ublas::vector<T>& ) const;
+            #endif
         
             #ifndef SWIG
             T getWeightedDistance( const ublas::vector<T>&, const ublas::vector<T>&, const ublas::vector<T>& ) const;        
@@ -292,6 +296,32 @@ namespace machinelearning { namespace distances { namespace norm {
     
     
     
+    /** calculates the distance between every row of the sparse matrix and the vector. Only the non-zero
+     * elements are used [ sqrt( norm(vector)^2 + sum_j ( matrix(i,j)^2 - 2 * matrix(i,j) * vector(j) ) ) ]
+     * @param p_data sparse matrix
+     * @param p_vec vector
+     * @return vector with distance values
+     **/
+    template<typename T> inline ublas::vector<T> euclid<T>::getDistance( const ublas::compressed_matrix<T>& p_data, const ublas::vector<T>& p_vec ) const
+    {
+        const T l_norm = ublas::inner_prod( p_vec, p_vec );
+        ublas::vector<T> l_vec( p_data.size1(), l_norm );
+        
+        for(typename ublas::compressed_matrix<T>::const_iterator1 it = p_data.begin1(); it != p_data.end1(); ++it) {
+            T l_sum = l_norm;
+            for(typename ublas::compressed_matrix<T>::const_iterator2 jt = it.begin(); jt != it.end(); ++jt)
+                l_sum += (*jt) * ((*jt) - 2 * p_vec(jt.index2()));
+            l_vec(it.index1()) = l_sum;
+        }
+        
+        for(std::size_t i=0; i < l_vec.size(); ++i)
+            l_vec(i) = std::sqrt( std::max(static_cast<T>(0), l_vec(i)) );
+        
+        return l_vec;
+    }
+    
+    
+    
     /** calculates the weighted distance between two vectors [ norm2(weight .* (vectorA - vectorB)) ]
      * @param p_first first vector
      * @param p_second second vector
@@ -24,6 +24,7 @@
 #include <cstdlib>
 #include <machinelearning.h>
 #include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/io.hpp>
 #include <boost/program_options/parsers.hpp>
 #include <boost/program_options/variables_map.hpp>
 #include <boost/program_options/options_description.hpp>
@@ -56,7 +57,7 @@ int main(int p_argc, char* p_argv[])
         ("outfile", po::value<std::string>(), "output HDF5 file")
         ("sources", po::value< std::vector<std::string> >()->multitoken(), "list of text files or directories with text files (all files in the directory will be read and subdirectories will be ignored)")
         ("compress", po::value<std::string>(&l_compress)->default_value("default"), "compression level (allowed values are: default [default], bestspeed or bestcompression)")
-        ("algorithm", po::value<std::string>(&l_algorithm)->default_value("gzip"), "compression algorithm (allowed values are: gzip [default], bzip)")
+        ("algorithm", po::value<std::string>(&l_algorithm)->default_value("gzip"), "compression algorithm (allowed values are: gzip [default], bzip, lz)")
         ("matrix", po::value<std::string>(&l_matrix)->default_value("symmetric"), "structure of the matrix (allowed values are: symmetric [default] or unsymmetric")
     ;
 
@@ -78,7 +79,12 @@ int main(int p_argc, char* p_argv[])
 
 
     // create ncd object
-    distances::ncd<double> l_ncd( (l_algorithm == "gzip") ? distances::ncd<double>::gzip : distances::ncd<double>::bzip2 );
+    distances::ncd<double>::compresstype l_type = distances::ncd<double>::gzip;
+    if (l_algorithm == "bzip")
+        l_type = distances::ncd<double>::bzip2;
+    if (l_algorithm == "lz")
+        l_type = distances::ncd<double>::lz;
+    distances::ncd<double> l_ncd( l_type );
     if (l_compress == "bestspeed")
         l_ncd.setCompressionLevel( distances::ncd<double>::bestspeed );
     if (l_compress == "bestcompression")
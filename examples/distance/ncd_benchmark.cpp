@@ -0,0 +1,183 @@
+/**
+ @cond
+ ############################################################################
+ # LGPL License                                                             #
+ #                                                                          #
+ # This file is part of the Machine Learning Framework.                     #
+ # Copyright (c) 2010-2012, Philipp Kraus, <philipp.kraus@flashpixx.de>     #
+ # This program is free software: you can redistribute it and/or modify     #
+ # it under the terms of the GNU Lesser General Public License as           #
+ # published by the Free Software Foundation, either version 3 of the       #
+ # License, or (at your option) any later version.                          #
+ #                                                                          #
+ # This program is distributed in the hope that it will be useful,          #
+ # but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+ # MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+ # GNU Lesser General Public License for more details.                      #
+ #                                                                          #
+ # You should have received a copy of the GNU Lesser General Public License #
+ # along with this program. If not, see <http://www.gnu.org/licenses/>.     #
+ ############################################################################
+ @endcond
+ **/
+
+#include <cstdlib>
+#include <omp.h>
+#include <machinelearning.h>
+#include <boost/filesystem.hpp>
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/program_options/parsers.hpp>
+#include <boost/program_options/variables_map.hpp>
+#include <boost/program_options/options_description.hpp>
+
+
+namespace po = boost::program_options;
+using namespace boost::numeric;
+using namespace machinelearning;
+
+
+/** main program, that compares the compression algorithms of the NCD. Each source directory
+ * is one class, the throughput is measured in pairs per second and the clustering quality is
+ * measured with the purity of a relational neural gas and the leave-one-out 1-nearest-neighbour
+ * accuracy
+ * @param p_argc number of arguments
+ * @param p_argv arguments
+ **/
+int main(int p_argc, char* p_argv[])
+{
+    #ifdef MACHINELEARNING_MULTILANGUAGE
+    tools::language::bindings::bind();
+    #endif
+    
+    // default values
+    std::string l_compress;
+    std::size_t l_iteration;
+    
+    // create CML options with description
+    po::options_description l_description("allowed options");
+    l_description.add_options()
+        ("help", "produce help message")
+        ("sources", po::value< std::vector<std::string> >()->multitoken(), "list of directories with text files (each directory is one class, subdirectories will be ignored)")
+        ("algorithm", po::value< std::vector<std::string> >()->multitoken(), "list of compression algorithms (allowed values are: gzip, bzip, lz [default all])")
+        ("compress", po::value<std::string>(&l_compress)->default_value("default"), "compression level (allowed values are: default [default], bestspeed or bestcompression)")
+        ("iteration", po::value<std::size_t>(&l_iteration)->default_value(15), "number of iterations of the relational neural gas [default 15]")
+    ;
+    
+    po::variables_map l_map;
+    po::positional_options_description l_input;
+    po::store(po::command_line_parser(p_argc, p_argv).options(l_description).positional(l_input).run(), l_map);
+    po::notify(l_map);
+    
+    if (l_map.count("help")) {
+        std::cout << l_description << std::endl;
+        return EXIT_SUCCESS;
+    }
+    
+    if (!l_map.count("sources"))  {
+        std::cerr << "[--sources] must be set" << std::endl;
+        return EXIT_FAILURE;
+    }
+    
+    
+    
+    // read the files and set the directory index as label
+    std::vector<std::string> l_files;
+    std::vector<std::size_t> l_labels;
+    const std::vector<std::string> l_sources = l_map["sources"].as< std::vector<std::string> >();
+    for(std::size_t i=0; i < l_sources.size(); ++i) {
+        if (!boost::filesystem::is_directory(l_sources[i])) {
+            std::cerr << "[" << l_sources[i] << "] is not a directory" << std::endl;
+            return EXIT_FAILURE;
+        }
+        
+        std::vector<boost::filesystem::path> l_subdata;
+        std::copy(boost::filesystem::directory_iterator(l_sources[i]), boost::filesystem::directory_iterator(), back_inserter(l_subdata));
+        for(std::size_t j=0; j < l_subdata.size(); ++j)
+            if ( (boost::filesystem::is_regular_file(l_subdata[j])) && (boost::filesystem::file_size(l_subdata[j]) > 0) ) {
+                l_files.push_back(l_subdata[j].generic_string());
+                l_labels.push_back(i);
+            }
+    }
+    
+    if (l_files.size() < 2) {
+        std::cerr << "at least two files are needed" << std::endl;
+        return EXIT_FAILURE;
+    }
+    
+    std::vector<std::string> l_algorithm;
+    if (l_map.count("algorithm"))
+        l_algorithm = l_map["algorithm"].as< std::vector<std::string> >();
+    else {
+        l_algorithm.push_back("gzip");
+        l_algorithm.push_back("bzip");
+        l_algorithm.push_back("lz");
+    }
+    
+    
+    
+    std::cout << "files: " << l_files.size() << "\tclasses: " << l_sources.size() << "\tpairs: " << l_files.size() * (l_files.size()-1) << std::endl << std::endl;
+    std::cout << "algorithm\tseconds\t\tpairs/sec\tpurity\t\t1-NN accuracy" << std::endl;
+    
+    for(std::size_t n=0; n < l_algorithm.size(); ++n) {
+        
+        // create ncd object
+        distances::ncd<double>::compresstype l_type = distances::ncd<double>::gzip;
+        if (l_algorithm[n] == "bzip")
+            l_type = distances::ncd<double>::bzip2;
+        else if (l_algorithm[n] == "lz")
+            l_type = distances::ncd<double>::lz;
+        else if (l_algorithm[n] != "gzip") {
+            std::cerr << "algorithm [" << l_algorithm[n] << "] is unknown" << std::endl;
+            return EXIT_FAILURE;
+        }
+        
+        distances::ncd<double> l_ncd( l_type );
+        if (l_compress == "bestspeed")
+            l_ncd.setCompressionLevel( distances::ncd<double>::bestspeed );
+        if (l_compress == "bestcompression")
+            l_ncd.setCompressionLevel( distances::ncd<double>::bestcompression );
+        
+        
+        // the symmetric matrix compresses each ordered pair
+        const double l_start = omp_get_wtime();
+        const ublas::matrix<double> l_distance = l_ncd.symmetric( l_files, true );
+        const double l_time = omp_get_wtime() - l_start;
+        
+        
+        // purity of the relational neural gas clustering (one prototype for each class)
+        clustering::nonsupervised::relational_neuralgas<double> l_ng( l_sources.size(), l_distance.size2() );
+        l_ng.train( l_distance, l_iteration );
+        const ublas::indirect_array<> l_cluster = l_ng.use( l_distance );
+        
+        ublas::matrix<std::size_t> l_count( l_sources.size(), l_sources.size(), 0 );
+        for(std::size_t i=0; i < l_files.size(); ++i)
+            l_count(l_cluster(i), l_labels[i])++;
+        
+        std::size_t l_purity = 0;
+        for(std::size_t i=0; i < l_count.size1(); ++i) {
+            std::size_t l_max = 0;
+            for(std::size_t j=0; j < l_count.size2(); ++j)
+                l_max = std::max(l_max, l_count(i, j));
+            l_purity += l_max;
+        }
+        
+        
+        // leave-one-out nearest neighbour
+        std::size_t l_correct = 0;
+        for(std::size_t i=0; i < l_files.size(); ++i) {
+            std::size_t l_nearest = (i == 0) ? 1 : 0;
+            for(std::size_t j=0; j < l_files.size(); ++j)
+                if ( (i != j) && (l_distance(i, j) < l_distance(i, l_nearest)) )
+                    l_nearest = j;
+            
+            if (l_labels[i] == l_labels[l_nearest])
+                l_correct++;
+        }
+        
+        
+        std::cout << l_algorithm[n] << "\t\t" << l_time << "\t\t" << l_files.size() * (l_files.size()-1) / l_time << "\t\t" 
+                  << static_cast<double>(l_purity) / l_files.size() << "\t\t" << static_cast<double>(l_correct) / l_files.size() << std::endl;
+    }
+    
+    return EXIT_SUCCESS;
+}
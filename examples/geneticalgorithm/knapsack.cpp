@@ -30,12 +30,20 @@
 #include <boost/program_options/variables_map.hpp>
 #include <boost/program_options/options_description.hpp>
 
+#ifdef MACHINELEARNING_MPI
+#include <boost/mpi.hpp>
+#endif
+
 
 namespace po        = boost::program_options;
 namespace ublas     = boost::numeric::ublas;
 namespace tools     = machinelearning::tools;
 namespace ga        = machinelearning::geneticalgorithm;
 
+#ifdef MACHINELEARNING_MPI
+namespace mpi       = boost::mpi;
+#endif
+
 
 /** @cond
  fitness function for determine the binary packing **/
@@ -47,10 +55,21 @@ template<typename T, typename L> class fitness : public ga::fitness::fitness<T,L
 
         T getFitness( const ga::individual::individual<L>& p_ind )
         {
-            // simple fitness function: sum over the set weights
+            // simple fitness function: sum over the set weights, on binary individuals
+            // we run over the words and skip the blocks without set bits
             T l_sum = 0;
-            for(std::size_t i=0; i < m_weight.size(); ++i)
-                l_sum += m_weight(i) * p_ind[i];
+            const ga::individual::binaryindividual<L>* l_binary = dynamic_cast< const ga::individual::binaryindividual<L>* >( &p_ind );
+            
+            if (l_binary) {
+                const std::vector<boost::uint64_t>& l_words = l_binary->getWords();
+                for(std::size_t i=0; i < l_words.size(); ++i)
+                    if (l_words[i])
+                        for(std::size_t j=0; j < 64; ++j)
+                            if ((l_words[i] >> j) & 1)
+                                l_sum += m_weight(i * 64 + j);
+            } else
+                for(std::size_t i=0; i < m_weight.size(); ++i)
+                    l_sum += m_weight(i) * p_ind[i];
 
             m_optimum = tools::function::isNumericalEqual(l_sum, m_max);
             return l_sum > m_max ? 0.0 : l_sum;
@@ -85,6 +104,11 @@ template<typename T, typename L> class fitness : public ga::fitness::fitness<T,L
  **/
 int main(int p_argc, char* p_argv[])
 {
+    #ifdef MACHINELEARNING_MPI
+    mpi::environment l_mpienv(p_argc, p_argv);
+    mpi::communicator l_mpicom;
+    #endif
+    
     #ifdef MACHINELEARNING_MULTILANGUAGE
     tools::language::bindings::bind();
     #endif
@@ -106,9 +130,14 @@ int main(int p_argc, char* p_argv[])
         ("population", po::value<std::size_t>(&l_populationsize)->default_value(100), "population size / number of individuals")
         ("elite", po::value<std::size_t>(&l_elitesize)->default_value(5), "elite size / number of individuals that are elite")
         ("crossover", po::value<std::size_t>(&l_cuts)->default_value(2), "cut point of the crossover")
-        ("selection", po::value< std::vector<std::string> >()->multitoken(), "type of selection (values: bestof <number = 3> [default], roulette)")
+        ("selection", po::value< std::vector<std::string> >()->multitoken(), "type of selection (values: bestof <number = 3> [default], roulette, alias, sus, tournament <number = 3>)")
         ("iteration", po::value<std::size_t>(&l_iteration)->default_value(25), "number of iterations")
         ("mutation", po::value<double>(&l_mutation)->default_value(0.65), "mutation probability")
+        ("arena", "uses two preallocated generations instead of creating new individuals on each crossover")
+        ("cache", po::value<std::size_t>(), "capacity of the fitness cache")
+        #ifdef MACHINELEARNING_MPI
+        ("migration", po::value< std::vector<std::string> >()->multitoken(), "island migration: <number of iterations between migrations> <number of individuals> [ring (default) | random]")
+        #endif
     ;
 
     po::variables_map l_map;
@@ -138,7 +167,7 @@ int main(int p_argc, char* p_argv[])
     if ( (l_map.count("selection")) && (l_map["selection"].as< std::vector<std::string> >().size() > 0) ) {
         l_selectionopt = l_map["selection"].as< std::vector<std::string> >()[0];
 
-        if ((l_selectionopt == "bestof") && (l_map["selection"].as< std::vector<std::string> >().size() > 1))
+        if (((l_selectionopt == "bestof") || (l_selectionopt == "tournament")) && (l_map["selection"].as< std::vector<std::string> >().size() > 1))
             l_selectionnumber = boost::lexical_cast<std::size_t>(l_map["selection"].as< std::vector<std::string> >()[1]);
     }
 
@@ -159,6 +188,15 @@ int main(int p_argc, char* p_argv[])
 
     if (l_selectionopt == "roulette")
         l_selection = new ga::selection::roulettewheel<double,unsigned char>();
+    
+    if (l_selectionopt == "alias")
+        l_selection = new ga::selection::alias<double,unsigned char>();
+    
+    if (l_selectionopt == "sus")
+        l_selection = new ga::selection::stochasticuniversal<double,unsigned char>();
+    
+    if (l_selectionopt == "tournament")
+        l_selection = new ga::selection::tournament<double,unsigned char>(l_selectionnumber);
 
     if ( (l_selectionopt == "bestof") || (!l_selection) )
         l_selection = new ga::selection::bestof<double,unsigned char>(l_selectionnumber);
@@ -169,14 +207,37 @@ int main(int p_argc, char* p_argv[])
     ga::population<double,unsigned char> l_population(l_individual, l_populationsize, l_elitesize);
 
     l_population.setMutalProbability( l_map["mutation"].as<double>() );
+    if (l_map.count("arena"))
+        l_population.setStorage( ga::population<double,unsigned char>::arena );
+    if (l_map.count("cache"))
+        l_population.setFitnessCache( l_map["cache"].as<std::size_t>() );
+    
+    #ifdef MACHINELEARNING_MPI
+    if ( (l_map.count("migration")) && (l_map["migration"].as< std::vector<std::string> >().size() > 1) ) {
+        const std::vector<std::string> l_migration = l_map["migration"].as< std::vector<std::string> >();
+        l_population.setMigration( 
+                                  boost::lexical_cast<std::size_t>(l_migration[0]), 
+                                  boost::lexical_cast<std::size_t>(l_migration[1]), 
+                                  ((l_migration.size() > 2) && (l_migration[2] == "random")) ? ga::population<double,unsigned char>::randomring : ga::population<double,unsigned char>::ring
+                                 );
+    }
+    l_population.iterate( l_mpicom, l_iteration, l_fitness, *l_selection, l_crossover );
+    #else
     l_population.iterate( l_iteration, l_fitness, *l_selection, l_crossover );
+    #endif
 
     delete l_selection;
+    if (l_map.count("cache"))
+        std::cout << "fitness cache hits: " << l_population.getFitnessCacheHits() << "\tmisses: " << l_population.getFitnessCacheMisses() << std::endl;
     const std::vector< boost::shared_ptr< ga::individual::individual<unsigned char> > > l_elite = l_population.getElite();
 
 
 
     // create output
+    #ifdef MACHINELEARNING_MPI
+    if (l_mpicom.rank() == 0) {
+    #endif
+    
     std::cout << "best packing options with pack / position values [ value, value, ... ] (position starts with one):" << std::endl;
 
     for(std::size_t i=0; i < l_elite.size(); ++i) {
@@ -202,6 +263,10 @@ int main(int p_argc, char* p_argv[])
 
         std::cout << (i+1) << ".\tpack value: " << l_sum << " = [" << l_packvalue.str() << "]\t\tposition: [" << l_pos.str() << "]" << std::endl;
     }
+    
+    #ifdef MACHINELEARNING_MPI
+    }
+    #endif
 
 
     return EXIT_SUCCESS;
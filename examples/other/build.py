@@ -26,6 +26,8 @@ Import("*")
 
 buildlist = []
 
+buildlist.append( env.Program( target=os.path.join("#build", env["buildtype"], "other", "stopword_benchmark"), source=defaultcpp+["stopword_benchmark.cpp"] ) )
+
 if env["withfiles"] :
     buildlist.append( env.Program( target=os.path.join("#build", env["buildtype"], "other", "mds_file"), source=defaultcpp+["mds_file.cpp"] ) )
 
@@ -175,6 +175,39 @@ void getArticles( tools::sources::nntp& p_nntp, const std::size_t& p_numarticles
 
 
 
+/** distance callback for the landmark projection, that calculates
+ * the normalized compression distance between two articles
+**/
+class articledistance
+{
+    public :
+
+        /** constructor
+         * @param p_ncd ncd object
+         * @param p_article article vector
+        **/
+        articledistance( const distances::ncd<double>& p_ncd, const std::vector<std::string>& p_article ) : m_ncd( p_ncd ), m_article( p_article ) {}
+
+        /** returns the distance between two articles
+         * @param p_first index of the first article
+         * @param p_second index of the second article
+         * @return distance
+        **/
+        double operator()( const std::size_t& p_first, const std::size_t& p_second ) const
+        {
+            return (p_first == p_second) ? 0 : m_ncd.calculate( m_article[p_first], m_article[p_second] );
+        }
+
+    private :
+
+        /** ncd object **/
+        const distances::ncd<double>& m_ncd;
+        /** article vector **/
+        const std::vector<std::string>& m_article;
+};
+
+
+
 /** main program, that reads a subset of newsgroup articles, calculate the distance between articles
  * and create the plot via MDS.
  * @param p_argc number of arguments
@@ -194,6 +227,7 @@ int main(int p_argc, char* p_argv[])
     // default values
     std::size_t l_dimension;
     std::size_t l_iteration;
+    std::size_t l_landmarks;
     double l_rate;
     std::string l_compress;
     std::string l_algorithm;
@@ -217,7 +251,8 @@ int main(int p_argc, char* p_argv[])
         ("compress", po::value<std::string>(&l_compress)->default_value("default"), "compression level (allowed values are: default [default], bestspeed or bestcompression)")
         ("algorithm", po::value<std::string>(&l_algorithm)->default_value("gzip"), "compression algorithm (allowed values are: gzip [default], bzip)")
         ("iteration", po::value<std::size_t>(&l_iteration)->default_value(0), "number of iterations (detected automatically)")
-        ("mapping", po::value<std::string>(&l_mapping)->default_value("hit"), "mapping type (values: metric, sammon, hit [default])")
+        ("mapping", po::value<std::string>(&l_mapping)->default_value("hit"), "mapping type (values: metric, sammon, hit [default], landmark (only without MPI))")
+        ("landmarks", po::value<std::size_t>(&l_landmarks)->default_value(50), "number of landmarks for landmark mapping (default 50)")
         ("stopword", po::value< std::vector<double> >()->multitoken(), "minimal and maximal value of the stopword reduction (value within the range [0,1])")
     ;
 
@@ -310,9 +345,10 @@ int main(int p_argc, char* p_argv[])
     #ifdef MACHINELEARNING_MPI
     ublas::matrix<double> l_distancematrix = l_ncd.unsquare( l_mpicom, l_article );
     #else
-    ublas::matrix<double> l_distancematrix = l_ncd.unsymmetric( l_article );
+    ublas::matrix<double> l_distancematrix;
+    if (l_mapping != "landmark")
+        l_distancematrix = l_ncd.unsymmetric( l_article );
     #endif
-    l_article.clear();
 
 
 
@@ -329,20 +365,26 @@ int main(int p_argc, char* p_argv[])
         l_project = dim::mds<double>::metric;
     if (l_mapping == "sammon")
         l_project = dim::mds<double>::sammon;
+    if (l_mapping == "landmark")
+        l_project = dim::mds<double>::landmark;
 
     dim::mds<double> l_mds( l_dimension, l_project );
     if (l_iteration == 0)
-        l_mds.setIteration( l_distancematrix.size2() );
+        l_mds.setIteration( l_article.size() );
     else
         l_mds.setIteration( l_iteration );
     l_mds.setRate( l_rate );
+    if (l_project == dim::mds<double>::landmark)
+        l_mds.setLandmarks( l_landmarks );
 
     
     #ifdef MACHINELEARNING_MPI
     ublas::matrix<double> l_projectdata = l_mds.map( l_mpicom, l_distancematrix );
     #else
-    ublas::matrix<double> l_projectdata = l_mds.map( l_distancematrix );
+    // the landmark projection calculates only the distances to the landmarks
+    ublas::matrix<double> l_projectdata = (l_project == dim::mds<double>::landmark) ? l_mds.map( l_article.size(), articledistance(l_ncd, l_article) ) : l_mds.map( l_distancematrix );
     #endif
+    l_article.clear();
 
 
     
@@ -0,0 +1,175 @@
+/**
+ @cond
+ ############################################################################
+ # LGPL License                                                             #
+ #                                                                          #
+ # This file is part of the Machine Learning Framework.                     #
+ # Copyright (c) 2010-2012, Philipp Kraus, <philipp.kraus@flashpixx.de>     #
+ # This program is free software: you can redistribute it and/or modify     #
+ # it under the terms of the GNU Lesser General Public License as           #
+ # published by the Free Software Foundation, either version 3 of the       #
+ # License, or (at your option) any later version.                          #
+ #                                                                          #
+ # This program is distributed in the hope that it will be useful,          #
+ # but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+ # MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+ # GNU Lesser General Public License for more details.                      #
+ #                                                                          #
+ # You should have received a copy of the GNU Lesser General Public License #
+ # along with this program. If not, see <http://www.gnu.org/licenses/>.     #
+ ############################################################################
+ @endcond
+ **/
+
+#include <cstdlib>
+#include <fstream>
+#include <omp.h>
+#include <machinelearning.h>
+#include <boost/filesystem.hpp>
+#include <boost/program_options/parsers.hpp>
+#include <boost/program_options/variables_map.hpp>
+#include <boost/program_options/options_description.hpp>
+
+
+namespace po    = boost::program_options;
+namespace text  = machinelearning::textprocess;
+
+
+/** main program, that compares the hash table and the regular expression engine
+ * of the stop-word-reduction. The stop words are read from a file (one word per line)
+ * or are created with the term frequency of the texts
+ * @param p_argc number of arguments
+ * @param p_argv arguments
+ **/
+int main(int p_argc, char* p_argv[])
+{
+    #ifdef MACHINELEARNING_MULTILANGUAGE
+    machinelearning::tools::language::bindings::bind();
+    #endif
+    
+    // default values
+    std::size_t l_repeat;
+    
+    // create CML options with description
+    po::options_description l_description("allowed options");
+    l_description.add_options()
+        ("help", "produce help message")
+        ("sources", po::value< std::vector<std::string> >()->multitoken(), "list of text files or directories with text files")
+        ("stopwordfile", po::value<std::string>(), "file with stop words (one word per line)")
+        ("stopword", po::value< std::vector<double> >()->multitoken(), "frequency bounds of the stop words if no stop word file is set, words with a frequency lower-equal the first or greater-equal the second value are used [default 0.00005 0.005]")
+        ("casesensitive", "stop words are case-sensitive")
+        ("repeat", po::value<std::size_t>(&l_repeat)->default_value(3), "number of repeats of each engine [default 3]")
+    ;
+    
+    po::variables_map l_map;
+    po::positional_options_description l_input;
+    po::store(po::command_line_parser(p_argc, p_argv).options(l_description).positional(l_input).run(), l_map);
+    po::notify(l_map);
+    
+    if (l_map.count("help")) {
+        std::cout << l_description << std::endl;
+        return EXIT_SUCCESS;
+    }
+    
+    if (!l_map.count("sources"))  {
+        std::cerr << "[--sources] must be set" << std::endl;
+        return EXIT_FAILURE;
+    }
+    
+    
+    
+    // read the file content
+    std::vector<std::string> l_content;
+    std::size_t l_bytes = 0;
+    const std::vector<std::string> l_sources = l_map["sources"].as< std::vector<std::string> >();
+    for(std::size_t i=0; i < l_sources.size(); ++i) {
+        std::vector<boost::filesystem::path> l_files;
+        if (boost::filesystem::is_directory(l_sources[i]))
+            std::copy(boost::filesystem::directory_iterator(l_sources[i]), boost::filesystem::directory_iterator(), back_inserter(l_files));
+        else
+            l_files.push_back(l_sources[i]);
+        
+        for(std::size_t j=0; j < l_files.size(); ++j) {
+            if (!boost::filesystem::is_regular_file(l_files[j]))
+                continue;
+            
+            std::ifstream l_file(l_files[j].generic_string().c_str(), std::ifstream::in | std::ifstream::binary);
+            std::stringbuf l_str;
+            l_file >> &l_str;
+            
+            l_content.push_back( l_str.str() );
+            l_bytes += l_content.back().size();
+        }
+    }
+    
+    if (l_content.empty()) {
+        std::cerr << "no text files are found" << std::endl;
+        return EXIT_FAILURE;
+    }
+    
+    
+    // read or create the stop words
+    const bool l_caseinsensitive = !l_map.count("casesensitive");
+    std::vector<std::string> l_stopwords;
+    if (l_map.count("stopwordfile")) {
+        std::ifstream l_file(l_map["stopwordfile"].as<std::string>().c_str(), std::ifstream::in);
+        for(std::string l_line; std::getline(l_file, l_line); )
+            if (!l_line.empty())
+                l_stopwords.push_back( l_line );
+    } else {
+        std::vector<double> l_range;
+        if (l_map.count("stopword"))
+            l_range = l_map["stopword"].as< std::vector<double> >();
+        if (l_range.size() < 2) {
+            l_range.clear();
+            l_range.push_back(0.00005);
+            l_range.push_back(0.005);
+        }
+        
+        text::termfrequency l_tfc( ",;.:!?- \n\t|=", "#_()[]{}%$*/\\\"=|<>\r", l_caseinsensitive );
+        l_tfc.add( l_content );
+        l_stopwords = l_tfc.getTerms( static_cast<float>(l_range[0]), static_cast<float>(l_range[1]) );
+    }
+    
+    if (l_stopwords.empty()) {
+        std::cerr << "stop word list is empty" << std::endl;
+        return EXIT_FAILURE;
+    }
+    
+    
+    
+    std::cout << "texts: " << l_content.size() << "\tbytes: " << l_bytes << "\tstop words: " << l_stopwords.size() << std::endl << std::endl;
+    std::cout << "engine\t\tconstruct sec\tremove sec\tMB/sec" << std::endl;
+    
+    std::vector<std::string> l_result[2];
+    const char* l_name[2] = { "hashtable", "regex" };
+    const text::stopwordreduction::engine l_engine[2] = { text::stopwordreduction::hashtable, text::stopwordreduction::regex };
+    
+    for(std::size_t n=0; n < 2; ++n) {
+        
+        double l_time = omp_get_wtime();
+        const text::stopwordreduction l_stopword( l_stopwords, l_caseinsensitive, l_engine[n] );
+        const double l_construct = omp_get_wtime() - l_time;
+        
+        l_time = omp_get_wtime();
+        for(std::size_t r=0; r < std::max(static_cast<std::size_t>(1), l_repeat); ++r) {
+            l_result[n].clear();
+            for(std::size_t i=0; i < l_content.size(); ++i)
+                l_result[n].push_back( l_stopword.remove(l_content[i]) );
+        }
+        const double l_remove = (omp_get_wtime() - l_time) / std::max(static_cast<std::size_t>(1), l_repeat);
+        
+        std::cout << l_name[n] << "\t" << l_construct << "\t" << l_remove << "\t" << (l_bytes / 1048576.0) / l_remove << std::endl;
+    }
+    
+    
+    // both engines must create the same output
+    std::size_t l_diff = 0;
+    for(std::size_t i=0; i < l_content.size(); ++i)
+        if (l_result[0][i] != l_result[1][i])
+            l_diff++;
+    
+    std::cout << std::endl << "texts with different output: " << l_diff << std::endl;
+    
+    return l_diff == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
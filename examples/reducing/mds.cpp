@@ -54,6 +54,7 @@ int main(int p_argc, char* p_argv[])
     std::string l_center;
     std::string l_mapping;
     double l_rate;
+    double l_tolerance;
 
     // create CML options with description
     po::options_description l_description("allowed options");
@@ -63,11 +64,12 @@ int main(int p_argc, char* p_argv[])
         ("inpath", po::value<std::string>(), "input path of the datapoint within the input file")
         ("outfile", po::value<std::string>(), "output HDF5 file")
         ("outpath", po::value<std::string>(&l_outpath)->default_value("/mds"), "output path within the HDF5 file [default: /mds]")
-        ("mapping", po::value<std::string>(&l_mapping)->default_value("metric"), "mapping type (values: metric [default], sammon, hit)")
+        ("mapping", po::value<std::string>(&l_mapping)->default_value("metric"), "mapping type (values: metric [default], sammon, hit, smacof)")
         ("dimension", po::value<std::size_t>(&l_dimension)->default_value(3), "target dimension [default: 3]")
-        ("iteration", po::value<std::size_t>(&l_iteration)->default_value(100), "iterations for sammon / hit mapping [default: 100]")
+        ("iteration", po::value<std::size_t>(&l_iteration)->default_value(100), "iterations for sammon / hit / smacof mapping [default: 100]")
         ("step", po::value<std::size_t>(&l_step)->default_value(20), "step size for sammon mapping [default: 20]")
         ("rate", po::value<double>(&l_rate)->default_value(1), "rate for hit mapping [default: 1]")
+        ("tolerance", po::value<double>(&l_tolerance)->default_value(1e-6), "relative stress tolerance for smacof mapping [default: 1e-6]")
         ("center", po::value<std::string>(&l_center)->default_value("none"), "centering the data (values: none [default], single, double)")
     ;
 
@@ -92,11 +94,12 @@ int main(int p_argc, char* p_argv[])
     tools::files::hdf l_source( l_map["infile"].as<std::string>() );
 
     // create mds object and map the data
-    dim::mds<double> l_mds( l_dimension, (l_mapping == "metric") ? dim::mds<double>::metric : (l_mapping == "sammon") ? dim::mds<double>::sammon : dim::mds<double>::hit );
+    dim::mds<double> l_mds( l_dimension, (l_mapping == "metric") ? dim::mds<double>::metric : (l_mapping == "sammon") ? dim::mds<double>::sammon : (l_mapping == "smacof") ? dim::mds<double>::smacof : dim::mds<double>::hit );
 
     l_mds.setIteration( l_iteration );
     l_mds.setStep( l_step );
     l_mds.setRate( l_rate );
+    l_mds.setTolerance( l_tolerance );
 
     if (l_center == "single")
         l_mds.setCentering( dim::mds<double>::singlecenter );
@@ -53,6 +53,8 @@ namespace machinelearning { namespace geneticalgorithm { namespace crossover {
              **/
             virtual boost::shared_ptr< individual::individual<T> > combine( void ) = 0;
         
+            virtual void combine( individual::individual<T>& );
+        
             /** method for cloning the object, for using on multithread
              * @param p_ptr smart-pointer object
              **/
@@ -64,6 +66,21 @@ namespace machinelearning { namespace geneticalgorithm { namespace crossover {
             virtual void onEachIteration( const std::vector< boost::shared_ptr< individual::individual<T> > >& p_population ) = 0;
     };
     
+    
+    
+    /** writes the new individual data into an existing individual, the population calls this method
+     * on its arena storage. The default implementation creates a new individual and copies the values,
+     * so crossover objects should overwrite it to get an allocation-free combination
+     * @param p_target individual that is overwritten
+     **/
+    template<typename T> inline void crossover<T>::combine( individual::individual<T>& p_target )
+    {
+        const boost::shared_ptr< individual::individual<T> > l_new = combine();
+        
+        for(std::size_t i=0; i < p_target.size(); ++i)
+            p_target.set( i, (*l_new)[i] );
+    }
+    
 }}}
 #endif
 
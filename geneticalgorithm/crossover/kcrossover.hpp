@@ -27,9 +27,11 @@
 
 #include <boost/static_assert.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/type_traits.hpp>
 
 #include "crossover.hpp"
 #include "../individual/individual.hpp"
+#include "../individual/binaryindividual.hpp"
 #include "../../errorhandling/exception.hpp"
 #include "../../tools/tools.h"
 
@@ -46,6 +48,7 @@ namespace machinelearning { namespace geneticalgorithm { namespace crossover {
             void clone( boost::shared_ptr< crossover<T> >& ) const;
             std::size_t getNumberOfIndividuals( void ) const;    
             boost::shared_ptr< individual::individual<T> > combine( void );
+            void combine( individual::individual<T>& );
             void setIndividual( const boost::shared_ptr< individual::individual<T> >& );
             
             void onEachIteration( const std::vector< boost::shared_ptr< individual::individual<T> > >& ) {}
@@ -59,6 +62,12 @@ namespace machinelearning { namespace geneticalgorithm { namespace crossover {
             const std::size_t m_cuts;
             /** list with elements **/
             std::vector< boost::shared_ptr< individual::individual<T> > > m_individuals;
+        
+            /** flag that the gene type can be used by the binary individual **/
+            typedef boost::integral_constant<bool, boost::is_integral<T>::value && boost::is_unsigned<T>::value> isbinary;
+        
+            bool copy( individual::individual<T>&, const std::size_t&, const std::size_t&, const std::size_t&, const boost::true_type& ) const;
+            bool copy( individual::individual<T>&, const std::size_t&, const std::size_t&, const std::size_t&, const boost::false_type& ) const { return false; }
     };
 
     
@@ -114,23 +123,51 @@ namespace machinelearning { namespace geneticalgorithm { namespace crossover {
         // we create a new individual and overwrite the parameter data
         boost::shared_ptr< individual::individual<T> > l_new;
         m_individuals[0]->clone( l_new );
-
-        // create crossover parts and add them to the new individual
+        
+        combine( *l_new );
+        return l_new;
+    }
+    
+    
+    /** writes the child of the elements into an existing individual
+     * @param p_target individual that is overwritten
+     **/
+    template<typename T> inline void kcrossover<T>::combine( individual::individual<T>& p_target )
+    {
+        // create crossover parts and add them to the target individual
         std::size_t l_pos = 0;
-        for(std::size_t i=0; (i < m_individuals.size()) && (l_pos < l_new->size()); ++i) {
+        for(std::size_t i=0; (i < m_individuals.size()) && (l_pos < p_target.size()); ++i) {
             std::size_t l_old = l_pos;
-            l_pos = static_cast<std::size_t>(m_random.get<double>(tools::random::uniform, l_pos+1, l_new->size()+1));
+            l_pos = static_cast<std::size_t>(m_random.get<double>(tools::random::uniform, l_pos+1, p_target.size()+1));
+            
+            if (copy(p_target, i, l_old, l_pos, isbinary()))
+                continue;
             
-            for(std::size_t n=l_old; n < l_pos; ++n) {
-                // we need a copy of the value - the [] operator returns a reference so we force the value-copy
-                T l_value = (*(m_individuals[i]))[n];
-                (*l_new)[n] = l_value;
-            }
+            for(std::size_t n=l_old; n < l_pos; ++n)
+                p_target.set( n, (*(m_individuals[i]))[n] );
         }
         
         // after create, we clear the internal list
         m_individuals.clear();
-        return l_new;
+    }
+    
+    
+    /** copies a crossover part word-wise, if the individuals are binary individuals
+     * @param p_new new individual
+     * @param p_index index of the parent individual
+     * @param p_start start position
+     * @param p_end end position (exclusive)
+     * @return boolean, that the part is copied
+     **/
+    template<typename T> inline bool kcrossover<T>::copy( individual::individual<T>& p_new, const std::size_t& p_index, const std::size_t& p_start, const std::size_t& p_end, const boost::true_type& ) const
+    {
+        individual::binaryindividual<T>* const l_new = dynamic_cast< individual::binaryindividual<T>* >( &p_new );
+        const individual::binaryindividual<T>* const l_parent = dynamic_cast< const individual::binaryindividual<T>* >( m_individuals[p_index].get() );
+        if ( (!l_new) || (!l_parent) )
+            return false;
+        
+        l_new->copy( *l_parent, p_start, p_end );
+        return true;
     }
 
 }}}
@@ -0,0 +1,277 @@
+/** 
+ @cond
+ ############################################################################
+ # LGPL License                                                             #
+ #                                                                          #
+ # This file is part of the Machine Learning Framework.                     #
+ # Copyright (c) 2010-2012, Philipp Kraus, <philipp.kraus@flashpixx.de>     #
+ # This program is free software: you can redistribute it and/or modify     #
+ # it under the terms of the GNU Lesser General Public License as           #
+ # published by the Free Software Foundation, either version 3 of the       #
+ # License, or (at your option) any later version.                          #
+ #                                                                          #
+ # This program is distributed in the hope that it will be useful,          #
+ # but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+ # MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+ # GNU Lesser General Public License for more details.                      #
+ #                                                                          #
+ # You should have received a copy of the GNU Lesser General Public License #
+ # along with this program. If not, see <http://www.gnu.org/licenses/>.     #
+ ############################################################################
+ @endcond
+ **/
+
+
+
+#ifndef __MACHINELEARNING_GENETICALGORITHM_FITNESS_CACHE_HPP
+#define __MACHINELEARNING_GENETICALGORITHM_FITNESS_CACHE_HPP
+
+#include <omp.h>
+#include <list>
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/unordered_map.hpp>
+
+#include "../../errorhandling/exception.hpp"
+
+
+namespace machinelearning { namespace geneticalgorithm { namespace fitness {
+    
+    
+    /** bounded thread-safe cache of fitness values, the values are stored with the genome hash of the individual.
+     * The cache is split into shards with an own lock, so threads that evaluate different individuals
+     * do not block each other. The capacity is split over the shards, so the cache never holds more values
+     * than the capacity
+     * @note two different genomes with the same 64 bit hash share the cache entry
+     **/
+    template<typename T> class cache
+    {
+        BOOST_STATIC_ASSERT( !boost::is_integral<T>::value );
+        
+        public :
+        
+            enum eviction {
+                lru     = 0,
+                fifo    = 1
+            };
+        
+        
+            cache( const std::size_t&, const eviction& = lru );
+            ~cache( void );
+        
+            bool get( const boost::uint64_t&, T&, bool& );
+            void set( const boost::uint64_t&, const T&, const bool& );
+            void clear( void );
+            std::size_t size( void ) const;
+            std::size_t getCapacity( void ) const;
+            eviction getEviction( void ) const;
+            std::size_t getHits( void ) const;
+            std::size_t getMisses( void ) const;
+        
+        
+        private :
+        
+            /** cache entry **/
+            struct entry {
+                /** genome hash **/
+                boost::uint64_t hash;
+                /** fitness value **/
+                T value;
+                /** optimum flag of the fitness function **/
+                bool optimum;
+            };
+        
+            /** shard of the cache, the list holds the entries in eviction order (front is removed first) **/
+            struct shard {
+                /** lock of the shard **/
+                omp_lock_t lock;
+                /** entries in eviction order **/
+                std::list<entry> order;
+                /** map with the hash and list position **/
+                boost::unordered_map<boost::uint64_t, typename std::list<entry>::iterator> index;
+                /** maximum number of entries **/
+                std::size_t capacity;
+                /** number of hits **/
+                std::size_t hits;
+                /** number of misses **/
+                std::size_t misses;
+            };
+        
+        
+            /** maximum number of shards **/
+            static const std::size_t m_shardnumber = 64;
+        
+            /** capacity of the cache **/
+            const std::size_t m_capacity;
+            /** eviction policy **/
+            const eviction m_eviction;
+            /** shards **/
+            std::vector<shard> m_shards;
+        
+            cache( const cache<T>& );
+            cache<T>& operator=( const cache<T>& );
+        
+    };
+    
+    
+    
+    /** constructor
+     * @param p_capacity maximum number of cached values
+     * @param p_eviction eviction policy (lru removes the value that is unused for the longest time, fifo the oldest value)
+     **/
+    template<typename T> inline cache<T>::cache( const std::size_t& p_capacity, const eviction& p_eviction ) :
+        m_capacity( p_capacity ),
+        m_eviction( p_eviction ),
+        m_shards( (p_capacity < m_shardnumber) ? p_capacity : m_shardnumber )
+    {
+        if (p_capacity == 0)
+            throw exception::runtime(_("capacity must be greater than zero"), *this);
+        
+        // the remainder of the capacity is spread over the first shards
+        for(std::size_t i=0; i < m_shards.size(); ++i) {
+            omp_init_lock( &m_shards[i].lock );
+            m_shards[i].capacity = m_capacity / m_shards.size() + ((i < m_capacity % m_shards.size()) ? 1 : 0);
+            m_shards[i].hits     = 0;
+            m_shards[i].misses   = 0;
+        }
+    }
+    
+    
+    /** destructor **/
+    template<typename T> inline cache<T>::~cache( void )
+    {
+        for(std::size_t i=0; i < m_shards.size(); ++i)
+            omp_destroy_lock( &m_shards[i].lock );
+    }
+    
+    
+    /** reads a fitness value and counts the hit or miss
+     * @param p_hash genome hash
+     * @param p_value reference of the fitness value
+     * @param p_optimum reference of the optimum flag
+     * @return boolean, that the value exists
+     **/
+    template<typename T> inline bool cache<T>::get( const boost::uint64_t& p_hash, T& p_value, bool& p_optimum )
+    {
+        shard& l_shard = m_shards[p_hash % m_shards.size()];
+        omp_set_lock( &l_shard.lock );
+        
+        const typename boost::unordered_map<boost::uint64_t, typename std::list<entry>::iterator>::const_iterator l_it = l_shard.index.find( p_hash );
+        const bool l_found = l_it != l_shard.index.end();
+        
+        if (l_found) {
+            p_value   = l_it->second->value;
+            p_optimum = l_it->second->optimum;
+            
+            if (m_eviction == lru)
+                l_shard.order.splice( l_shard.order.end(), l_shard.order, l_it->second );
+            
+            l_shard.hits++;
+        } else
+            l_shard.misses++;
+        
+        omp_unset_lock( &l_shard.lock );
+        return l_found;
+    }
+    
+    
+    /** stores a fitness value, if the shard is full the first value of the eviction order is removed
+     * @param p_hash genome hash
+     * @param p_value fitness value
+     * @param p_optimum optimum flag
+     **/
+    template<typename T> inline void cache<T>::set( const boost::uint64_t& p_hash, const T& p_value, const bool& p_optimum )
+    {
+        shard& l_shard = m_shards[p_hash % m_shards.size()];
+        omp_set_lock( &l_shard.lock );
+        
+        if (l_shard.index.find(p_hash) == l_shard.index.end()) {
+            
+            if (l_shard.order.size() >= l_shard.capacity) {
+                l_shard.index.erase( l_shard.order.front().hash );
+                l_shard.order.pop_front();
+            }
+            
+            entry l_entry;
+            l_entry.hash    = p_hash;
+            l_entry.value   = p_value;
+            l_entry.optimum = p_optimum;
+            
+            l_shard.index[p_hash] = l_shard.order.insert( l_shard.order.end(), l_entry );
+        }
+        
+        omp_unset_lock( &l_shard.lock );
+    }
+    
+    
+    /** removes all values and resets the counters **/
+    template<typename T> inline void cache<T>::clear( void )
+    {
+        for(std::size_t i=0; i < m_shards.size(); ++i) {
+            omp_set_lock( &m_shards[i].lock );
+            m_shards[i].order.clear();
+            m_shards[i].index.clear();
+            m_shards[i].hits   = 0;
+            m_shards[i].misses = 0;
+            omp_unset_lock( &m_shards[i].lock );
+        }
+    }
+    
+    
+    /** returns the number of cached values
+     * @return number of values
+     **/
+    template<typename T> inline std::size_t cache<T>::size( void ) const
+    {
+        std::size_t l_size = 0;
+        for(std::size_t i=0; i < m_shards.size(); ++i)
+            l_size += m_shards[i].order.size();
+        return l_size;
+    }
+    
+    
+    /** returns the capacity
+     * @return capacity
+     **/
+    template<typename T> inline std::size_t cache<T>::getCapacity( void ) const
+    {
+        return m_capacity;
+    }
+    
+    
+    /** returns the eviction policy
+     * @return eviction
+     **/
+    template<typename T> inline typename cache<T>::eviction cache<T>::getEviction( void ) const
+    {
+        return m_eviction;
+    }
+    
+    
+    /** returns the number of hits
+     * @return hits
+     **/
+    template<typename T> inline std::size_t cache<T>::getHits( void ) const
+    {
+        std::size_t l_hits = 0;
+        for(std::size_t i=0; i < m_shards.size(); ++i)
+            l_hits += m_shards[i].hits;
+        return l_hits;
+    }
+    
+    
+    /** returns the number of misses
+     * @return misses
+     **/
+    template<typename T> inline std::size_t cache<T>::getMisses( void ) const
+    {
+        std::size_t l_misses = 0;
+        for(std::size_t i=0; i < m_shards.size(); ++i)
+            l_misses += m_shards[i].misses;
+        return l_misses;
+    }
+    
+    
+}}}
+#endif
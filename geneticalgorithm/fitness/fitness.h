@@ -33,6 +33,7 @@ namespace machinelearning { namespace geneticalgorithm {
 }}
 
 #include "fitness.hpp"
+#include "cache.hpp"
 
 #endif
 
@@ -25,7 +25,10 @@
 #ifndef __MACHINELEARNING_GENETICALGORITHM_INDIVIDUAL_BINARYINDIVIDUAL_HPP
 #define __MACHINELEARNING_GENETICALGORITHM_INDIVIDUAL_BINARYINDIVIDUAL_HPP
 
+#include <vector>
+#include <algorithm>
 #include <iostream>
+#include <boost/cstdint.hpp>
 #include <boost/static_assert.hpp>
 #include <boost/shared_ptr.hpp>
 
@@ -36,7 +39,9 @@
 
 namespace machinelearning { namespace geneticalgorithm { namespace individual {
     
-    /** class of a binary indivdual (template type must be an unsigned integral type) **/
+    /** class of a binary indivdual (template type must be an unsigned integral type). The genes are
+     * packed into 64 bit words, so fitness functions and crossover objects can work on whole words
+     **/
     template<typename T> class binaryindividual : public individual<T>
     {
         BOOST_STATIC_ASSERT( boost::is_integral<T>::value && boost::is_unsigned<T>::value );
@@ -45,14 +50,20 @@ namespace machinelearning { namespace geneticalgorithm { namespace individual {
         public :
         
             binaryindividual( const std::size_t& );
-            ~binaryindividual( void );
     
-            T& operator[]( const std::size_t& );
             T operator[]( const std::size_t& ) const;
+            void set( const std::size_t&, const T& );
             void show( void ) const;
             void clone( boost::shared_ptr< individual<T> >& ) const;
             void mutate( void );
             std::size_t size( void ) const;
+            boost::uint64_t hash( void ) const;
+        
+            std::size_t count( void ) const;
+            std::size_t getWordCount( void ) const;
+            boost::uint64_t getWord( const std::size_t& ) const;
+            const std::vector<boost::uint64_t>& getWords( void ) const;
+            void copy( const binaryindividual<T>&, const std::size_t&, const std::size_t& );
         
         private :
         
@@ -60,8 +71,10 @@ namespace machinelearning { namespace geneticalgorithm { namespace individual {
             tools::random m_rand;
             /** number of bit position are used **/
             const std::size_t m_size;
-            /** value of the object **/
-            T* m_value;
+            /** packed bits of the object (bits behind the size are always zero) **/
+            std::vector<boost::uint64_t> m_words;
+        
+            static std::size_t popcount( boost::uint64_t );
 
     };
     
@@ -74,55 +87,48 @@ namespace machinelearning { namespace geneticalgorithm { namespace individual {
     template<typename T> inline binaryindividual<T>::binaryindividual( const std::size_t& p_size ) :
         m_rand(),
         m_size( p_size ),
-        m_value( NULL ) 
+        m_words()
     {
         if (p_size == 0)
             throw exception::runtime(_("size number need not to be zero"), *this);
         
-        m_value = (T*)calloc( m_size, sizeof(T) );
-        if (!m_value)
-            throw exception::runtime(_("can not allocate memory"), *this);
+        // each word is filled with two random 32 bit blocks and the bits behind the size are removed
+        m_words.resize( (m_size + 63) / 64, 0 );
+        for(std::size_t i=0; i < m_words.size(); ++i)
+            m_words[i] = (static_cast<boost::uint64_t>(m_rand.get<double>(tools::random::uniform, 0, 4294967296.0)) << 32) |
+                          static_cast<boost::uint64_t>(m_rand.get<double>(tools::random::uniform, 0, 4294967296.0));
         
-        for(std::size_t i=0; i < m_size; ++i)
-            m_value[i] = static_cast<T>(m_rand.get<double>(tools::random::uniform, 0, 2));
-    }
-
-    
-    /** destructor **/
-    template<typename T> inline binaryindividual<T>::~binaryindividual( void )
-    {
-        free(m_value);
+        if (m_size % 64)
+            m_words[m_words.size()-1] &= ~0ULL >> (64 - m_size % 64);
     }
 
     
-    /** return reference on index position
+    /** read value on index position
      * @param p_index index position
-     * @return reference
+     * @return value
      **/
-    template<typename T> inline T& binaryindividual<T>::operator[]( const std::size_t& p_index )
+    template<typename T> inline T binaryindividual<T>::operator[]( const std::size_t& p_index ) const
     {
         if (p_index >= m_size)
             throw exception::runtime(_("index out of range"), *this);
-
-        // only at this point we can create different values [0,1],
-        // so we reorganize here values
-        for( std::size_t i=0; i < m_size; ++i)
-            m_value[i] = m_value[i] != 0 ? 1 : 0;
         
-        return  m_value[p_index];
+        return static_cast<T>((m_words[p_index / 64] >> (p_index % 64)) & 1);
     }
     
     
-    /** read value on index position
+    /** sets the bit on index position
      * @param p_index index position
-     * @return value
+     * @param p_value value, each value except zero sets the bit
      **/
-    template<typename T> inline T binaryindividual<T>::operator[]( const std::size_t& p_index ) const
+    template<typename T> inline void binaryindividual<T>::set( const std::size_t& p_index, const T& p_value )
     {
         if (p_index >= m_size)
             throw exception::runtime(_("index out of range"), *this);
-    
-        return  m_value[p_index] != 0 ? 1 : 0;
+        
+        if (p_value != 0)
+            m_words[p_index / 64] |= 1ULL << (p_index % 64);
+        else
+            m_words[p_index / 64] &= ~(1ULL << (p_index % 64));
     }
    
     
@@ -130,7 +136,7 @@ namespace machinelearning { namespace geneticalgorithm { namespace individual {
     template<typename T> inline void binaryindividual<T>::mutate( void )
     {
         const std::size_t l_pos = static_cast<std::size_t>(m_rand.get<double>(tools::random::uniform, 0, m_size));
-        m_value[l_pos] = m_value[l_pos] == 0 ? 1 : 0;
+        m_words[l_pos / 64] ^= 1ULL << (l_pos % 64);
     }
     
     
@@ -152,6 +158,114 @@ namespace machinelearning { namespace geneticalgorithm { namespace individual {
     }
     
     
+    /** returns the hash of the bit set, the words are mixed with a
+     * multiply-xorshift step, so the hash costs one operation per 64 genes
+     * @return 64 bit hash
+     **/
+    template<typename T> inline boost::uint64_t binaryindividual<T>::hash( void ) const
+    {
+        boost::uint64_t l_hash = 14695981039346656037ULL ^ m_size;
+        for(std::size_t i=0; i < m_words.size(); ++i) {
+            l_hash  = (l_hash ^ m_words[i]) * 0x9e3779b97f4a7c15ULL;
+            l_hash ^= l_hash >> 29;
+        }
+        
+        return l_hash;
+    }
+    
+    
+    /** returns the number of words, bit i is stored in word i / 64 at the position i % 64
+     * @return number of words
+     **/
+    template<typename T> inline std::size_t binaryindividual<T>::getWordCount( void ) const
+    {
+        return m_words.size();
+    }
+    
+    
+    /** returns a word of the bit set
+     * @param p_index word index
+     * @return word
+     **/
+    template<typename T> inline boost::uint64_t binaryindividual<T>::getWord( const std::size_t& p_index ) const
+    {
+        if (p_index >= m_words.size())
+            throw exception::runtime(_("index out of range"), *this);
+        
+        return m_words[p_index];
+    }
+    
+    
+    /** returns the words of the bit set, so a fitness function can run over the set bits
+     * @return const reference of the word vector
+     **/
+    template<typename T> inline const std::vector<boost::uint64_t>& binaryindividual<T>::getWords( void ) const
+    {
+        return m_words;
+    }
+    
+    
+    /** returns the number of set bits
+     * @return number of bits with value 1
+     **/
+    template<typename T> inline std::size_t binaryindividual<T>::count( void ) const
+    {
+        std::size_t l_count = 0;
+        for(std::size_t i=0; i < m_words.size(); ++i)
+            l_count += popcount(m_words[i]);
+        
+        return l_count;
+    }
+    
+    
+    /** copies the bits [start, end) of an individual, the inner words are copied
+     * as a block and only the boundary words are blended with masks
+     * @param p_source source individual
+     * @param p_start start bit
+     * @param p_end end bit (exclusive)
+     **/
+    template<typename T> inline void binaryindividual<T>::copy( const binaryindividual<T>& p_source, const std::size_t& p_start, const std::size_t& p_end )
+    {
+        if (p_source.m_size != m_size)
+            throw exception::runtime(_("element sizes are not equal"), *this);
+        
+        if (p_end > m_size)
+            throw exception::runtime(_("index out of range"), *this);
+        
+        if (p_start >= p_end)
+            return;
+        
+        const std::size_t l_first = p_start / 64;
+        const std::size_t l_last  = (p_end - 1) / 64;
+        const boost::uint64_t l_head = ~0ULL << (p_start % 64);
+        const boost::uint64_t l_tail = ~0ULL >> (63 - (p_end - 1) % 64);
+        
+        if (l_first == l_last) {
+            const boost::uint64_t l_mask = l_head & l_tail;
+            m_words[l_first] = (m_words[l_first] & ~l_mask) | (p_source.m_words[l_first] & l_mask);
+            return;
+        }
+        
+        m_words[l_first] = (m_words[l_first] & ~l_head) | (p_source.m_words[l_first] & l_head);
+        std::copy( p_source.m_words.begin() + l_first + 1, p_source.m_words.begin() + l_last, m_words.begin() + l_first + 1 );
+        m_words[l_last]  = (m_words[l_last] & ~l_tail) | (p_source.m_words[l_last] & l_tail);
+    }
+    
+    
+    /** counts the set bits of a word
+     * @param p_word word
+     * @return number of set bits
+     **/
+    template<typename T> inline std::size_t binaryindividual<T>::popcount( boost::uint64_t p_word )
+    {
+        p_word = p_word - ((p_word >> 1) & 0x5555555555555555ULL);
+        p_word = (p_word & 0x3333333333333333ULL) + ((p_word >> 2) & 0x3333333333333333ULL);
+        p_word = (p_word + (p_word >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+        
+        return static_cast<std::size_t>((p_word * 0x0101010101010101ULL) >> 56);
+    }
+    
+    
 }}}
 #endif
 
@@ -25,6 +25,8 @@
 #ifndef __MACHINELEARNING_GENETICALGORITHM_INDIVIDUAL_INDIVIDUAL_HPP
 #define __MACHINELEARNING_GENETICALGORITHM_INDIVIDUAL_INDIVIDUAL_HPP
 
+#include <cstring>
+#include <boost/cstdint.hpp>
 #include <boost/shared_ptr.hpp>
 
 
@@ -48,10 +50,11 @@ namespace machinelearning { namespace geneticalgorithm { namespace individual {
              **/
             virtual T operator[]( const std::size_t& p_index ) const = 0;
         
-            /** returns a reference of a data element at the position of the individual
+            /** sets the value of a data element at the position of the individual
              * @param p_index index position of the gen position
+             * @param p_value new value
              **/
-            virtual T& operator[]( const std::size_t& p_index ) = 0;
+            virtual void set( const std::size_t& p_index, const T& p_value ) = 0;
         
             /** mutates the individual **/
             virtual void mutate( void ) = 0;
@@ -60,9 +63,36 @@ namespace machinelearning { namespace geneticalgorithm { namespace individual {
              * @return length / size of the gen sequence
              **/
             virtual std::size_t size( void ) const = 0;
+        
+            virtual boost::uint64_t hash( void ) const;
     
     };
     
+    
+    
+    /** returns a hash of the gen sequence, that is used for caching fitness values. The default
+     * implementation runs FNV-1a over the bytes of the values, individuals with a packed
+     * representation should overwrite it
+     * @return 64 bit hash
+     **/
+    template<typename T> inline boost::uint64_t individual<T>::hash( void ) const
+    {
+        boost::uint64_t l_hash = 14695981039346656037ULL;
+        unsigned char l_bytes[sizeof(T)];
+        
+        for(std::size_t i=0; i < size(); ++i) {
+            const T l_value = (*this)[i];
+            std::memcpy( l_bytes, &l_value, sizeof(T) );
+            
+            for(std::size_t n=0; n < sizeof(T); ++n) {
+                l_hash ^= l_bytes[n];
+                l_hash *= 1099511628211ULL;
+            }
+        }
+        
+        return l_hash;
+    }
+    
 }}}
 #endif
 
@@ -27,9 +27,15 @@
 
 #include <omp.h>
 #include <limits>
+#include <algorithm>
 #include <boost/numeric/ublas/vector.hpp>
 
 #include <boost/shared_ptr.hpp>
+#ifdef MACHINELEARNING_MPI
+#include <functional>
+#include <boost/mpi.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#endif
 
 #include "../errorhandling/exception.hpp"
 #include "../tools/tools.h"
@@ -42,11 +48,19 @@
 
 namespace machinelearning { namespace geneticalgorithm {
     
+    #ifndef SWIG
     namespace ublas = boost::numeric::ublas;
+    #ifdef MACHINELEARNING_MPI
+    namespace mpi   = boost::mpi;
+    #endif
+    #endif
     
 
     /** class for the population / optimization structure
      * @todo check memory allocation and clearing on big datasets
+     * @note The MPI iterate method runs an island model, each process evolves its own population and
+     * exchanges its best individuals with the neighbour processes. The migration options and the
+     * iteration calls must be equal on each process.
      **/
     template<typename T, typename L> class population
     {
@@ -60,6 +74,18 @@ namespace machinelearning { namespace geneticalgorithm {
                 random         = 2
             };
         
+            enum storageoption {
+                heap           = 0,
+                arena          = 1
+            };
+        
+            #ifdef MACHINELEARNING_MPI
+            enum migrationtopology {
+                ring           = 0,
+                randomring     = 1
+            };
+            #endif
+        
         
             population( const individual::individual<L>&, const std::size_t&, const std::size_t& );
         
@@ -69,7 +95,17 @@ namespace machinelearning { namespace geneticalgorithm {
             std::vector< boost::shared_ptr< individual::individual<L> > > getElite( void ) const;
             void setMutalProbability( const T&, const tools::random::distribution& = tools::random::uniform, const T& = std::numeric_limits<T>::epsilon(), const T& = std::numeric_limits<T>::epsilon(), const T& = std::numeric_limits<T>::epsilon() );
             void setPopulationBuild( const buildoption&, const tools::random::distribution& = tools::random::uniform );
+            void setStorage( const storageoption& );
+            storageoption getStorage( void ) const;
+            void setFitnessCache( const std::size_t&, const typename fitness::cache<T>::eviction& = fitness::cache<T>::lru );
+            std::size_t getFitnessCacheHits( void ) const;
+            std::size_t getFitnessCacheMisses( void ) const;
             void iterate( const std::size_t&, fitness::fitness<T,L>&, selection::selection<T,L>&, crossover::crossover<L>& );
+        
+            #ifdef MACHINELEARNING_MPI
+            void setMigration( const std::size_t&, const std::size_t&, const migrationtopology& = ring );
+            void iterate( const mpi::communicator&, const std::size_t&, fitness::fitness<T,L>&, selection::selection<T,L>&, crossover::crossover<L>& );
+            #endif
             //bool iterateUntilConverged( const std::size_t&, const fitness::fitness<T>&, const selection::selection<T>&, const crossover& );
         
         
@@ -92,18 +128,77 @@ namespace machinelearning { namespace geneticalgorithm {
                 {}
             };
         
+            #ifdef MACHINELEARNING_MPI
+            /** struct of the migration options and the buffers of the non-blocking communication **/
+            struct migration {
+                /** number of generations between two migrations (zero disables the migration) **/
+                std::size_t interval;
+                /** communicator of the running MPI iteration **/
+                const mpi::communicator* communicator;
+                /** number of individuals that are sent **/
+                std::size_t number;
+                /** topology **/
+                migrationtopology topology;
+                /** seed of the random topology **/
+                std::size_t seed;
+                /** flag that a migration is running **/
+                bool pending;
+                /** requests of the running migration **/
+                std::vector<mpi::request> requests;
+                /** fitness values of the sent individuals **/
+                std::vector<T> sendfitness;
+                /** genes of the sent individuals **/
+                std::vector<L> sendgenes;
+                /** fitness values of the received individuals **/
+                std::vector<T> receivefitness;
+                /** genes of the received individuals **/
+                std::vector<L> receivegenes;
+                
+                migration() :
+                    interval( 0 ),
+                    communicator( NULL ),
+                    number( 0 ),
+                    topology( ring ),
+                    seed( 0 ),
+                    pending( false ),
+                    requests(),
+                    sendfitness(),
+                    sendgenes(),
+                    receivefitness(),
+                    receivegenes()
+                {}
+            };
+            #endif
+        
             /** reference of the individual **/
             const individual::individual<L>& m_individualref;
             /** vector with smart-pointer of individuals **/
             std::vector< boost::shared_ptr< individual::individual<L> > > m_population;
-            /** vector with smart-pointer of elite-individuals **/
+            /** vector with the individuals of the next generation on arena storage **/
+            std::vector< boost::shared_ptr< individual::individual<L> > > m_next;
+            /** vector with smart-pointer of elite-individuals (on arena storage valid only until the next iteration) **/
             std::vector< boost::shared_ptr< individual::individual<L> > > m_elite;
             /** option in which way the new population is build **/
             buildoption m_buildoption;
+            /** option in which way the individuals are stored **/
+            storageoption m_storage;
             /** mutation probability **/
             probability m_mutateprobility;
             /** elite size **/
             std::size_t m_elitesize;
+            /** fitness cache **/
+            boost::shared_ptr< fitness::cache<T> > m_cache;
+            #ifdef MACHINELEARNING_MPI
+            /** migration data **/
+            migration m_migration;
+            #endif
+        
+        
+            #ifdef MACHINELEARNING_MPI
+            void getNeighbours( const std::size_t&, std::size_t&, std::size_t& ) const;
+            void sendMigration( const std::size_t&, const ublas::vector<T>&, const T&, const ublas::vector<std::size_t>& );
+            void receiveMigration( ublas::vector<T>& );
+            #endif
     };
     
     
@@ -116,10 +211,16 @@ namespace machinelearning { namespace geneticalgorithm {
     template<typename T, typename L> inline population<T,L>::population( const individual::individual<L>& p_individualref, const std::size_t& p_size, const std::size_t& p_elite ) :
         m_individualref( p_individualref ), 
         m_population(),
+        m_next(),
         m_elite(),
         m_buildoption( eliteonly ),
+        m_storage( heap ),
         m_mutateprobility(),
-        m_elitesize(p_elite)
+        m_elitesize(p_elite),
+        m_cache()
+        #ifdef MACHINELEARNING_MPI
+        , m_migration()
+        #endif
     {
         if (p_size < 3)
             throw exception::runtime(_("population size must be greater than two"), *this);
@@ -149,6 +250,70 @@ namespace machinelearning { namespace geneticalgorithm {
     }
     
     
+    /** sets the storage of the individuals. On heap storage each crossover creates a new individual,
+     * on arena storage the population holds two preallocated generations, the crossover writes into
+     * the next generation and both generations are swapped after each iteration
+     * @param p_storage storage option
+     **/
+    template<typename T, typename L> inline void population<T,L>::setStorage( const storageoption& p_storage )
+    {
+        m_storage = p_storage;
+        
+        if (m_storage == heap) {
+            m_next.clear();
+            return;
+        }
+        
+        while (m_next.size() < m_population.size()) {
+            boost::shared_ptr< individual::individual<L> > l_ptr;
+            m_individualref.clone( l_ptr );
+            m_next.push_back( l_ptr );
+        }
+    }
+    
+    
+    /** returns the storage option
+     * @return storage option
+     **/
+    template<typename T, typename L> inline typename population<T,L>::storageoption population<T,L>::getStorage( void ) const
+    {
+        return m_storage;
+    }
+    
+    
+    /** sets a bounded fitness cache, so individuals with an equal genome hash (eg elites or duplicated children)
+     * are not evaluated again. The cache should only be used, if the fitness function does not change its values
+     * on the "eachIteration" call
+     * @param p_capacity maximum number of cached values (zero removes the cache)
+     * @param p_eviction eviction policy
+     **/
+    template<typename T, typename L> inline void population<T,L>::setFitnessCache( const std::size_t& p_capacity, const typename fitness::cache<T>::eviction& p_eviction )
+    {
+        if (p_capacity == 0)
+            m_cache.reset();
+        else
+            m_cache = boost::shared_ptr< fitness::cache<T> >( new fitness::cache<T>(p_capacity, p_eviction) );
+    }
+    
+    
+    /** returns the number of fitness values, that are read from the cache
+     * @return number of hits
+     **/
+    template<typename T, typename L> inline std::size_t population<T,L>::getFitnessCacheHits( void ) const
+    {
+        return m_cache ? m_cache->getHits() : 0;
+    }
+    
+    
+    /** returns the number of fitness values, that are not found within the cache
+     * @return number of misses
+     **/
+    template<typename T, typename L> inline std::size_t population<T,L>::getFitnessCacheMisses( void ) const
+    {
+        return m_cache ? m_cache->getMisses() : 0;
+    }
+    
+    
     /** change the elite size
      * @param p_size size number
      **/
@@ -173,7 +338,9 @@ namespace machinelearning { namespace geneticalgorithm {
     }
     
     
-    /** returns a copy of the elite individuals 
+    /** returns a copy of the elite individuals. The internal elite points into the generations,
+     * which are overwritten on arena storage by the next iteration, so each individual is cloned
+     * and the returned individuals are independent of the population
      * @return vector with smart-pointer objects of the elite individuals
      **/
     template<typename T, typename L> inline std::vector< boost::shared_ptr< individual::individual<L> > > population<T,L>::getElite( void ) const
@@ -187,11 +354,8 @@ namespace machinelearning { namespace geneticalgorithm {
             if (l_ind->size() != m_elite[i]->size())
                 throw exception::runtime(_("element sizes are not equal"), *this);
         
-            for(std::size_t n=0; n < m_elite[i]->size(); ++n) {
-                // we need a copy of the value - the [] operator returns a reference so we force the value-copy
-                T l_value = (*(m_elite[i]))[n];
-                (*l_ind)[n] = l_value;
-            }
+            for(std::size_t n=0; n < m_elite[i]->size(); ++n)
+                l_ind->set( n, (*(m_elite[i]))[n] );
             l_result.push_back( l_ind );
         }
         
@@ -271,13 +435,41 @@ namespace machinelearning { namespace geneticalgorithm {
             
                 #pragma omp for
                 for(std::size_t i=0; i < m_population.size(); ++i) {
-                    l_fitness(i) = l_fitnessfunction->getFitness( *m_population[i] );
                     
-                    if (l_fitnessfunction->isOptimumReached())
+                    // with a cache the fitness function is called only if the genome hash is not found
+                    bool l_optimum = false;
+                    if (m_cache) {
+                        const boost::uint64_t l_hash = m_population[i]->hash();
+                        
+                        if (!m_cache->get(l_hash, l_fitness(i), l_optimum)) {
+                            l_fitness(i) = l_fitnessfunction->getFitness( *m_population[i] );
+                            l_optimum    = l_fitnessfunction->isOptimumReached();
+                            m_cache->set( l_hash, l_fitness(i), l_optimum );
+                        }
+                        
+                    } else {
+                        l_fitness(i) = l_fitnessfunction->getFitness( *m_population[i] );
+                        l_optimum    = l_fitnessfunction->isOptimumReached();
+                    }
+                    
+                    if (l_optimum)
                         #pragma omp critical
                         l_optimumreached = true;
                 }
             }
+            
+            #ifdef MACHINELEARNING_MPI
+            // a running migration is finished after the fitness evaluation, so the communication overlaps with the
+            // evaluation. On migration all processes decide together, if the optimum is reached, so the processes
+            // break on the same iteration
+            if ((m_migration.communicator) && (m_migration.interval > 0)) {
+                if (m_migration.pending) {
+                    receiveMigration( l_fitness );
+                    l_optimumreached = mpi::all_reduce( *m_migration.communicator, l_optimumreached, std::logical_or<bool>() );
+                } else
+                    l_optimumreached = false;
+            }
+            #endif
 
         
             // scales the fitness values to [0,x]
@@ -315,6 +507,12 @@ namespace machinelearning { namespace geneticalgorithm {
             m_elitesize = m_elite.size();
             if (l_optimumreached)
                 break;
+            
+            #ifdef MACHINELEARNING_MPI
+            // the best individuals are sent every n-th iteration (not on the last iteration, because there is no receiving call)
+            if ((m_migration.communicator) && (m_migration.interval > 0) && ((i+1) % m_migration.interval == 0) && (i+1 < p_iteration))
+                sendMigration( i, l_fitness, l_min, l_rankIndex );
+            #endif
 
             
             // build the new population
@@ -331,9 +529,16 @@ namespace machinelearning { namespace geneticalgorithm {
                             for(std::size_t j=0; j < l_crossover->getNumberOfIndividuals(); ++j)
                                 l_crossover->setIndividual( m_elite[static_cast<std::size_t>(l_random.get<T>(tools::random::uniform, 0, m_elite.size()))] );
                         
-                            m_population[i] = l_crossover->combine();
+                            if (m_storage == arena)
+                                l_crossover->combine( *m_next[i] );
+                            else
+                                m_population[i] = l_crossover->combine();
                         }
                     }
+                    
+                    // the elites are read from the current generation, so we can swap the generations after the build
+                    if (m_storage == arena)
+                        m_population.swap( m_next );
                     break;
                     
                     
@@ -348,9 +553,17 @@ namespace machinelearning { namespace geneticalgorithm {
                             for(std::size_t j=0; j < l_crossover->getNumberOfIndividuals(); ++j)
                                 l_crossover->setIndividual( m_elite[static_cast<std::size_t>(l_random.get<T>(tools::random::uniform, 0, m_elite.size()))] );
                             
-                            m_population[l_rankIndex(i)] = l_crossover->combine();
+                            if (m_storage == arena)
+                                l_crossover->combine( *m_next[l_rankIndex(i)] );
+                            else
+                                m_population[l_rankIndex(i)] = l_crossover->combine();
                         }
                     }
+                    
+                    // only the replaced individuals are swapped with the next generation
+                    if (m_storage == arena)
+                        for(std::size_t i=0; i < m_elite.size(); ++i)
+                            m_population[l_rankIndex(i)].swap( m_next[l_rankIndex(i)] );
                     break;
                     
                     
@@ -365,8 +578,16 @@ namespace machinelearning { namespace geneticalgorithm {
                             for(std::size_t j=0; j < l_crossover->getNumberOfIndividuals(); ++j)
                                 l_crossover->setIndividual( m_elite[static_cast<std::size_t>(l_random.get<T>(tools::random::uniform, 0, m_elite.size()))] );
                             
-                            #pragma omp critical
-                            m_population[static_cast<std::size_t>(l_random.get<T>(tools::random::uniform, 0, m_elite.size()))] = l_crossover->combine();
+                            // on arena storage the child is written into the next generation and swapped into the population,
+                            // the replaced individual is moved to a next generation position that is not written again
+                            if (m_storage == arena) {
+                                l_crossover->combine( *m_next[i] );
+                                
+                                #pragma omp critical
+                                m_population[static_cast<std::size_t>(l_random.get<T>(tools::random::uniform, 0, m_elite.size()))].swap( m_next[i] );
+                            } else
+                                #pragma omp critical
+                                m_population[static_cast<std::size_t>(l_random.get<T>(tools::random::uniform, 0, m_elite.size()))] = l_crossover->combine();
                         }
                     }
                     break;
@@ -387,5 +608,148 @@ namespace machinelearning { namespace geneticalgorithm {
     }
     
     
+    
+    #ifdef MACHINELEARNING_MPI
+    
+    /** sets the migration options of the island model
+     * @param p_interval number of iterations between two migrations (zero disables the migration)
+     * @param p_number number of best individuals that are sent to the neighbour process
+     * @param p_topology topology (ring sends to the next rank, randomring sends to the next rank of a random permutation, that is changed on each migration)
+     **/
+    template<typename T, typename L> inline void population<T,L>::setMigration( const std::size_t& p_interval, const std::size_t& p_number, const migrationtopology& p_topology )
+    {
+        if (p_number >= m_population.size())
+            throw exception::runtime(_("number of migration individuals must be smaller than population size"), *this);
+        
+        m_migration.interval = p_interval;
+        m_migration.number   = p_number;
+        m_migration.topology = p_topology;
+    }
+    
+    
+    /** executes the algorithm iteratively as island model, each process evolves its own population. The
+     * migration messages are sent non-blocking and are received after the fitness evaluation of the next iteration
+     * @param p_mpi MPI object
+     * @param p_iteration number of iterations
+     * @param p_fitness fitness function object
+     * @param p_elite elite selection object
+     * @param p_crossover crossover object
+     **/
+    template<typename T, typename L> inline void population<T,L>::iterate( const mpi::communicator& p_mpi, const std::size_t& p_iteration, fitness::fitness<T,L>& p_fitness, selection::selection<T,L>& p_elite, crossover::crossover<L>& p_crossover )
+    {
+        // all processes must run the same number of iterations and the same random topology, so the migrations are matched
+        const std::size_t l_iteration = mpi::all_reduce(p_mpi, p_iteration, mpi::maximum<std::size_t>());
+        
+        if (p_mpi.rank() == 0) {
+            tools::random l_random;
+            m_migration.seed = static_cast<std::size_t>(l_random.get<double>(tools::random::uniform, 0, 4294967296.0));
+        }
+        mpi::broadcast(p_mpi, m_migration.seed, 0);
+        
+        m_migration.communicator = &p_mpi;
+        m_migration.pending      = false;
+        
+        try {
+            iterate( l_iteration, p_fitness, p_elite, p_crossover );
+        } catch (...) {
+            m_migration.communicator = NULL;
+            throw;
+        }
+        
+        m_migration.communicator = NULL;
+    }
+    
+    
+    /** determines the neighbour processes of a migration
+     * @param p_iteration iteration number
+     * @param p_destination reference of the process, that receives the individuals
+     * @param p_source reference of the process, that sends the individuals
+     **/
+    template<typename T, typename L> inline void population<T,L>::getNeighbours( const std::size_t& p_iteration, std::size_t& p_destination, std::size_t& p_source ) const
+    {
+        const std::size_t l_size = static_cast<std::size_t>(m_migration.communicator->size());
+        const std::size_t l_rank = static_cast<std::size_t>(m_migration.communicator->rank());
+        
+        // on the random ring each process creates the same permutation of the ranks with the shared seed
+        std::vector<std::size_t> l_ring(l_size);
+        for(std::size_t i=0; i < l_size; ++i)
+            l_ring[i] = i;
+        
+        if (m_migration.topology == randomring) {
+            boost::mt19937 l_engine( static_cast<boost::uint32_t>(m_migration.seed + p_iteration) );
+            for(std::size_t i=l_size-1; i > 0; --i)
+                std::swap( l_ring[i], l_ring[l_engine() % (i+1)] );
+        }
+        
+        const std::size_t l_pos = static_cast<std::size_t>(std::find(l_ring.begin(), l_ring.end(), l_rank) - l_ring.begin());
+        p_destination = l_ring[(l_pos+1) % l_size];
+        p_source      = l_ring[(l_pos+l_size-1) % l_size];
+    }
+    
+    
+    /** sends the best individuals to the neighbour process and starts receiving
+     * @param p_iteration iteration number
+     * @param p_fitness scaled fitness values
+     * @param p_min minimum of the unscaled fitness values
+     * @param p_rankIndex rank index of the fitness values
+     **/
+    template<typename T, typename L> inline void population<T,L>::sendMigration( const std::size_t& p_iteration, const ublas::vector<T>& p_fitness, const T& p_min, const ublas::vector<std::size_t>& p_rankIndex )
+    {
+        const std::size_t l_length = m_individualref.size();
+        
+        m_migration.sendfitness.resize( m_migration.number );
+        m_migration.sendgenes.resize( m_migration.number * l_length );
+        
+        for(std::size_t i=0; i < m_migration.number; ++i) {
+            const std::size_t l_index = p_rankIndex(p_rankIndex.size()-1-i);
+            const individual::individual<L>& l_individual = *m_population[l_index];
+            
+            m_migration.sendfitness[i] = p_fitness(l_index) + p_min;
+            for(std::size_t n=0; n < l_length; ++n)
+                m_migration.sendgenes[i*l_length+n] = l_individual[n];
+        }
+        
+        std::size_t l_destination = 0;
+        std::size_t l_source      = 0;
+        getNeighbours( p_iteration, l_destination, l_source );
+        
+        m_migration.requests.clear();
+        m_migration.requests.push_back( m_migration.communicator->isend(static_cast<int>(l_destination), 0, m_migration.sendfitness) );
+        m_migration.requests.push_back( m_migration.communicator->isend(static_cast<int>(l_destination), 1, m_migration.sendgenes) );
+        m_migration.requests.push_back( m_migration.communicator->irecv(static_cast<int>(l_source), 0, m_migration.receivefitness) );
+        m_migration.requests.push_back( m_migration.communicator->irecv(static_cast<int>(l_source), 1, m_migration.receivegenes) );
+        m_migration.pending = true;
+    }
+    
+    
+    /** waits for the running migration and replaces the worst individuals (but not more than the non-elite individuals)
+     * with the received individuals and their fitness values
+     * @param p_fitness unscaled fitness values
+     **/
+    template<typename T, typename L> inline void population<T,L>::receiveMigration( ublas::vector<T>& p_fitness )
+    {
+        mpi::wait_all( m_migration.requests.begin(), m_migration.requests.end() );
+        m_migration.requests.clear();
+        m_migration.pending = false;
+        
+        const std::size_t l_length = m_individualref.size();
+        if (m_migration.receivegenes.size() != m_migration.receivefitness.size() * l_length)
+            throw exception::runtime(_("individual sizes of the processes are not equal"), *this);
+        
+        const ublas::vector<std::size_t> l_rankIndex( tools::vector::rankIndexVector(p_fitness) );
+        const std::size_t l_number = std::min( m_migration.receivefitness.size(), m_population.size() - m_elitesize );
+        
+        for(std::size_t i=0; i < l_number; ++i) {
+            const std::size_t l_index = l_rankIndex(i);
+            
+            p_fitness(l_index) = m_migration.receivefitness[i];
+            for(std::size_t n=0; n < l_length; ++n)
+                m_population[l_index]->set( n, m_migration.receivegenes[i*l_length+n] );
+        }
+    }
+    
+    #endif
+    
+    
 }}
 #endif
@@ -0,0 +1,149 @@
+/** 
+ @cond
+ ############################################################################
+ # LGPL License                                                             #
+ #                                                                          #
+ # This file is part of the Machine Learning Framework.                     #
+ # Copyright (c) 2010-2012, Philipp Kraus, <philipp.kraus@flashpixx.de>     #
+ # This program is free software: you can redistribute it and/or modify     #
+ # it under the terms of the GNU Lesser General Public License as           #
+ # published by the Free Software Foundation, either version 3 of the       #
+ # License, or (at your option) any later version.                          #
+ #                                                                          #
+ # This program is distributed in the hope that it will be useful,          #
+ # but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+ # MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+ # GNU Lesser General Public License for more details.                      #
+ #                                                                          #
+ # You should have received a copy of the GNU Lesser General Public License #
+ # along with this program. If not, see <http://www.gnu.org/licenses/>.     #
+ ############################################################################
+ @endcond
+ **/
+
+
+
+#ifndef __MACHINELEARNING_GENETICALGORITHM_SELECTION_ALIAS_HPP
+#define __MACHINELEARNING_GENETICALGORITHM_SELECTION_ALIAS_HPP
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_01.hpp>
+#include <boost/random/uniform_int.hpp>
+#include <boost/random/variate_generator.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+
+#include "selection.hpp"
+#include "../individual/individual.hpp"
+#include "../../tools/tools.h"
+
+
+
+namespace machinelearning { namespace geneticalgorithm { namespace selection {
+    
+    
+    namespace ublas = boost::numeric::ublas;
+    
+    
+    /** class of the fitness proportional selection with Walker's alias table. Each draw needs O(1), but
+     * the table is build in O(n) on each getElite call, so each thread builds its own table
+     * (the fitness values are only known within the parallel selection, so a shared table needs a synchronization)
+     **/
+    template<typename T, typename L> class alias : public randomstream<T,L>
+    {
+        BOOST_STATIC_ASSERT( !boost::is_integral<T>::value );
+        
+        public :
+        
+            alias( void );
+        
+            void clone( boost::shared_ptr< selection<T,L> >& p_ptr ) const;
+            void getElite( const std::size_t&, const std::size_t&, const std::vector< boost::shared_ptr< individual::individual<L> > >&, const ublas::vector<T>&, const ublas::vector<std::size_t>&, const ublas::vector<std::size_t>&,std::vector< boost::shared_ptr< individual::individual<L> > >&  );
+        
+    };
+    
+    
+    
+    /** constructor **/
+    template<typename T, typename L> inline alias<T,L>::alias( void ) :
+        randomstream<T,L>()
+    {}
+    
+    
+    /** method for cloning the object, for using on multithread
+     * @param p_ptr smart-pointer object
+     **/
+    template<typename T, typename L> inline void alias<T,L>::clone( boost::shared_ptr< selection<T,L> >& p_ptr ) const
+    {
+        p_ptr = boost::shared_ptr< selection<T,L> >( new alias<T,L>(*this) );
+    }
+    
+    
+    /** returns the elites drawn proportional to the fitness values (if all values are zero, the elites are drawn uniformly)
+     * @param p_start start value of the elite values
+     * @param p_end end value of the elite values ([start, end) elite elements must be created)
+     * @param p_population const reference to the population
+     * @param p_fitness vector with fitnss values (index is equal to the index of the population)
+     * @param p_elite vector with elite individual
+     **/
+    template<typename T, typename L> inline void alias<T,L>::getElite( const std::size_t& p_start, const std::size_t& p_end, const std::vector< boost::shared_ptr< individual::individual<L> > >& p_population, const ublas::vector<T>& p_fitness, const ublas::vector<std::size_t>&, const ublas::vector<std::size_t>&, std::vector< boost::shared_ptr< individual::individual<L> > >& p_elite )
+    {
+        const std::size_t l_size = p_fitness.size();
+        const T l_sum            = ublas::sum(p_fitness);
+        
+        // build the table with Vose's method: the scaled probabilities are split into small and large
+        // entries, each small entry is filled up with the rest of a large entry
+        std::vector<T> l_probability( l_size, 1 );
+        std::vector<std::size_t> l_alias( l_size );
+        
+        if (!tools::function::isNumericalZero(l_sum)) {
+            std::vector<std::size_t> l_small;
+            std::vector<std::size_t> l_large;
+            
+            for(std::size_t i=0; i < l_size; ++i) {
+                l_probability[i] = p_fitness(i) * l_size / l_sum;
+                l_alias[i]       = i;
+                
+                if (l_probability[i] < 1)
+                    l_small.push_back(i);
+                else
+                    l_large.push_back(i);
+            }
+            
+            while ( (!l_small.empty()) && (!l_large.empty()) ) {
+                const std::size_t l_less = l_small.back();
+                const std::size_t l_more = l_large.back();
+                l_small.pop_back();
+                
+                l_alias[l_less]        = l_more;
+                l_probability[l_more] -= 1 - l_probability[l_less];
+                
+                if (l_probability[l_more] < 1) {
+                    l_large.pop_back();
+                    l_small.push_back(l_more);
+                }
+            }
+            
+            // numerical rest of the entries
+            for(std::size_t i=0; i < l_small.size(); ++i)
+                l_probability[l_small[i]] = 1;
+            for(std::size_t i=0; i < l_large.size(); ++i)
+                l_probability[l_large[i]] = 1;
+        }
+        
+        
+        // draw the elements
+        boost::variate_generator<boost::mt19937&, boost::uniform_int<std::size_t> > l_index( this->m_engine, boost::uniform_int<std::size_t>(0, l_size-1) );
+        boost::variate_generator<boost::mt19937&, boost::uniform_01<T> > l_coin( this->m_engine, boost::uniform_01<T>() );
+        
+        for(std::size_t i=p_start; i < p_end; ++i) {
+            const std::size_t n = l_index();
+            p_elite.push_back( p_population[ l_coin() < l_probability[n] ? n : l_alias[n] ] );
+        }
+    }
+    
+    
+}}}
+#endif
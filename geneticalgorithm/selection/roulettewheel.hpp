@@ -25,6 +25,8 @@
 #ifndef __MACHINELEARNING_GENETICALGORITHM_SELECTION_ROULETTEWHEEL_HPP
 #define __MACHINELEARNING_GENETICALGORITHM_SELECTION_ROULETTEWHEEL_HPP
 
+#include <vector>
+#include <algorithm>
 #include <boost/shared_ptr.hpp>
 #include <boost/static_assert.hpp>
 #include <boost/numeric/ublas/vector.hpp>
@@ -89,25 +91,22 @@ namespace machinelearning { namespace geneticalgorithm { namespace selection {
      **/
     template<typename T, typename L> inline void roulettewheel<T,L>::getElite( const std::size_t& p_start, const std::size_t& p_end, const std::vector< boost::shared_ptr< individual::individual<L> > >& p_population, const ublas::vector<T>& p_fitness, const ublas::vector<std::size_t>&, const ublas::vector<std::size_t>&, std::vector< boost::shared_ptr< individual::individual<L> > >& p_elite )
     {
-        // calculate probability
+        // calculate the cumulative probability in the order of the population
         const T l_max = ublas::sum(p_fitness);
         if (tools::function::isNumericalZero(l_max))
             throw exception::runtime(_("fitness values are all zero"), *this);
         
-        ublas::vector<T> l_probability( p_fitness / l_max );
-        ublas::vector<std::size_t> l_index( tools::vector::rankIndexVector( l_probability ) );
+        std::vector<T> l_cumulate( p_fitness.size() );
+        T l_sum = 0;
+        for(std::size_t i=0; i < p_fitness.size(); ++i) {
+            l_sum        += p_fitness(i) / l_max;
+            l_cumulate[i] = l_sum;
+        }
        
-        // get elements
+        // get elements, the element is found with a binary search over the cumulative probability
         for(std::size_t i=p_start; i < p_end; ++i) {
-
-            // determine random value
-            const T l_rand = m_random.get<T>(tools::random::uniform, 0.0, 1.0);
-            
-            // determine next element with the probability
-            std::size_t n  = 0;
-            for( ; (n < l_index.size()) && (l_probability[l_index[n]] <= l_rand ); ++n)
-                ;
-            n = std::min(n, l_index.size()-1);
+            const T l_rand      = m_random.get<T>(tools::random::uniform, 0.0, 1.0);
+            const std::size_t n = std::min( static_cast<std::size_t>(std::upper_bound(l_cumulate.begin(), l_cumulate.end(), l_rand) - l_cumulate.begin()), l_cumulate.size()-1 );
             
             p_elite.push_back( p_population[n] );
         }
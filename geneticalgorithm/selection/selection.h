@@ -35,6 +35,9 @@ namespace machinelearning { namespace geneticalgorithm {
 #include "selection.hpp"
 #include "roulettewheel.hpp"
 #include "bestof.hpp"
+#include "alias.hpp"
+#include "stochasticuniversal.hpp"
+#include "tournament.hpp"
 
 #endif
 
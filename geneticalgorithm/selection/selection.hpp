@@ -25,11 +25,15 @@
 #ifndef __MACHINELEARNING_GENETICALGORITHM_SELECTION_SELECTION_HPP
 #define __MACHINELEARNING_GENETICALGORITHM_SELECTION_SELECTION_HPP
 
+#include <omp.h>
+#include <boost/cstdint.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/static_assert.hpp>
+#include <boost/random/mersenne_twister.hpp>
 #include <boost/numeric/ublas/vector.hpp>
 
 #include "../individual/individual.hpp"
+#include "../../tools/tools.h"
 
 
 
@@ -78,6 +82,61 @@ namespace machinelearning { namespace geneticalgorithm { namespace selection {
         
     };
     
+    
+    
+    /** abstract class of a selection with a random generator. Each copy (clone) uses its own random stream,
+     * that is set by the seed and the thread id, so the threads do not share the generator
+     **/
+    template<typename T, typename L> class randomstream : public selection<T,L>
+    {
+        BOOST_STATIC_ASSERT( !boost::is_integral<T>::value );
+        
+        public :
+        
+            void onEachIteration( const std::vector< boost::shared_ptr< individual::individual<L> > >& );
+        
+        
+        protected :
+        
+            /** random generator **/
+            boost::mt19937 m_engine;
+        
+            randomstream( void );
+            randomstream( const randomstream<T,L>& );
+        
+        
+        private :
+        
+            /** seed of the random streams **/
+            boost::uint32_t m_seed;
+        
+    };
+    
+    
+    
+    /** constructor **/
+    template<typename T, typename L> inline randomstream<T,L>::randomstream( void ) :
+        m_engine( static_cast<boost::uint32_t>(tools::random().get<double>(tools::random::uniform, 0, 4294967296.0)) ),
+        m_seed( m_engine() )
+    {}
+    
+    
+    /** copy constructor, the copy uses the stream of the calling thread
+     * @param p_source source object
+     **/
+    template<typename T, typename L> inline randomstream<T,L>::randomstream( const randomstream<T,L>& p_source ) :
+        selection<T,L>( p_source ),
+        m_engine( static_cast<boost::uint32_t>(p_source.m_seed ^ ((static_cast<std::size_t>(omp_get_thread_num()) + 1) * 0x9e3779b9UL)) ),
+        m_seed( p_source.m_seed )
+    {}
+    
+    
+    /** changes the seed, so the clones of the next iteration use new streams **/
+    template<typename T, typename L> inline void randomstream<T,L>::onEachIteration( const std::vector< boost::shared_ptr< individual::individual<L> > >& )
+    {
+        m_seed = m_engine();
+    }
+    
 }}}
 #endif
 
@@ -0,0 +1,119 @@
+/** 
+ @cond
+ ############################################################################
+ # LGPL License                                                             #
+ #                                                                          #
+ # This file is part of the Machine Learning Framework.                     #
+ # Copyright (c) 2010-2012, Philipp Kraus, <philipp.kraus@flashpixx.de>     #
+ # This program is free software: you can redistribute it and/or modify     #
+ # it under the terms of the GNU Lesser General Public License as           #
+ # published by the Free Software Foundation, either version 3 of the       #
+ # License, or (at your option) any later version.                          #
+ #                                                                          #
+ # This program is distributed in the hope that it will be useful,          #
+ # but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+ # MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+ # GNU Lesser General Public License for more details.                      #
+ #                                                                          #
+ # You should have received a copy of the GNU Lesser General Public License #
+ # along with this program. If not, see <http://www.gnu.org/licenses/>.     #
+ ############################################################################
+ @endcond
+ **/
+
+
+
+#ifndef __MACHINELEARNING_GENETICALGORITHM_SELECTION_STOCHASTICUNIVERSAL_HPP
+#define __MACHINELEARNING_GENETICALGORITHM_SELECTION_STOCHASTICUNIVERSAL_HPP
+
+#include <boost/shared_ptr.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_01.hpp>
+#include <boost/random/uniform_int.hpp>
+#include <boost/random/variate_generator.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+
+#include "selection.hpp"
+#include "../individual/individual.hpp"
+#include "../../tools/tools.h"
+
+
+
+namespace machinelearning { namespace geneticalgorithm { namespace selection {
+    
+    
+    namespace ublas = boost::numeric::ublas;
+    
+    
+    /** class of the stochastic universal sampling. The elites are chosen with equally spaced pointers
+     * over the cumulative fitness values, so one random number and one pass are needed for all elites
+     **/
+    template<typename T, typename L> class stochasticuniversal : public randomstream<T,L>
+    {
+        BOOST_STATIC_ASSERT( !boost::is_integral<T>::value );
+        
+        public :
+        
+            stochasticuniversal( void );
+        
+            void clone( boost::shared_ptr< selection<T,L> >& p_ptr ) const;
+            void getElite( const std::size_t&, const std::size_t&, const std::vector< boost::shared_ptr< individual::individual<L> > >&, const ublas::vector<T>&, const ublas::vector<std::size_t>&, const ublas::vector<std::size_t>&,std::vector< boost::shared_ptr< individual::individual<L> > >&  );
+        
+    };
+    
+    
+    
+    /** constructor **/
+    template<typename T, typename L> inline stochasticuniversal<T,L>::stochasticuniversal( void ) :
+        randomstream<T,L>()
+    {}
+    
+    
+    /** method for cloning the object, for using on multithread
+     * @param p_ptr smart-pointer object
+     **/
+    template<typename T, typename L> inline void stochasticuniversal<T,L>::clone( boost::shared_ptr< selection<T,L> >& p_ptr ) const
+    {
+        p_ptr = boost::shared_ptr< selection<T,L> >( new stochasticuniversal<T,L>(*this) );
+    }
+    
+    
+    /** returns the elites of the stochastic universal sampling (if all values are zero, the elites are drawn uniformly)
+     * @param p_start start value of the elite values
+     * @param p_end end value of the elite values ([start, end) elite elements must be created)
+     * @param p_population const reference to the population
+     * @param p_fitness vector with fitnss values (index is equal to the index of the population)
+     * @param p_elite vector with elite individual
+     **/
+    template<typename T, typename L> inline void stochasticuniversal<T,L>::getElite( const std::size_t& p_start, const std::size_t& p_end, const std::vector< boost::shared_ptr< individual::individual<L> > >& p_population, const ublas::vector<T>& p_fitness, const ublas::vector<std::size_t>&, const ublas::vector<std::size_t>&, std::vector< boost::shared_ptr< individual::individual<L> > >& p_elite )
+    {
+        if (p_start >= p_end)
+            return;
+        
+        const T l_sum = ublas::sum(p_fitness);
+        
+        if (tools::function::isNumericalZero(l_sum)) {
+            boost::variate_generator<boost::mt19937&, boost::uniform_int<std::size_t> > l_index( this->m_engine, boost::uniform_int<std::size_t>(0, p_fitness.size()-1) );
+            for(std::size_t i=p_start; i < p_end; ++i)
+                p_elite.push_back( p_population[l_index()] );
+            return;
+        }
+        
+        // the pointers are set with the distance sum / number, the first one is set randomly within the first distance
+        const T l_step = l_sum / (p_end - p_start);
+        T l_pointer    = boost::variate_generator<boost::mt19937&, boost::uniform_01<T> >( this->m_engine, boost::uniform_01<T>() )() * l_step;
+        T l_cumulate   = p_fitness(0);
+        std::size_t n  = 0;
+        
+        for(std::size_t i=p_start; i < p_end; ++i, l_pointer += l_step) {
+            while ( (l_cumulate <= l_pointer) && (n < p_fitness.size()-1) )
+                l_cumulate += p_fitness(++n);
+            
+            p_elite.push_back( p_population[n] );
+        }
+    }
+    
+    
+}}}
+#endif
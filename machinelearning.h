@@ -664,6 +664,7 @@
  * @file geneticalgorithm/population.hpp population class
  * @file geneticalgorithm/fitness/fitness.h main header file for all fitness classes
  * @file geneticalgorithm/fitness/fitness.hpp abstract class of the fitness function
+ * @file geneticalgorithm/fitness/cache.hpp bounded thread-safe cache of fitness values
  * @file geneticalgorithm/individual/individual.h main header file for all individual classes
  * @file geneticalgorithm/individual/individual.hpp abstract class of an individual
  * @file geneticalgorithm/individual/binaryindividual.hpp implementation of a binary individual
@@ -674,6 +675,9 @@
  * @file geneticalgorithm/selection/selection.hpp abstract class of the selection function
  * @file geneticalgorithm/selection/roulettewheel.hpp class with roulette-wheel-selection
  * @file geneticalgorithm/selection/bestof.hpp abstract class with best-of-selection
+ * @file geneticalgorithm/selection/alias.hpp class with fitness proportional selection with an alias table
+ * @file geneticalgorithm/selection/stochasticuniversal.hpp class with stochastic universal sampling
+ * @file geneticalgorithm/selection/tournament.hpp class with tournament selection
  *
  * @file neighborhood/neighborhood.h main header for neighborhood structurs
  * @file neighborhood/neighborhood.hpp abstract class for neighborhood implementation
@@ -705,8 +709,11 @@
  * @file tools/files/hdf.hpp implementation for reading and writing hdf files
  
  * @file textprocess/textprocess.h main header for text processing algorithms
+ * @file textprocess/tokenizer.h streaming tokenizer with token spans
  * @file textprocess/termfrequency.h class for creating a term frequency structur of input text
  * @file textprocess/stopwordreduction.h class for stopword reduction
+ * @file textprocess/tfidf.hpp class for creating a sparse TF-IDF document-term matrix
+ * @file textprocess/signature.hpp class for MinHash / SimHash document signatures
  *
  * @file tools/iostreams/iostreams.h main header for iostreams includes
  * @file tools/iostreams/urlencoder.h encoder for url
@@ -0,0 +1,380 @@
+/** 
+ @cond
+ ############################################################################
+ # LGPL License                                                             #
+ #                                                                          #
+ # This file is part of the Machine Learning Framework.                     #
+ # Copyright (c) 2010-2012, Philipp Kraus, <philipp.kraus@flashpixx.de>     #
+ # This program is free software: you can redistribute it and/or modify     #
+ # it under the terms of the GNU Lesser General Public License as           #
+ # published by the Free Software Foundation, either version 3 of the       #
+ # License, or (at your option) any later version.                          #
+ #                                                                          #
+ # This program is distributed in the hope that it will be useful,          #
+ # but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+ # MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+ # GNU Lesser General Public License for more details.                      #
+ #                                                                          #
+ # You should have received a copy of the GNU Lesser General Public License #
+ # along with this program. If not, see <http://www.gnu.org/licenses/>.     #
+ ############################################################################
+ @endcond
+ **/
+
+
+
+
+#ifndef __MACHINELEARNING_TEXTPROCESS_SIGNATURE_HPP
+#define __MACHINELEARNING_TEXTPROCESS_SIGNATURE_HPP
+
+#include <omp.h>
+#include <string>
+#include <vector>
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/numeric/ublas/matrix_sparse.hpp>
+
+#include "../errorhandling/exception.hpp"
+#include "tokenizer.h"
+
+
+
+namespace machinelearning { namespace textprocess {
+    
+    #ifndef SWIG
+    namespace ublas = boost::numeric::ublas;
+    #endif
+    
+    
+    /** class for document signatures. MinHash sketches and SimHash fingerprints are created
+     * over word shingles in one pass of each document. Candidate pairs of similar documents are
+     * found with the banding of the MinHash sketches (locality sensitive hashing), so the
+     * similarity is estimated only for the candidates
+     **/
+    template<typename T> class signature
+    {
+        #ifndef SWIG
+        BOOST_STATIC_ASSERT( !boost::is_integral<T>::value );
+        #endif
+        
+        public:
+        
+            signature( const std::size_t& = 128, const std::size_t& = 3, const std::string& = ",;.:!?- \n\t|=", const std::string& = "#_()[]{}%$*/\\\"=|<>\r", const bool& = true );
+            void create( const std::vector<std::string>& );
+            std::size_t getDocumentCount( void ) const;
+            std::vector<boost::uint64_t> getMinHash( const std::size_t& ) const;
+            std::vector<boost::uint64_t> getSimHash( void ) const;
+            T getSimilarity( const std::size_t&, const std::size_t& ) const;
+            std::size_t getHammingDistance( const std::size_t&, const std::size_t& ) const;
+            std::vector< std::pair<std::size_t, std::size_t> > getCandidates( const std::size_t& ) const;
+            ublas::compressed_matrix<T> getSimilarityMatrix( const std::size_t&, const T& = 0 ) const;
+            std::vector<std::size_t> getUnique( const std::size_t&, const T& ) const;
+        
+        
+        private:
+        
+            /** tokenizer **/
+            const tokenizer m_tokenizer;
+            /** number of hash functions of the MinHash **/
+            const std::size_t m_hashes;
+            /** number of words of a shingle **/
+            const std::size_t m_shingle;
+            /** seeds of the hash functions **/
+            std::vector<boost::uint64_t> m_seeds;
+            /** MinHash sketches (row-wise for each document) **/
+            std::vector<boost::uint64_t> m_minhash;
+            /** SimHash fingerprints **/
+            std::vector<boost::uint64_t> m_simhash;
+        
+            static boost::uint64_t mix( boost::uint64_t );
+            void sketch( const boost::uint64_t&, const std::size_t&, std::vector<long>& );
+    };
+    
+    
+    
+    /** constructor
+     * @param p_hashes number of hash functions of the MinHash
+     * @param p_shingle number of words of a shingle
+     * @param p_separator characters for seperate words within the text
+     * @param p_remove string with characters that will be removed
+     * @param p_caseinsensitive words should be case-insensitive
+     **/
+    template<typename T> inline signature<T>::signature( const std::size_t& p_hashes, const std::size_t& p_shingle, const std::string& p_separator, const std::string& p_remove, const bool& p_caseinsensitive ) :
+        m_tokenizer( p_separator, p_remove, p_caseinsensitive ),
+        m_hashes( p_hashes ),
+        m_shingle( p_shingle ),
+        m_seeds( p_hashes ),
+        m_minhash(),
+        m_simhash()
+    {
+        if (m_hashes == 0)
+            throw exception::runtime(_("number of hash functions must be greater than zero"), *this);
+        if (m_shingle == 0)
+            throw exception::runtime(_("shingle size must be greater than zero"), *this);
+        
+        for(std::size_t i=0; i < m_seeds.size(); ++i)
+            m_seeds[i] = mix( static_cast<boost::uint64_t>(i+1) );
+    }
+    
+    
+    /** 64 bit finalizer (splitmix), that is used as hash function family
+     * @param p_value value
+     * @return mixed value
+     **/
+    template<typename T> inline boost::uint64_t signature<T>::mix( boost::uint64_t p_value )
+    {
+        p_value += 0x9E3779B97F4A7C15ULL;
+        p_value  = (p_value ^ (p_value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        p_value  = (p_value ^ (p_value >> 27)) * 0x94D049BB133111EBULL;
+        return p_value ^ (p_value >> 31);
+    }
+    
+    
+    /** adds a shingle to the MinHash sketch and the SimHash counts of a document
+     * @param p_shingle shingle hash
+     * @param p_document document index
+     * @param p_bits SimHash bit counts
+     **/
+    template<typename T> inline void signature<T>::sketch( const boost::uint64_t& p_shingle, const std::size_t& p_document, std::vector<long>& p_bits )
+    {
+        boost::uint64_t* l_sketch = &m_minhash[p_document * m_hashes];
+        for(std::size_t i=0; i < m_hashes; ++i)
+            l_sketch[i] = std::min( l_sketch[i], mix(p_shingle ^ m_seeds[i]) );
+        
+        for(std::size_t i=0; i < 64; ++i)
+            p_bits[i] += ((p_shingle >> i) & 1) ? 1 : -1;
+    }
+    
+    
+    /** creates the signatures of the documents, each document is read once
+     * @param p_documents documents
+     **/
+    template<typename T> inline void signature<T>::create( const std::vector<std::string>& p_documents )
+    {
+        m_minhash.assign( p_documents.size() * m_hashes, std::numeric_limits<boost::uint64_t>::max() );
+        m_simhash.assign( p_documents.size(), 0 );
+        
+        #pragma omp parallel
+        {
+            tokenizer l_tokenizer( m_tokenizer );
+            std::vector<boost::uint64_t> l_window( m_shingle );
+            std::vector<long> l_bits( 64 );
+            
+            #pragma omp for schedule(dynamic)
+            for(std::size_t i=0; i < p_documents.size(); ++i) {
+                
+                std::fill( l_bits.begin(), l_bits.end(), 0 );
+                std::size_t l_words = 0;
+                
+                // the shingle hash combines the hashes of the last words (ring buffer)
+                l_tokenizer.setBuffer( p_documents[i] );
+                for(tokenizer::token l_token; l_tokenizer.next(l_token); ) {
+                    l_window[l_words % m_shingle] = l_token.hash();
+                    l_words++;
+                    if (l_words < m_shingle)
+                        continue;
+                    
+                    boost::uint64_t l_shingle = 0;
+                    for(std::size_t j=l_words-m_shingle; j < l_words; ++j)
+                        l_shingle = mix( l_shingle ^ l_window[j % m_shingle] );
+                    sketch( l_shingle, i, l_bits );
+                }
+                
+                // documents with less words than the shingle size are one shingle
+                if ( (l_words > 0) && (l_words < m_shingle) ) {
+                    boost::uint64_t l_shingle = 0;
+                    for(std::size_t j=0; j < l_words; ++j)
+                        l_shingle = mix( l_shingle ^ l_window[j] );
+                    sketch( l_shingle, i, l_bits );
+                }
+                
+                if (l_words > 0)
+                    for(std::size_t j=0; j < 64; ++j)
+                        if (l_bits[j] > 0)
+                            m_simhash[i] |= static_cast<boost::uint64_t>(1) << j;
+            }
+        }
+    }
+    
+    
+    /** returns the number of documents
+     * @return number of documents
+     **/
+    template<typename T> inline std::size_t signature<T>::getDocumentCount( void ) const
+    {
+        return m_simhash.size();
+    }
+    
+    
+    /** returns the MinHash sketch of a document
+     * @param p_document document index
+     * @return sketch
+     **/
+    template<typename T> inline std::vector<boost::uint64_t> signature<T>::getMinHash( const std::size_t& p_document ) const
+    {
+        if (p_document >= m_simhash.size())
+            throw exception::runtime(_("document index out of range"), *this);
+        
+        return std::vector<boost::uint64_t>( m_minhash.begin() + p_document * m_hashes, m_minhash.begin() + (p_document+1) * m_hashes );
+    }
+    
+    
+    /** returns the SimHash fingerprints of all documents
+     * @return fingerprints
+     **/
+    template<typename T> inline std::vector<boost::uint64_t> signature<T>::getSimHash( void ) const
+    {
+        return m_simhash;
+    }
+    
+    
+    /** returns the estimated Jaccard similarity of two documents (fraction of equal MinHash values)
+     * @param p_first first document index
+     * @param p_second second document index
+     * @return similarity
+     **/
+    template<typename T> inline T signature<T>::getSimilarity( const std::size_t& p_first, const std::size_t& p_second ) const
+    {
+        if ( (p_first >= m_simhash.size()) || (p_second >= m_simhash.size()) )
+            throw exception::runtime(_("document index out of range"), *this);
+        
+        const boost::uint64_t* l_first  = &m_minhash[p_first * m_hashes];
+        const boost::uint64_t* l_second = &m_minhash[p_second * m_hashes];
+        
+        std::size_t l_equal = 0;
+        for(std::size_t i=0; i < m_hashes; ++i)
+            if (l_first[i] == l_second[i])
+                l_equal++;
+        
+        return static_cast<T>(l_equal) / static_cast<T>(m_hashes);
+    }
+    
+    
+    /** returns the Hamming distance of the SimHash fingerprints of two documents
+     * @param p_first first document index
+     * @param p_second second document index
+     * @return number of different bits
+     **/
+    template<typename T> inline std::size_t signature<T>::getHammingDistance( const std::size_t& p_first, const std::size_t& p_second ) const
+    {
+        if ( (p_first >= m_simhash.size()) || (p_second >= m_simhash.size()) )
+            throw exception::runtime(_("document index out of range"), *this);
+        
+        std::size_t l_count = 0;
+        for(boost::uint64_t l_bits = m_simhash[p_first] ^ m_simhash[p_second]; l_bits != 0; l_bits &= l_bits-1)
+            l_count++;
+        
+        return l_count;
+    }
+    
+    
+    /** returns the candidate pairs of the banding. The sketches are split into bands, documents
+     * with an equal band are candidates. With b bands of r rows a pair with the similarity s is
+     * a candidate with the probability 1-(1-s^r)^b
+     * @param p_bands number of bands (must divide the number of hash functions)
+     * @return sorted pairs (i,j) with i < j
+     **/
+    template<typename T> inline std::vector< std::pair<std::size_t, std::size_t> > signature<T>::getCandidates( const std::size_t& p_bands ) const
+    {
+        if ( (p_bands == 0) || (m_hashes % p_bands != 0) )
+            throw exception::runtime(_("number of bands must divide the number of hash functions"), *this);
+        
+        const std::size_t l_rows = m_hashes / p_bands;
+        const std::size_t l_documents = m_simhash.size();
+        std::vector< std::vector< std::pair<std::size_t, std::size_t> > > l_bandpairs( p_bands );
+        
+        // each band sorts the documents by the band hash, equal hashes are checked on the band values
+        #pragma omp parallel for schedule(dynamic) shared(l_bandpairs)
+        for(std::size_t b=0; b < p_bands; ++b) {
+            std::vector< std::pair<boost::uint64_t, std::size_t> > l_keys( l_documents );
+            for(std::size_t i=0; i < l_documents; ++i) {
+                boost::uint64_t l_key = b;
+                for(std::size_t j=0; j < l_rows; ++j)
+                    l_key = mix( l_key ^ m_minhash[i * m_hashes + b * l_rows + j] );
+                l_keys[i] = std::make_pair( l_key, i );
+            }
+            std::sort( l_keys.begin(), l_keys.end() );
+            
+            for(std::size_t i=0; i < l_keys.size(); ) {
+                std::size_t l_end = i+1;
+                while ( (l_end < l_keys.size()) && (l_keys[l_end].first == l_keys[i].first) )
+                    l_end++;
+                
+                for(std::size_t j=i; j < l_end; ++j)
+                    for(std::size_t k=j+1; k < l_end; ++k)
+                        if (std::equal( &m_minhash[l_keys[j].second * m_hashes + b * l_rows], &m_minhash[l_keys[j].second * m_hashes + (b+1) * l_rows], &m_minhash[l_keys[k].second * m_hashes + b * l_rows] ))
+                            l_bandpairs[b].push_back( std::make_pair(l_keys[j].second, l_keys[k].second) );
+                
+                i = l_end;
+            }
+        }
+        
+        std::vector< std::pair<std::size_t, std::size_t> > l_pairs;
+        for(std::size_t b=0; b < p_bands; ++b)
+            l_pairs.insert( l_pairs.end(), l_bandpairs[b].begin(), l_bandpairs[b].end() );
+        
+        std::sort( l_pairs.begin(), l_pairs.end() );
+        l_pairs.erase( std::unique(l_pairs.begin(), l_pairs.end()), l_pairs.end() );
+        
+        return l_pairs;
+    }
+    
+    
+    /** returns the estimated Jaccard similarities of the candidate pairs as symmetric sparse matrix
+     * @param p_bands number of bands (must divide the number of hash functions)
+     * @param p_threshold only similarities equal or greater are stored
+     * @return sparse similarity matrix
+     **/
+    template<typename T> inline ublas::compressed_matrix<T> signature<T>::getSimilarityMatrix( const std::size_t& p_bands, const T& p_threshold ) const
+    {
+        const std::vector< std::pair<std::size_t, std::size_t> > l_pairs = getCandidates( p_bands );
+        std::vector<T> l_similarity( l_pairs.size() );
+        
+        #pragma omp parallel for shared(l_similarity)
+        for(std::size_t i=0; i < l_pairs.size(); ++i)
+            l_similarity[i] = getSimilarity( l_pairs[i].first, l_pairs[i].second );
+        
+        // both triangles are stored, so the entries are sorted by row and column before appending
+        std::vector< std::pair< std::pair<std::size_t, std::size_t>, T > > l_entries;
+        for(std::size_t i=0; i < l_pairs.size(); ++i)
+            if (l_similarity[i] >= p_threshold) {
+                l_entries.push_back( std::make_pair(l_pairs[i], l_similarity[i]) );
+                l_entries.push_back( std::make_pair(std::make_pair(l_pairs[i].second, l_pairs[i].first), l_similarity[i]) );
+            }
+        std::sort( l_entries.begin(), l_entries.end() );
+        
+        ublas::compressed_matrix<T> l_matrix( m_simhash.size(), m_simhash.size(), l_entries.size() );
+        for(std::size_t i=0; i < l_entries.size(); ++i)
+            l_matrix.push_back( l_entries[i].first.first, l_entries[i].first.second, l_entries[i].second );
+        
+        return l_matrix;
+    }
+    
+    
+    /** returns the documents, that are not a near-duplicate of a document with a lower index
+     * @param p_bands number of bands (must divide the number of hash functions)
+     * @param p_threshold similarity threshold of near-duplicates
+     * @return sorted document indices
+     **/
+    template<typename T> inline std::vector<std::size_t> signature<T>::getUnique( const std::size_t& p_bands, const T& p_threshold ) const
+    {
+        const std::vector< std::pair<std::size_t, std::size_t> > l_pairs = getCandidates( p_bands );
+        
+        std::vector<bool> l_duplicate( m_simhash.size(), false );
+        for(std::size_t i=0; i < l_pairs.size(); ++i)
+            if ( (!l_duplicate[l_pairs[i].first]) && (getSimilarity(l_pairs[i].first, l_pairs[i].second) >= p_threshold) )
+                l_duplicate[l_pairs[i].second] = true;
+        
+        std::vector<std::size_t> l_unique;
+        for(std::size_t i=0; i < l_duplicate.size(); ++i)
+            if (!l_duplicate[i])
+                l_unique.push_back(i);
+        
+        return l_unique;
+    }
+    
+}}
+#endif
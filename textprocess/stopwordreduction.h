@@ -27,12 +27,16 @@
 #define __MACHINELEARNING_TEXTPROCESS_STOPWORDREDUCTION_H
 
 #include <string>
+#include <vector>
+#include <cstring>
 #include <sstream>
 #include <iostream>
 #include <boost/regex.hpp> 
+#include <boost/cstdint.hpp>
 #include <boost/xpressive/xpressive.hpp>
 
 #include "../errorhandling/exception.hpp"
+#include "tokenizer.h"
 
 
 
@@ -41,15 +45,22 @@ namespace machinelearning { namespace textprocess {
     namespace xps = boost::xpressive;
     
     
-    /** class for stop-word-reduction
-     * @todo try to optimize with http://en.wikipedia.org/wiki/Ukkonen%27s_algorithm / http://en.wikipedia.org/wiki/Radix_tree
+    /** class for stop-word-reduction. The default engine tokenizes the text once into word runs
+     * and looks each run up in a hash table, that is built in the constructor. The regular expression
+     * engine is the former implementation, both engines create the same output
      **/
     class stopwordreduction
     {
         
         public:
         
-            stopwordreduction( const std::vector<std::string>&, const bool& = true );
+            enum engine {
+                hashtable   = 0,
+                regex       = 1
+            };
+        
+        
+            stopwordreduction( const std::vector<std::string>&, const bool& = true, const engine& = hashtable );
         
             std::string remove( const std::string& ) const;
             bool iscaseinsensitivity( void ) const;
@@ -57,13 +68,42 @@ namespace machinelearning { namespace textprocess {
         
         private:
         
+            /** stop word entry of the hash table **/
+            struct entry
+            {
+                /** word (lower-case on case-insensitivity) **/
+                std::string word;
+                /** position within the stop word list **/
+                std::size_t order;
+                /** length of the first word run **/
+                std::size_t prefix;
+                /** hash of the first word run **/
+                boost::uint64_t hash;
+            };
+        
+        
+            /** engine **/
+            const engine m_engine;
             /** expression stop word - use xpressive interface for big expressions
              * because the default interface does not work with the expression 
              **/
             xps::sregex m_stopwordsexpr;
             /** bool for case-sensitive / case-insensitive wordlist **/
             const bool m_caseinsensitive;
+            /** word character table like the word class of the regular expression **/
+            bool m_isword[256];
+            /** tokenizer, that splits the text into word runs **/
+            tokenizer m_tokenizer;
+            /** stop words **/
+            std::vector<entry> m_entries;
+            /** open addressing table with entry index + 1 (linear probing) **/
+            std::vector<std::size_t> m_table;
         
+            static tokenizer createTokenizer( void );
+            char fold( const char& ) const;
+            boost::uint64_t hash( const char*, const std::size_t& ) const;
+            bool equal( const char*, const char*, const std::size_t& ) const;
+            std::size_t match( const char*, const char*, const char* ) const;
     };
     
     
@@ -71,14 +111,60 @@ namespace machinelearning { namespace textprocess {
     /** constructor
      * @param p_list list with stopwords
      * @param p_caseinsensitive words should be case-insensitive
+     * @param p_engine engine for removing the words
      **/
-    inline stopwordreduction::stopwordreduction( const std::vector<std::string>& p_list, const bool& p_caseinsensitive ) :
+    inline stopwordreduction::stopwordreduction( const std::vector<std::string>& p_list, const bool& p_caseinsensitive, const engine& p_engine ) :
+        m_engine( p_engine ),
         m_stopwordsexpr(),
-        m_caseinsensitive( p_caseinsensitive )
+        m_caseinsensitive( p_caseinsensitive ),
+        m_tokenizer( createTokenizer() ),
+        m_entries(),
+        m_table()
     {
         if (p_list.size() == 0)
             throw exception::runtime(_("stopwordlist can not be empty"), *this);
         
+        for(std::size_t i=0; i < 256; ++i)
+            m_isword[i] = ((i >= '0') && (i <= '9')) || ((i >= 'a') && (i <= 'z')) || ((i >= 'A') && (i <= 'Z')) || (i == '_');
+        
+        if (m_engine == hashtable) {
+            
+            // words, that does not start and end with a word character, can never match within word boundaries
+            for(std::size_t i=0; i < p_list.size(); ++i) {
+                const std::string& l_word = p_list[i];
+                if ( (l_word.empty()) || (!m_isword[static_cast<unsigned char>(l_word[0])]) || (!m_isword[static_cast<unsigned char>(l_word[l_word.size()-1])]) )
+                    continue;
+                
+                entry l_entry;
+                l_entry.word    = l_word;
+                l_entry.order   = i;
+                l_entry.prefix  = 0;
+                while ( (l_entry.prefix < l_word.size()) && (m_isword[static_cast<unsigned char>(l_word[l_entry.prefix])]) )
+                    l_entry.prefix++;
+                if (m_caseinsensitive)
+                    for(std::size_t j=0; j < l_entry.word.size(); ++j)
+                        l_entry.word[j] = fold(l_entry.word[j]);
+                l_entry.hash    = hash( l_entry.word.data(), l_entry.prefix );
+                
+                m_entries.push_back( l_entry );
+            }
+            
+            // table with a load factor lower than 0.5, entries with equal first runs are on one probe chain
+            std::size_t l_size = 16;
+            while (l_size < 2*m_entries.size())
+                l_size *= 2;
+            m_table.resize( l_size, 0 );
+            
+            for(std::size_t i=0; i < m_entries.size(); ++i) {
+                std::size_t j = static_cast<std::size_t>(m_entries[i].hash) & (l_size-1);
+                while (m_table[j] != 0)
+                    j = (j+1) & (l_size-1);
+                m_table[j] = i+1;
+            }
+            
+            return;
+        }
+        
         // we create a regular expression with perl syntax (default) for masking chars within the words,
         // that are also used for regular expressions
         const boost::regex l_mask("\\.|\\[|\\]|\\{|\\}|\\(|\\)|\\\\|\\*|\\+|\\?|\\||\\^|\\$|<|>");
@@ -120,7 +206,130 @@ namespace machinelearning { namespace textprocess {
      **/
     inline std::string stopwordreduction::remove( const std::string& p_text ) const
     {
-        return xps::regex_replace(p_text, m_stopwordsexpr, ""); //, boost::match_default | boost::format_all);
+        if (m_engine == regex)
+            return xps::regex_replace(p_text, m_stopwordsexpr, ""); //, boost::match_default | boost::format_all);
+        
+        std::string l_result;
+        l_result.reserve( p_text.size() );
+        
+        const char* l_begin = p_text.data();
+        const char* l_end   = l_begin + p_text.size();
+        const char* l_copy  = l_begin;
+        
+        tokenizer l_tokenizer( m_tokenizer );
+        l_tokenizer.setBuffer( l_begin, l_end );
+        
+        // each word run starts on a word boundary, runs within a removed
+        // multi-word stop word are skipped like the regular expression does
+        for(tokenizer::token l_token; l_tokenizer.next(l_token); ) {
+            if (l_token.data() < l_copy)
+                continue;
+            
+            const std::size_t l_length = match( l_token.data(), l_token.data()+l_token.size(), l_end );
+            if (l_length == 0)
+                continue;
+            
+            l_result.append( l_copy, l_token.data() );
+            l_copy = l_token.data() + l_length;
+        }
+        
+        l_result.append( l_copy, l_end );
+        return l_result;
+    }
+    
+    
+    /** creates the tokenizer, that separates on all non-word characters
+     * @return tokenizer
+     **/
+    inline tokenizer stopwordreduction::createTokenizer( void )
+    {
+        std::string l_separator;
+        for(std::size_t i=0; i < 256; ++i)
+            if ( !(((i >= '0') && (i <= '9')) || ((i >= 'a') && (i <= 'z')) || ((i >= 'A') && (i <= 'Z')) || (i == '_')) )
+                l_separator.push_back( static_cast<char>(i) );
+        
+        return tokenizer( l_separator );
+    }
+    
+    
+    /** folds a character on case-insensitivity (ASCII, like the icase flag of the regular expression)
+     * @param p_char character
+     * @return folded character
+     **/
+    inline char stopwordreduction::fold( const char& p_char ) const
+    {
+        return (m_caseinsensitive && (p_char >= 'A') && (p_char <= 'Z')) ? static_cast<char>(p_char - 'A' + 'a') : p_char;
+    }
+    
+    
+    /** FNV-1a hash of the folded characters
+     * @param p_data pointer to the data
+     * @param p_length length
+     * @return hash
+     **/
+    inline boost::uint64_t stopwordreduction::hash( const char* p_data, const std::size_t& p_length ) const
+    {
+        boost::uint64_t l_hash = 14695981039346656037ULL;
+        for(std::size_t i=0; i < p_length; ++i) {
+            l_hash ^= static_cast<unsigned char>(fold(p_data[i]));
+            l_hash *= 1099511628211ULL;
+        }
+        return l_hash;
+    }
+    
+    
+    /** compares text with a folded stop word
+     * @param p_text text
+     * @param p_word stop word
+     * @param p_length length
+     * @return equality
+     **/
+    inline bool stopwordreduction::equal( const char* p_text, const char* p_word, const std::size_t& p_length ) const
+    {
+        if (!m_caseinsensitive)
+            return std::memcmp( p_text, p_word, p_length ) == 0;
+        
+        for(std::size_t i=0; i < p_length; ++i)
+            if (fold(p_text[i]) != p_word[i])
+                return false;
+        return true;
+    }
+    
+    
+    /** returns the length of the stop word, that matches on a word run. On
+     * more matches the first word of the list is used like the alternation does
+     * @param p_begin begin of the word run
+     * @param p_end end of the word run
+     * @param p_textend end of the text
+     * @return length of the match or zero
+     **/
+    inline std::size_t stopwordreduction::match( const char* p_begin, const char* p_end, const char* p_textend ) const
+    {
+        const std::size_t l_run   = static_cast<std::size_t>(p_end - p_begin);
+        const boost::uint64_t l_hash = hash( p_begin, l_run );
+        const std::size_t l_mask  = m_table.size() - 1;
+        
+        std::size_t l_order  = 0;
+        std::size_t l_length = 0;
+        
+        for(std::size_t i = static_cast<std::size_t>(l_hash) & l_mask; m_table[i] != 0; i = (i+1) & l_mask) {
+            const entry& l_entry = m_entries[m_table[i]-1];
+            
+            if ( (l_entry.hash != l_hash) || (l_entry.prefix != l_run) || ((l_length > 0) && (l_entry.order >= l_order)) )
+                continue;
+            if ( (l_entry.word.size() > static_cast<std::size_t>(p_textend - p_begin)) || (!equal(p_begin, l_entry.word.data(), l_entry.word.size())) )
+                continue;
+            
+            // multi-word stop words must end on a word boundary
+            const char* l_last = p_begin + l_entry.word.size();
+            if ( (l_last != p_textend) && (m_isword[static_cast<unsigned char>(*l_last)]) )
+                continue;
+            
+            l_order  = l_entry.order;
+            l_length = l_entry.word.size();
+        }
+        
+        return l_length;
     }
 
 }}
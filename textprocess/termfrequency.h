@@ -26,12 +26,18 @@
 #ifndef __MACHINELEARNING_TEXTPROCESS_TERMFREQUENCY_H
 #define __MACHINELEARNING_TEXTPROCESS_TERMFREQUENCY_H
 
+#include <omp.h>
 #include <map>
 #include <string>
+#include <vector>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <boost/cstdint.hpp>
 #include <boost/algorithm/string.hpp> 
-#include <boost/algorithm/string/erase.hpp>
 
 #include "../errorhandling/exception.hpp"
+#include "tokenizer.h"
 
 
 
@@ -39,7 +45,8 @@ namespace machinelearning { namespace textprocess {
 
     
     /** class for term frequency. The class analyses texts and create a map with word counts,
-     * that can be used for stop-word-reduction
+     * that can be used for stop-word-reduction. The counting runs on thread-local open addressing
+     * hash tables, which are sharded by the term hash and merged lock-free at the end of each add call
      **/
     class termfrequency
     {
@@ -57,6 +64,7 @@ namespace machinelearning { namespace textprocess {
             termfrequency( const std::string& = ",;.:!?- \n\t|=", const std::string& = "#_()[]{}%$*/\\\"=|<>\r", const bool& = true );
             void add( const std::string&, const std::size_t& = 0 );
             void add( const std::vector<std::string>&, const std::size_t& = 2 );
+            void addFile( const std::string&, const std::size_t& = 0 );
             bool iscaseinsensitivity( void ) const;
             std::size_t getTermCount( void ) const;
             std::string getTermSeparator( void ) const;
@@ -68,19 +76,61 @@ namespace machinelearning { namespace textprocess {
         
         
         private:
+        
+            /** open addressing hash table (linear probing) with interned term strings **/
+            class termtable
+            {
+                public :
+                
+                    termtable( void );
+                    void add( const char*, const std::size_t&, const boost::uint64_t&, const std::size_t& );
+                    void merge( const termtable& );
+                    std::size_t erase( const std::string&, const boost::uint64_t& );
+                    void clear( void );
+                    std::size_t size( void ) const;
+                    std::size_t count( const std::size_t& ) const;
+                    std::string term( const std::size_t& ) const;
+                
+                private :
+                
+                    /** table slot, a zero length marks an empty slot, a zero count an erased term **/
+                    struct slot
+                    {
+                        boost::uint64_t hash;
+                        std::size_t offset;
+                        std::size_t length;
+                        std::size_t count;
+                    };
+                
+                    /** slots (size is a power of two) **/
+                    std::vector<slot> m_slots;
+                    /** arena with the interned term strings **/
+                    std::vector<char> m_strings;
+                    /** number of used slots **/
+                    std::size_t m_used;
+                
+                    std::size_t find( const char*, const std::size_t&, const boost::uint64_t& ) const;
+                    void grow( void );
+            };
+            
             
-            /** seperators **/
-            const std::string m_seperators;   
-            /** chars that will be removed **/
-            const std::string m_remove;
-            /** bool for case-sensitive / case-insensitive wordlist **/
-            const bool m_caseinsensitive;
-            /** map with words and their counts **/
-            std::map<std::string, std::size_t> m_map;
+            /** number of shards **/
+            static const std::size_t m_shardcount = 64;
+            /** minimal text chunk size of a thread **/
+            static const std::size_t m_chunksize = 65536;
+        
+            /** tokenizer with separators, removed chars and case folding **/
+            const tokenizer m_tokenizer;
+            /** sharded tables with words and their counts **/
+            std::vector<termtable> m_shards;
             /** sum over all words **/
             std::size_t m_wordcount;
         
             bool compare( const float&, const float&, const comparison& ) const;
+            static std::size_t shard( const boost::uint64_t& );
+            void add( const char*, const char*, const std::size_t& );
+            void count( const char*, const char*, const std::size_t&, std::vector<termtable>&, std::size_t& ) const;
+            void merge( const std::vector< std::vector<termtable> >&, const std::vector<std::size_t>& );
     };
     
     
@@ -91,15 +141,10 @@ namespace machinelearning { namespace textprocess {
      * @param p_caseinsensitive words should be case-insensitive
      **/
     inline termfrequency::termfrequency( const std::string& p_separator, const std::string& p_remove, const bool& p_caseinsensitive ) :
-        m_seperators( p_separator ),
-        m_remove( p_remove ),
-        m_caseinsensitive( p_caseinsensitive ),
-        m_map(),
+        m_tokenizer( p_separator, p_remove, p_caseinsensitive ),
+        m_shards( m_shardcount ),
         m_wordcount( 0 )
-    {
-        if (m_seperators.empty())
-            throw exception::runtime(_("separator can not be empty"), *this);
-    }
+    {}
     
     
     /** returns the value for case-sensitive words
@@ -107,7 +152,7 @@ namespace machinelearning { namespace textprocess {
      **/
     inline bool termfrequency::iscaseinsensitivity( void ) const
     {
-        return m_caseinsensitive;
+        return m_tokenizer.iscaseinsensitivity();
     }
     
     
@@ -125,7 +170,7 @@ namespace machinelearning { namespace textprocess {
      **/
     inline std::string termfrequency::getTermSeparator( void ) const
     {
-        return m_seperators;
+        return m_tokenizer.getSeparator();
     }
 
     
@@ -134,18 +179,37 @@ namespace machinelearning { namespace textprocess {
      **/
     inline std::map<std::string, std::size_t> termfrequency::getMap( void ) const
     {
-        return m_map;
+        std::map<std::string, std::size_t> l_map;
+        
+        for(std::size_t i=0; i < m_shards.size(); ++i)
+            for(std::size_t j=0; j < m_shards[i].size(); ++j)
+                if (m_shards[i].count(j) > 0)
+                    l_map[ m_shards[i].term(j) ] = m_shards[i].count(j);
+        
+        return l_map;
     }
     
     
-    /** adds a string vector to the map
+    /** adds a string vector to the map, each thread counts a part of
+     * the documents into its own tables
      * @param p_vec string vector with data
      * @param p_minlen only word equal or greater will be added
      **/
     inline void termfrequency::add( const std::vector<std::string>& p_vec, const std::size_t& p_minlen )
     {
-        for(std::size_t i=0; i < p_vec.size(); ++i)
-            add( p_vec[i], p_minlen );
+        std::vector< std::vector<termtable> > l_tables( static_cast<std::size_t>(omp_get_max_threads()), std::vector<termtable>(m_shardcount) );
+        std::vector<std::size_t> l_count( l_tables.size(), 0 );
+        
+        #pragma omp parallel shared(l_tables, l_count)
+        {
+            const std::size_t l_thread = static_cast<std::size_t>(omp_get_thread_num());
+            
+            #pragma omp for schedule(dynamic)
+            for(std::size_t i=0; i < p_vec.size(); ++i)
+                count( p_vec[i].data(), p_vec[i].data()+p_vec[i].size(), p_minlen, l_tables[l_thread], l_count[l_thread] );
+        }
+        
+        merge( l_tables, l_count );
     }
     
     
@@ -155,32 +219,113 @@ namespace machinelearning { namespace textprocess {
      **/
     inline void termfrequency::add( const std::string& p_text, const std::size_t& p_minlen )
     {
-        std::vector<std::string> l_data;
-        boost::split( l_data, p_text, boost::is_any_of(m_seperators) );
-        
-        #pragma omp parallel for
-        for(std::size_t i=0; i < l_data.size(); ++i) {
-            std::string l_item = l_data[i];
-            if (!m_remove.empty())
-                boost::erase_all(l_item, m_remove);
-            boost::trim(l_item);
-            
-            if ( (l_item.length() < p_minlen) || (l_item.empty()) )
-                continue;
-                
-            if (m_caseinsensitive)
-                boost::to_lower(l_item);
-            
-            std::map<std::string, std::size_t>::iterator it = m_map.find(l_item);
-            #pragma omp critical
-            {
-                m_wordcount++;
-                if (it == m_map.end())
-                    m_map[l_item] = 1;
-                else
-                    it->second++;
-            }
+        add( p_text.data(), p_text.data()+p_text.size(), p_minlen );
+    }
+    
+    
+    /** adds the content of a file to the term frequency, the
+     * file is memory-mapped and not read into a string
+     * @param p_file filename
+     * @param p_minlen only word equal or greater will be added
+     **/
+    inline void termfrequency::addFile( const std::string& p_file, const std::size_t& p_minlen )
+    {
+        // empty files can not be mapped, so they are skipped
+        std::ifstream l_stream( p_file.c_str(), std::ios::in | std::ios::binary | std::ios::ate );
+        if (!l_stream.is_open())
+            throw exception::runtime(_("file can not be opened"), *this);
+        if (l_stream.tellg() <= 0)
+            return;
+        l_stream.close();
+        
+        bio::mapped_file_source l_file;
+        try {
+            l_file.open( p_file );
+        } catch (...) {
+            throw exception::runtime(_("file can not be opened"), *this);
         }
+        
+        add( l_file.data(), l_file.data()+l_file.size(), p_minlen );
+    }
+    
+    
+    /** adds a text buffer to the term frequency. The buffer is cut at separator
+     * positions into one chunk for each thread
+     * @param p_begin begin of the text
+     * @param p_end end of the text
+     * @param p_minlen only word equal or greater will be added
+     **/
+    inline void termfrequency::add( const char* p_begin, const char* p_end, const std::size_t& p_minlen )
+    {
+        const std::size_t l_size   = static_cast<std::size_t>(p_end - p_begin);
+        const std::size_t l_chunks = std::max( static_cast<std::size_t>(1), std::min( static_cast<std::size_t>(omp_get_max_threads()), l_size / m_chunksize ) );
+        
+        // chunk bounds are moved behind the next separator, so no word is split
+        std::vector<std::size_t> l_bound( l_chunks+1, l_size );
+        l_bound[0] = 0;
+        for(std::size_t i=1; i < l_chunks; ++i) {
+            std::size_t l_pos = std::max( l_bound[i-1], i * (l_size / l_chunks) );
+            while ( (l_pos < l_size) && (l_pos > 0) && (!m_tokenizer.isseparator(p_begin[l_pos-1])) )
+                l_pos++;
+            l_bound[i] = l_pos;
+        }
+        
+        std::vector< std::vector<termtable> > l_tables( l_chunks, std::vector<termtable>(m_shardcount) );
+        std::vector<std::size_t> l_count( l_chunks, 0 );
+        
+        #pragma omp parallel for shared(l_tables, l_count, l_bound)
+        for(std::size_t i=0; i < l_chunks; ++i)
+            count( p_begin+l_bound[i], p_begin+l_bound[i+1], p_minlen, l_tables[i], l_count[i] );
+        
+        merge( l_tables, l_count );
+    }
+    
+    
+    /** counts the words of a text range into thread-local tables
+     * @param p_begin begin of the text
+     * @param p_end end of the text
+     * @param p_minlen only word equal or greater will be added
+     * @param p_tables thread-local shard tables
+     * @param p_count thread-local word count
+     **/
+    inline void termfrequency::count( const char* p_begin, const char* p_end, const std::size_t& p_minlen, std::vector<termtable>& p_tables, std::size_t& p_count ) const
+    {
+        tokenizer l_tokenizer( m_tokenizer );
+        l_tokenizer.setBuffer( p_begin, p_end );
+        
+        for(tokenizer::token l_token; l_tokenizer.next(l_token, p_minlen); ) {
+            const boost::uint64_t l_hash = l_token.hash();
+            p_tables[ shard(l_hash) ].add( l_token.data(), l_token.size(), l_hash, 1 );
+            p_count++;
+        }
+    }
+    
+    
+    /** merges thread-local tables into the shards, each shard is
+     * merged by one thread, so no lock is needed
+     * @param p_tables thread-local tables
+     * @param p_count thread-local word counts
+     **/
+    inline void termfrequency::merge( const std::vector< std::vector<termtable> >& p_tables, const std::vector<std::size_t>& p_count )
+    {
+        #pragma omp parallel for schedule(dynamic)
+        for(std::size_t i=0; i < m_shards.size(); ++i)
+            for(std::size_t j=0; j < p_tables.size(); ++j)
+                m_shards[i].merge( p_tables[j][i] );
+        
+        for(std::size_t i=0; i < p_count.size(); ++i)
+            m_wordcount += p_count[i];
+    }
+    
+    
+    /** returns the shard of a hash, the high bits are used, because
+     * the tables probe with the low bits
+     * @param p_hash hash
+     * @return shard index
+     **/
+    inline std::size_t termfrequency::shard( const boost::uint64_t& p_hash )
+    {
+        return static_cast<std::size_t>(p_hash >> 58) % m_shardcount;
     }
     
     
@@ -200,13 +345,18 @@ namespace machinelearning { namespace textprocess {
         
         std::vector<std::string> l_list;
         
-        for(std::map<std::string, std::size_t>::iterator it = m_map.begin(); it != m_map.end(); it++) {
-            const float l_val = static_cast<float>(it->second) / m_wordcount;
-            
-            if ( (compare(l_val, p_val1, p_comp1)) || (compare(l_val, p_val2, p_comp2)) )
-                  l_list.push_back( it->first );
-        }
+        for(std::size_t i=0; i < m_shards.size(); ++i)
+            for(std::size_t j=0; j < m_shards[i].size(); ++j) {
+                if (m_shards[i].count(j) == 0)
+                    continue;
+                
+                const float l_val = static_cast<float>(m_shards[i].count(j)) / m_wordcount;
+                if ( (compare(l_val, p_val1, p_comp1)) || (compare(l_val, p_val2, p_comp2)) )
+                    l_list.push_back( m_shards[i].term(j) );
+            }
         
+        // sorted like the former map-based result
+        std::sort( l_list.begin(), l_list.end() );
         return l_list;
     }
     
@@ -224,13 +374,18 @@ namespace machinelearning { namespace textprocess {
         
         std::vector<std::string> l_list;
         
-        for(std::map<std::string, std::size_t>::iterator it = m_map.begin(); it != m_map.end(); it++) {
-            const float l_val = static_cast<float>(it->second) / m_wordcount;
-            
-            if (compare(l_val, p_val, p_comp))
-                l_list.push_back( it->first );
-        }
+        for(std::size_t i=0; i < m_shards.size(); ++i)
+            for(std::size_t j=0; j < m_shards[i].size(); ++j) {
+                if (m_shards[i].count(j) == 0)
+                    continue;
+                
+                const float l_val = static_cast<float>(m_shards[i].count(j)) / m_wordcount;
+                if (compare(l_val, p_val, p_comp))
+                    l_list.push_back( m_shards[i].term(j) );
+            }
         
+        // sorted like the former map-based result
+        std::sort( l_list.begin(), l_list.end() );
         return l_list;
     }
     
@@ -259,7 +414,8 @@ namespace machinelearning { namespace textprocess {
     /** removes all elements within the map **/
     inline void termfrequency::clear( void ) 
     {
-        m_map.clear();
+        for(std::size_t i=0; i < m_shards.size(); ++i)
+            m_shards[i].clear();
         m_wordcount = 0;
     }
     
@@ -270,15 +426,160 @@ namespace machinelearning { namespace textprocess {
     inline void termfrequency::erase( const std::string& p_word )
     {
         std::string l_word = p_word;
-        if (m_caseinsensitive)
+        if (m_tokenizer.iscaseinsensitivity())
             boost::to_lower(l_word);
         
-        std::map<std::string, std::size_t>::iterator it = m_map.find(l_word);
-        if (it != m_map.end()) {
-            m_wordcount -= it->second;
-            m_map.erase( it );
+        const boost::uint64_t l_hash = tokenizer::token( l_word.data(), l_word.size() ).hash();
+        m_wordcount -= m_shards[ shard(l_hash) ].erase( l_word, l_hash );
+    }
+    
+    
+    
+    /** constructor of the term table **/
+    inline termfrequency::termtable::termtable( void ) :
+        m_slots( 16 ),
+        m_strings(),
+        m_used( 0 )
+    {}
+    
+    
+    /** returns the number of slots
+     * @return slot number
+     **/
+    inline std::size_t termfrequency::termtable::size( void ) const
+    {
+        return m_slots.size();
+    }
+    
+    
+    /** returns the count of a slot
+     * @param p_slot slot index
+     * @return count, zero for empty or erased slots
+     **/
+    inline std::size_t termfrequency::termtable::count( const std::size_t& p_slot ) const
+    {
+        return m_slots[p_slot].length == 0 ? 0 : m_slots[p_slot].count;
+    }
+    
+    
+    /** returns the term of a slot
+     * @param p_slot slot index
+     * @return term
+     **/
+    inline std::string termfrequency::termtable::term( const std::size_t& p_slot ) const
+    {
+        const slot& l_slot = m_slots[p_slot];
+        return l_slot.length == 0 ? std::string() : std::string( &m_strings[l_slot.offset], l_slot.length );
+    }
+    
+    
+    /** returns the slot of a term or the empty slot on which the term must be inserted
+     * @param p_data pointer to the term
+     * @param p_length length of the term
+     * @param p_hash term hash
+     * @return slot index
+     **/
+    inline std::size_t termfrequency::termtable::find( const char* p_data, const std::size_t& p_length, const boost::uint64_t& p_hash ) const
+    {
+        const std::size_t l_mask = m_slots.size() - 1;
+        
+        for(std::size_t i = static_cast<std::size_t>(p_hash) & l_mask; ; i = (i+1) & l_mask) {
+            const slot& l_slot = m_slots[i];
+            if (l_slot.length == 0)
+                return i;
+            if ( (l_slot.hash == p_hash) && (l_slot.length == p_length) && (std::memcmp(&m_strings[l_slot.offset], p_data, p_length) == 0) )
+                return i;
+        }
+    }
+    
+    
+    /** doubles the slots and reinserts the terms, the interned strings stay in place **/
+    inline void termfrequency::termtable::grow( void )
+    {
+        std::vector<slot> l_slots( m_slots.size() * 2 );
+        m_slots.swap( l_slots );
+        
+        const std::size_t l_mask = m_slots.size() - 1;
+        for(std::size_t i=0; i < l_slots.size(); ++i) {
+            if (l_slots[i].length == 0)
+                continue;
+            
+            std::size_t j = static_cast<std::size_t>(l_slots[i].hash) & l_mask;
+            while (m_slots[j].length != 0)
+                j = (j+1) & l_mask;
+            m_slots[j] = l_slots[i];
+        }
+    }
+    
+    
+    /** adds a term count, the term string is interned on the first insert
+     * @param p_data pointer to the term
+     * @param p_length length of the term (must be greater than zero)
+     * @param p_hash term hash
+     * @param p_count count
+     **/
+    inline void termfrequency::termtable::add( const char* p_data, const std::size_t& p_length, const boost::uint64_t& p_hash, const std::size_t& p_count )
+    {
+        std::size_t l_index = find( p_data, p_length, p_hash );
+        
+        if (m_slots[l_index].length == 0) {
+            if (2 * (m_used+1) > m_slots.size()) {
+                grow();
+                l_index = find( p_data, p_length, p_hash );
+            }
+            
+            slot& l_slot = m_slots[l_index];
+            l_slot.hash   = p_hash;
+            l_slot.offset = m_strings.size();
+            l_slot.length = p_length;
+            l_slot.count  = 0;
+            m_strings.insert( m_strings.end(), p_data, p_data+p_length );
+            m_used++;
+        }
+        
+        m_slots[l_index].count += p_count;
+    }
+    
+    
+    /** merges another table into this table
+     * @param p_table table
+     **/
+    inline void termfrequency::termtable::merge( const termtable& p_table )
+    {
+        for(std::size_t i=0; i < p_table.m_slots.size(); ++i) {
+            const slot& l_slot = p_table.m_slots[i];
+            if ( (l_slot.length > 0) && (l_slot.count > 0) )
+                add( &p_table.m_strings[l_slot.offset], l_slot.length, l_slot.hash, l_slot.count );
         }
     }
     
+    
+    /** erases a term, the slot is kept with a zero count, so probe chains are not broken
+     * @param p_term term
+     * @param p_hash term hash
+     * @return count of the erased term
+     **/
+    inline std::size_t termfrequency::termtable::erase( const std::string& p_term, const boost::uint64_t& p_hash )
+    {
+        if (p_term.empty())
+            return 0;
+        
+        slot& l_slot = m_slots[ find(p_term.data(), p_term.size(), p_hash) ];
+        const std::size_t l_count = l_slot.length == 0 ? 0 : l_slot.count;
+        if (l_slot.length != 0)
+            l_slot.count = 0;
+        
+        return l_count;
+    }
+    
+    
+    /** removes all terms **/
+    inline void termfrequency::termtable::clear( void )
+    {
+        std::vector<slot>( 16 ).swap( m_slots );
+        std::vector<char>().swap( m_strings );
+        m_used = 0;
+    }
+    
 }}
 #endif
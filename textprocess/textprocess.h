@@ -35,7 +35,10 @@ namespace machinelearning {
 
 
 
+#include "tokenizer.h"
 #include "termfrequency.h"
 #include "stopwordreduction.h"
+#include "tfidf.hpp"
+#include "signature.hpp"
 
 #endif
@@ -0,0 +1,368 @@
+/** 
+ @cond
+ ############################################################################
+ # LGPL License                                                             #
+ #                                                                          #
+ # This file is part of the Machine Learning Framework.                     #
+ # Copyright (c) 2010-2012, Philipp Kraus, <philipp.kraus@flashpixx.de>     #
+ # This program is free software: you can redistribute it and/or modify     #
+ # it under the terms of the GNU Lesser General Public License as           #
+ # published by the Free Software Foundation, either version 3 of the       #
+ # License, or (at your option) any later version.                          #
+ #                                                                          #
+ # This program is distributed in the hope that it will be useful,          #
+ # but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+ # MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+ # GNU Lesser General Public License for more details.                      #
+ #                                                                          #
+ # You should have received a copy of the GNU Lesser General Public License #
+ # along with this program. If not, see <http://www.gnu.org/licenses/>.     #
+ ############################################################################
+ @endcond
+ **/
+
+
+
+
+#ifndef __MACHINELEARNING_TEXTPROCESS_TFIDF_HPP
+#define __MACHINELEARNING_TEXTPROCESS_TFIDF_HPP
+
+#include <omp.h>
+#include <set>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <boost/static_assert.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+#include <boost/numeric/ublas/matrix_sparse.hpp>
+
+#include "../errorhandling/exception.hpp"
+#include "tokenizer.h"
+#include "termfrequency.h"
+
+
+
+namespace machinelearning { namespace textprocess {
+    
+    #ifndef SWIG
+    namespace ublas = boost::numeric::ublas;
+    #endif
+    
+    
+    /** class for creating a sparse document-term matrix (compressed row storage) with TF-IDF
+     * weights. The columns are the vocabulary terms, that are not pruned by the term frequency
+     * thresholds, or in hashing mode a fixed number of hash buckets. The rows are normalized
+     * with the euclidian norm, so the euclidian distance of rows orders like the cosine distance
+     **/
+    template<typename T> class tfidf
+    {
+        #ifndef SWIG
+        BOOST_STATIC_ASSERT( !boost::is_integral<T>::value );
+        #endif
+        
+        public:
+        
+            tfidf( const std::string& = ",;.:!?- \n\t|=", const std::string& = "#_()[]{}%$*/\\\"=|<>\r", const bool& = true, const std::size_t& = 2 );
+            void setPruning( const float&, const float&, const termfrequency::comparison& = termfrequency::lessequal, const termfrequency::comparison& = termfrequency::greaterequal );
+            void setHashing( const std::size_t& );
+            void setNormalize( const bool& );
+            ublas::compressed_matrix<T> create( const std::vector<std::string>& );
+            ublas::compressed_matrix<T> use( const std::vector<std::string>& ) const;
+            std::vector<std::string> getVocabulary( void ) const;
+            ublas::vector<T> getInverseDocumentFrequency( void ) const;
+            std::size_t getDimension( void ) const;
+        
+        
+        private:
+        
+            /** sparse document row with column and count **/
+            typedef std::vector< std::pair<std::size_t, T> > sparserow;
+        
+            /** tokenizer **/
+            const tokenizer m_tokenizer;
+            /** minimal term length **/
+            const std::size_t m_minlen;
+            /** bool for pruning **/
+            bool m_pruning;
+            /** pruning thresholds **/
+            float m_pruningvalue[2];
+            /** pruning comparisons **/
+            termfrequency::comparison m_pruningcomparison[2];
+            /** number of hash buckets (zero for vocabulary mode) **/
+            std::size_t m_hashing;
+            /** bool for row normalization **/
+            bool m_normalize;
+            /** vocabulary **/
+            std::vector<std::string> m_vocabulary;
+            /** term to column index **/
+            boost::unordered_map<std::string, std::size_t> m_index;
+            /** inverse document frequency **/
+            ublas::vector<T> m_idf;
+        
+            void count( const std::vector<std::string>&, std::vector<sparserow>& ) const;
+            ublas::compressed_matrix<T> weight( std::vector<sparserow>& ) const;
+    };
+    
+    
+    
+    /** constructor
+     * @param p_separator characters for seperate words within the text
+     * @param p_remove string with characters that will be removed
+     * @param p_caseinsensitive words should be case-insensitive
+     * @param p_minlen only words equal or greater will be used
+     **/
+    template<typename T> inline tfidf<T>::tfidf( const std::string& p_separator, const std::string& p_remove, const bool& p_caseinsensitive, const std::size_t& p_minlen ) :
+        m_tokenizer( p_separator, p_remove, p_caseinsensitive ),
+        m_minlen( p_minlen ),
+        m_pruning( false ),
+        m_hashing( 0 ),
+        m_normalize( true ),
+        m_vocabulary(),
+        m_index(),
+        m_idf()
+    {
+        m_pruningvalue[0] = m_pruningvalue[1] = 0;
+        m_pruningcomparison[0] = termfrequency::lessequal;
+        m_pruningcomparison[1] = termfrequency::greaterequal;
+    }
+    
+    
+    /** sets the pruning of the vocabulary, all terms, that are returned by termfrequency::getTerms
+     * with the thresholds, are removed (e.g. very rare and very frequent words)
+     * @param p_val1 first value in range [0,1]
+     * @param p_val2 second value in range [0,1]
+     * @param p_comp1 comparasion operator of the first value
+     * @param p_comp2 comparasion operator of the second value
+     **/
+    template<typename T> inline void tfidf<T>::setPruning( const float& p_val1, const float& p_val2, const termfrequency::comparison& p_comp1, const termfrequency::comparison& p_comp2 )
+    {
+        if ( (p_val1 < 0) || (p_val1 > 1) || (p_val2 < 0) || (p_val2 > 1) )
+            throw exception::runtime(_("ranges must be between [0,1]"), *this);
+        
+        m_pruning               = true;
+        m_pruningvalue[0]       = p_val1;
+        m_pruningvalue[1]       = p_val2;
+        m_pruningcomparison[0]  = p_comp1;
+        m_pruningcomparison[1]  = p_comp2;
+    }
+    
+    
+    /** enables the hashing mode, each term is mapped by its hash to a fixed number
+     * of columns, so no vocabulary is stored and the memory is fixed
+     * @param p_dimension number of columns (zero for vocabulary mode)
+     **/
+    template<typename T> inline void tfidf<T>::setHashing( const std::size_t& p_dimension )
+    {
+        m_hashing = p_dimension;
+    }
+    
+    
+    /** sets the row normalization
+     * @param p_normalize bool for normalization
+     **/
+    template<typename T> inline void tfidf<T>::setNormalize( const bool& p_normalize )
+    {
+        m_normalize = p_normalize;
+    }
+    
+    
+    /** returns the vocabulary (empty in hashing mode)
+     * @return terms of the columns
+     **/
+    template<typename T> inline std::vector<std::string> tfidf<T>::getVocabulary( void ) const
+    {
+        return m_vocabulary;
+    }
+    
+    
+    /** returns the inverse document frequency of each column
+     * @return idf vector
+     **/
+    template<typename T> inline ublas::vector<T> tfidf<T>::getInverseDocumentFrequency( void ) const
+    {
+        return m_idf;
+    }
+    
+    
+    /** returns the number of columns
+     * @return dimension
+     **/
+    template<typename T> inline std::size_t tfidf<T>::getDimension( void ) const
+    {
+        return m_idf.size();
+    }
+    
+    
+    /** creates the vocabulary and the inverse document frequency of the documents
+     * and returns the document-term matrix
+     * @param p_documents documents
+     * @return sparse matrix (rows are documents)
+     **/
+    template<typename T> inline ublas::compressed_matrix<T> tfidf<T>::create( const std::vector<std::string>& p_documents )
+    {
+        if (p_documents.size() == 0)
+            throw exception::runtime(_("document list can not be empty"), *this);
+        
+        m_vocabulary.clear();
+        m_index.clear();
+        
+        // vocabulary is created by the term frequency and reduced by the pruning thresholds
+        if (m_hashing == 0) {
+            termfrequency l_frequency( m_tokenizer.getSeparator(), m_tokenizer.getRemove(), m_tokenizer.iscaseinsensitivity() );
+            l_frequency.add( p_documents, m_minlen );
+            if (l_frequency.getTermCount() == 0)
+                throw exception::runtime(_("no words within the documents"), *this);
+            
+            std::set<std::string> l_pruned;
+            if (m_pruning) {
+                const std::vector<std::string> l_terms = l_frequency.getTerms( m_pruningvalue[0], m_pruningvalue[1], m_pruningcomparison[0], m_pruningcomparison[1] );
+                l_pruned.insert( l_terms.begin(), l_terms.end() );
+            }
+            
+            const std::map<std::string, std::size_t> l_map = l_frequency.getMap();
+            for(std::map<std::string, std::size_t>::const_iterator it = l_map.begin(); it != l_map.end(); ++it)
+                if (l_pruned.find(it->first) == l_pruned.end()) {
+                    m_index[it->first] = m_vocabulary.size();
+                    m_vocabulary.push_back( it->first );
+                }
+            
+            if (m_vocabulary.empty())
+                throw exception::runtime(_("all words are pruned"), *this);
+        }
+        
+        std::vector<sparserow> l_rows( p_documents.size() );
+        count( p_documents, l_rows );
+        
+        
+        // document frequency with thread-local counts: idf = log( (1+n) / (1+df) ) + 1
+        const std::size_t l_dimension = (m_hashing == 0) ? m_vocabulary.size() : m_hashing;
+        std::vector< std::vector<std::size_t> > l_df( static_cast<std::size_t>(omp_get_max_threads()), std::vector<std::size_t>() );
+        
+        #pragma omp parallel shared(l_df, l_rows)
+        {
+            std::vector<std::size_t>& l_local = l_df[ static_cast<std::size_t>(omp_get_thread_num()) ];
+            l_local.resize( l_dimension, 0 );
+            
+            #pragma omp for schedule(dynamic)
+            for(std::size_t i=0; i < l_rows.size(); ++i)
+                for(std::size_t j=0; j < l_rows[i].size(); ++j)
+                    l_local[ l_rows[i][j].first ]++;
+        }
+        
+        m_idf.resize( l_dimension, false );
+        const T l_documents = static_cast<T>(p_documents.size());
+        
+        #pragma omp parallel for shared(l_df)
+        for(std::size_t j=0; j < l_dimension; ++j) {
+            std::size_t l_count = 0;
+            for(std::size_t n=0; n < l_df.size(); ++n)
+                if (!l_df[n].empty())
+                    l_count += l_df[n][j];
+            m_idf(j) = std::log( (1 + l_documents) / (1 + static_cast<T>(l_count)) ) + 1;
+        }
+        
+        return weight( l_rows );
+    }
+    
+    
+    /** returns the document-term matrix of documents with the created
+     * vocabulary and inverse document frequency
+     * @param p_documents documents
+     * @return sparse matrix (rows are documents)
+     **/
+    template<typename T> inline ublas::compressed_matrix<T> tfidf<T>::use( const std::vector<std::string>& p_documents ) const
+    {
+        if (m_idf.size() == 0)
+            throw exception::runtime(_("document-term matrix must be created first"), *this);
+        if ( (m_hashing != 0) && (m_hashing != m_idf.size()) )
+            throw exception::runtime(_("hashing dimension has been changed"), *this);
+        
+        std::vector<sparserow> l_rows( p_documents.size() );
+        count( p_documents, l_rows );
+        
+        return weight( l_rows );
+    }
+    
+    
+    /** counts the terms of each document in parallel
+     * @param p_documents documents
+     * @param p_rows sorted sparse rows with the term counts
+     **/
+    template<typename T> inline void tfidf<T>::count( const std::vector<std::string>& p_documents, std::vector<sparserow>& p_rows ) const
+    {
+        #pragma omp parallel shared(p_rows)
+        {
+            tokenizer l_tokenizer( m_tokenizer );
+            std::vector<std::size_t> l_columns;
+            std::string l_key;
+            
+            #pragma omp for schedule(dynamic)
+            for(std::size_t i=0; i < p_documents.size(); ++i) {
+                
+                l_columns.clear();
+                l_tokenizer.setBuffer( p_documents[i] );
+                for(tokenizer::token l_token; l_tokenizer.next(l_token, m_minlen); ) {
+                    if (m_hashing > 0) {
+                        l_columns.push_back( static_cast<std::size_t>(l_token.hash() % m_hashing) );
+                        continue;
+                    }
+                    
+                    l_key.assign( l_token.data(), l_token.size() );
+                    const typename boost::unordered_map<std::string, std::size_t>::const_iterator it = m_index.find( l_key );
+                    if (it != m_index.end())
+                        l_columns.push_back( it->second );
+                }
+                
+                // sorted columns are compressed to (column, count) pairs
+                std::sort( l_columns.begin(), l_columns.end() );
+                sparserow& l_row = p_rows[i];
+                l_row.clear();
+                for(std::size_t j=0; j < l_columns.size(); ++j)
+                    if ( (l_row.empty()) || (l_row.back().first != l_columns[j]) )
+                        l_row.push_back( std::make_pair(l_columns[j], static_cast<T>(1)) );
+                    else
+                        l_row.back().second += 1;
+            }
+        }
+    }
+    
+    
+    /** weights the counts with the inverse document frequency and creates the matrix
+     * @param p_rows sparse rows with the term counts (values are changed)
+     * @return sparse matrix
+     **/
+    template<typename T> inline ublas::compressed_matrix<T> tfidf<T>::weight( std::vector<sparserow>& p_rows ) const
+    {
+        std::size_t l_nonzero = 0;
+        for(std::size_t i=0; i < p_rows.size(); ++i)
+            l_nonzero += p_rows[i].size();
+        
+        #pragma omp parallel for shared(p_rows) schedule(dynamic)
+        for(std::size_t i=0; i < p_rows.size(); ++i) {
+            T l_norm = 0;
+            for(std::size_t j=0; j < p_rows[i].size(); ++j) {
+                p_rows[i][j].second *= m_idf(p_rows[i][j].first);
+                l_norm += p_rows[i][j].second * p_rows[i][j].second;
+            }
+            
+            if ( (m_normalize) && (l_norm > 0) ) {
+                l_norm = std::sqrt(l_norm);
+                for(std::size_t j=0; j < p_rows[i].size(); ++j)
+                    p_rows[i][j].second /= l_norm;
+            }
+        }
+        
+        // rows and columns are sorted, so the compressed matrix is filled by appending
+        ublas::compressed_matrix<T> l_matrix( p_rows.size(), m_idf.size(), l_nonzero );
+        for(std::size_t i=0; i < p_rows.size(); ++i)
+            for(std::size_t j=0; j < p_rows[i].size(); ++j)
+                l_matrix.push_back( i, p_rows[i][j].first, p_rows[i][j].second );
+        
+        return l_matrix;
+    }
+    
+}}
+#endif
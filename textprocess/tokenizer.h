@@ -0,0 +1,373 @@
+/** 
+ @cond
+ ############################################################################
+ # LGPL License                                                             #
+ #                                                                          #
+ # This file is part of the Machine Learning Framework.                     #
+ # Copyright (c) 2010-2012, Philipp Kraus, <philipp.kraus@flashpixx.de>     #
+ # This program is free software: you can redistribute it and/or modify     #
+ # it under the terms of the GNU Lesser General Public License as           #
+ # published by the Free Software Foundation, either version 3 of the       #
+ # License, or (at your option) any later version.                          #
+ #                                                                          #
+ # This program is distributed in the hope that it will be useful,          #
+ # but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+ # MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+ # GNU Lesser General Public License for more details.                      #
+ #                                                                          #
+ # You should have received a copy of the GNU Lesser General Public License #
+ # along with this program. If not, see <http://www.gnu.org/licenses/>.     #
+ ############################################################################
+ @endcond
+ **/
+
+
+
+
+#ifndef __MACHINELEARNING_TEXTPROCESS_TOKENIZER_H
+#define __MACHINELEARNING_TEXTPROCESS_TOKENIZER_H
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <fstream>
+#include <boost/cstdint.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include "../errorhandling/exception.hpp"
+
+
+
+namespace machinelearning { namespace textprocess {
+    
+    #ifndef SWIG
+    namespace bio = boost::iostreams;
+    #endif
+    
+    
+    /** streaming tokenizer, that reads tokens as spans over a buffer or a memory-mapped file.
+     * The characters are classified by a table, tokens without removable or upper-case characters
+     * point into the input, all other tokens are folded into an internal buffer
+     **/
+    class tokenizer
+    {
+        
+        public:
+        
+            /** span of a token, the data is valid until the next token is read **/
+            class token
+            {
+                public :
+                
+                    token( void );
+                    token( const char*, const std::size_t& );
+                    const char* data( void ) const;
+                    std::size_t size( void ) const;
+                    bool empty( void ) const;
+                    std::string str( void ) const;
+                    boost::uint64_t hash( void ) const;
+                    bool operator==( const std::string& ) const;
+                
+                private :
+                
+                    /** pointer to the data **/
+                    const char* m_data;
+                    /** length of the token **/
+                    std::size_t m_size;
+            };
+        
+        
+            tokenizer( const std::string& = ",;.:!?- \n\t|=", const std::string& = "", const bool& = false );
+            void setBuffer( const char*, const char* );
+            void setBuffer( const std::string& );
+            void setFile( const std::string& );
+            bool next( token&, const std::size_t& = 1 );
+            bool isseparator( const char& ) const;
+            bool iscaseinsensitivity( void ) const;
+            std::string getSeparator( void ) const;
+            std::string getRemove( void ) const;
+        
+        
+        private:
+        
+            /** character classes **/
+            enum charclass {
+                separator       = 1,
+                removal         = 2,
+                space           = 4,
+                upper           = 8
+            };
+        
+            /** seperators **/
+            std::string m_separator;
+            /** chars that will be removed **/
+            std::string m_remove;
+            /** bool for case-sensitive / case-insensitive tokens **/
+            bool m_caseinsensitive;
+            /** classification table **/
+            unsigned char m_class[256];
+            /** mapped file **/
+            bio::mapped_file_source m_file;
+            /** current position **/
+            const char* m_position;
+            /** end of the buffer **/
+            const char* m_end;
+            /** buffer for folded tokens **/
+            std::vector<char> m_buffer;
+        
+    };
+    
+    
+    
+    /** creates an empty token **/
+    inline tokenizer::token::token( void ) :
+        m_data( NULL ),
+        m_size( 0 )
+    {}
+    
+    
+    /** creates a token
+     * @param p_data pointer to the data
+     * @param p_size length
+     **/
+    inline tokenizer::token::token( const char* p_data, const std::size_t& p_size ) :
+        m_data( p_data ),
+        m_size( p_size )
+    {}
+    
+    
+    /** returns the data pointer
+     * @return pointer
+     **/
+    inline const char* tokenizer::token::data( void ) const
+    {
+        return m_data;
+    }
+    
+    
+    /** returns the length
+     * @return length
+     **/
+    inline std::size_t tokenizer::token::size( void ) const
+    {
+        return m_size;
+    }
+    
+    
+    /** checks if the token is empty
+     * @return empty flag
+     **/
+    inline bool tokenizer::token::empty( void ) const
+    {
+        return m_size == 0;
+    }
+    
+    
+    /** copies the token into a string
+     * @return string
+     **/
+    inline std::string tokenizer::token::str( void ) const
+    {
+        return m_size == 0 ? std::string() : std::string( m_data, m_size );
+    }
+    
+    
+    /** returns the FNV-1a hash of the token
+     * @return hash
+     **/
+    inline boost::uint64_t tokenizer::token::hash( void ) const
+    {
+        boost::uint64_t l_hash = 14695981039346656037ULL;
+        for(std::size_t i=0; i < m_size; ++i) {
+            l_hash ^= static_cast<unsigned char>(m_data[i]);
+            l_hash *= 1099511628211ULL;
+        }
+        return l_hash;
+    }
+    
+    
+    /** compares the token with a string
+     * @param p_str string
+     * @return equality
+     **/
+    inline bool tokenizer::token::operator==( const std::string& p_str ) const
+    {
+        return (p_str.size() == m_size) && ((m_size == 0) || (std::memcmp(p_str.data(), m_data, m_size) == 0));
+    }
+    
+    
+    
+    /** constructor
+     * @param p_separator characters for seperate tokens
+     * @param p_remove characters that will be removed from the tokens
+     * @param p_caseinsensitive tokens are folded to lower-case (ASCII)
+     **/
+    inline tokenizer::tokenizer( const std::string& p_separator, const std::string& p_remove, const bool& p_caseinsensitive ) :
+        m_separator( p_separator ),
+        m_remove( p_remove ),
+        m_caseinsensitive( p_caseinsensitive ),
+        m_file(),
+        m_position( NULL ),
+        m_end( NULL ),
+        m_buffer()
+    {
+        if (m_separator.empty())
+            throw exception::runtime(_("separator can not be empty"), *this);
+        
+        std::memset( m_class, 0, sizeof(m_class) );
+        
+        const std::string l_space( " \t\n\v\f\r" );
+        for(std::size_t i=0; i < l_space.size(); ++i)
+            m_class[ static_cast<unsigned char>(l_space[i]) ] |= space;
+        if (m_caseinsensitive)
+            for(unsigned char i='A'; i <= 'Z'; ++i)
+                m_class[i] |= upper;
+        for(std::size_t i=0; i < m_remove.size(); ++i)
+            m_class[ static_cast<unsigned char>(m_remove[i]) ] |= removal;
+        for(std::size_t i=0; i < m_separator.size(); ++i)
+            m_class[ static_cast<unsigned char>(m_separator[i]) ] = separator;
+    }
+    
+    
+    /** sets the buffer, the buffer is not copied and must be valid during reading
+     * @param p_begin begin of the buffer
+     * @param p_end end of the buffer
+     **/
+    inline void tokenizer::setBuffer( const char* p_begin, const char* p_end )
+    {
+        // copies of the tokenizer share the mapping, so the mapping is released and not closed
+        m_file = bio::mapped_file_source();
+        
+        m_position  = p_begin;
+        m_end       = p_end;
+    }
+    
+    
+    /** sets a string as buffer, the string is not copied and must be valid during reading
+     * @param p_str string
+     **/
+    inline void tokenizer::setBuffer( const std::string& p_str )
+    {
+        setBuffer( p_str.data(), p_str.data()+p_str.size() );
+    }
+    
+    
+    /** maps a file into the memory and sets it as buffer
+     * @param p_file filename
+     **/
+    inline void tokenizer::setFile( const std::string& p_file )
+    {
+        setBuffer( NULL, NULL );
+        
+        // empty files can not be mapped, so they are read as empty buffer
+        std::ifstream l_stream( p_file.c_str(), std::ios::in | std::ios::binary | std::ios::ate );
+        if (!l_stream.is_open())
+            throw exception::runtime(_("file can not be opened"), *this);
+        if (l_stream.tellg() <= 0)
+            return;
+        l_stream.close();
+        
+        try {
+            m_file.open( p_file );
+        } catch (...) {
+            throw exception::runtime(_("file can not be opened"), *this);
+        }
+        
+        m_position  = m_file.data();
+        m_end       = m_file.data() + m_file.size();
+    }
+    
+    
+    /** reads the next token, empty tokens and tokens shorter than the minimal length are skipped
+     * @param p_token token span
+     * @param p_minlen minimal token length
+     * @return false if the buffer is finished
+     **/
+    inline bool tokenizer::next( token& p_token, const std::size_t& p_minlen )
+    {
+        while (m_position != m_end) {
+            
+            // skip separators and read the token with its class flags in one pass
+            while ( (m_position != m_end) && (m_class[static_cast<unsigned char>(*m_position)] & separator) )
+                m_position++;
+            if (m_position == m_end)
+                break;
+            
+            const char* l_first = m_position;
+            unsigned char l_flags = 0;
+            for( ; (m_position != m_end) && !(m_class[static_cast<unsigned char>(*m_position)] & separator); ++m_position)
+                l_flags |= m_class[static_cast<unsigned char>(*m_position)];
+            const char* l_last = m_position;
+            
+            // removal and case folding are done in the buffer, so the input is never modified
+            if (l_flags & (removal | upper)) {
+                if (m_buffer.size() < static_cast<std::size_t>(l_last-l_first))
+                    m_buffer.resize( static_cast<std::size_t>(l_last-l_first) );
+                
+                char* l_out = &m_buffer[0];
+                for(const char* l_it = l_first; l_it != l_last; ++l_it) {
+                    const unsigned char l_class = m_class[static_cast<unsigned char>(*l_it)];
+                    if (!(l_class & removal))
+                        *l_out++ = (l_class & upper) ? static_cast<char>(*l_it - 'A' + 'a') : *l_it;
+                }
+                
+                l_first = &m_buffer[0];
+                l_last  = l_out;
+            }
+            
+            if (l_flags & space) {
+                while ( (l_first != l_last) && (m_class[static_cast<unsigned char>(*l_first)] & space) )
+                    l_first++;
+                while ( (l_first != l_last) && (m_class[static_cast<unsigned char>(*(l_last-1))] & space) )
+                    l_last--;
+            }
+            
+            const std::size_t l_size = static_cast<std::size_t>(l_last-l_first);
+            if ( (l_size > 0) && (l_size >= p_minlen) ) {
+                p_token = token( l_first, l_size );
+                return true;
+            }
+        }
+        
+        return false;
+    }
+    
+    
+    /** checks if a character is a separator
+     * @param p_char character
+     * @return separator flag
+     **/
+    inline bool tokenizer::isseparator( const char& p_char ) const
+    {
+        return m_class[static_cast<unsigned char>(p_char)] & separator;
+    }
+    
+    
+    /** returns the value for case-insensitive tokens
+     * @return bool for case-insensitive
+     **/
+    inline bool tokenizer::iscaseinsensitivity( void ) const
+    {
+        return m_caseinsensitive;
+    }
+    
+    
+    /** returns a string with character that are used for seperating the tokens
+     * @return string with separators
+     **/
+    inline std::string tokenizer::getSeparator( void ) const
+    {
+        return m_separator;
+    }
+    
+    
+    /** returns a string with character that are removed from the tokens
+     * @return string with removed characters
+     **/
+    inline std::string tokenizer::getRemove( void ) const
+    {
+        return m_remove;
+    }
+    
+}}
+#endif
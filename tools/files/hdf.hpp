@@ -27,6 +27,8 @@
 #define __MACHINELEARNING_TOOLS_FILES_HDF_HPP
 
 #include <string>
+#include <vector>
+#include <algorithm>
 #include <boost/numeric/ublas/matrix.hpp>
 #include <boost/numeric/ublas/vector.hpp>
 #include <boost/numeric/ublas/storage.hpp>
@@ -200,6 +202,8 @@ namespace machinelearning { namespace tools { namespace files {
             
             
             template<typename T> ublas::matrix<T> readBlasMatrix( const std::string&, const datatype& ) const;
+            template<typename T> ublas::matrix<T> readBlasMatrixBlock( const std::string&, const std::size_t&, const std::size_t&, const std::size_t&, const std::size_t&, const datatype& ) const;
+            ublas::vector<std::size_t> getBlasMatrixSize( const std::string& ) const;
             template<typename T> ublas::vector<T> readBlasVector( const std::string&, const datatype& ) const;
             template<typename T> std::vector<T> readStdVector( const std::string&, const datatype& ) const;
             template<typename T> T readValue( const std::string&, const datatype& ) const;
@@ -209,6 +213,8 @@ namespace machinelearning { namespace tools { namespace files {
             
             
             template<typename T> void writeBlasMatrix( const std::string&, const ublas::matrix<T>&, const datatype& ) const;
+            template<typename T> void writeBlasMatrixBlock( const std::string&, const ublas::matrix<T>&, const std::size_t&, const std::size_t&, const datatype& ) const;
+            void createBlasMatrix( const std::string&, const std::size_t&, const std::size_t&, const std::size_t&, const std::size_t&, const datatype& ) const;
             template<typename T> void writeBlasVector( const std::string&, const ublas::vector<T>&, const datatype& ) const;
             template<typename T> void writeStdVector( const std::string&, const std::vector<T>&, const datatype& ) const;
             template<typename T> void writeValue( const std::string&, const T&, const datatype& ) const;
@@ -224,7 +230,7 @@ namespace machinelearning { namespace tools { namespace files {
             
             bool isAbsolutePath( const std::string& p_path ) const;
             std::string createPath( const std::string&, std::vector<H5::Group>& ) const;
-            void createDataSpace( const std::string&, const H5::PredType&, const ublas::vector<std::size_t>&, H5::DataSpace&, H5::DataSet&, std::vector<H5::Group>& ) const;
+            void createDataSpace( const std::string&, const H5::PredType&, const ublas::vector<std::size_t>&, H5::DataSpace&, H5::DataSet&, std::vector<H5::Group>&, const ublas::vector<std::size_t>& = ublas::vector<std::size_t>() ) const;
             void createStringSpace( const std::string&, const ublas::vector<std::size_t>&, const std::size_t&, H5::DataSpace&, H5::DataSet&, H5::StrType&, std::vector<H5::Group>& ) const;
             void closeSpace( std::vector<H5::Group>&, H5::DataSet&, H5::DataSpace& ) const;
             H5::PredType getHDFType( const datatype& ) const;
@@ -371,6 +377,78 @@ namespace machinelearning { namespace tools { namespace files {
     
     
     
+    /** reads a block of a matrix with convert to blas matrix
+     * @param p_path dataset name
+     * @param p_row first row of the block
+     * @param p_column first column of the block
+     * @param p_rows number of rows
+     * @param p_columns number of columns
+     * @param p_datatype datatype for reading data
+     * @return ublas matrix
+     **/ 
+    template<typename T> inline ublas::matrix<T> hdf::readBlasMatrixBlock( const std::string& p_path, const std::size_t& p_row, const std::size_t& p_column, const std::size_t& p_rows, const std::size_t& p_columns, const datatype& p_datatype ) const
+    {
+        if (!isAbsolutePath(p_path))
+            throw exception::runtime(_("path is not an absolute path"));
+        if ((!p_rows) || (!p_columns))
+            throw exception::runtime(_("dimension need not be zero"));
+        
+        H5::DataSet   l_dataset   = m_file.openDataSet( p_path.c_str() );
+        H5::DataSpace l_dataspace = l_dataset.getSpace();
+        
+        if (l_dataspace.getSimpleExtentNdims() != 2)
+            throw exception::runtime(_("dataset must be two-dimensional"));
+        
+        // first element is column size, second row size
+        hsize_t l_size[2];
+        l_dataspace.getSimpleExtentDims( l_size );
+        if ((p_row + p_rows > l_size[1]) || (p_column + p_columns > l_size[0]))
+            throw exception::runtime(_("block exceeds the dataset"));
+        
+        hsize_t l_offset[2] = { p_column, p_row };
+        hsize_t l_count[2]  = { p_columns, p_rows };
+        l_dataspace.selectHyperslab( H5S_SELECT_SET, l_count, l_offset );
+        H5::DataSpace l_memory( 2, l_count );
+        
+        // read data (read column oriantated, because data order is changed)
+        ublas::matrix<T, ublas::column_major> l_mat(p_rows, p_columns);
+        l_dataset.read( &(l_mat.data()[0]), getHDFType(p_datatype), l_memory, l_dataspace );
+        
+        l_memory.close();
+        l_dataspace.close();
+        l_dataset.close();
+        return l_mat;
+    }
+    
+    
+    /** returns the size of a matrix dataset
+     * @param p_path dataset name
+     * @return vector with number of rows and columns
+     **/
+    inline ublas::vector<std::size_t> hdf::getBlasMatrixSize( const std::string& p_path ) const
+    {
+        if (!isAbsolutePath(p_path))
+            throw exception::runtime(_("path is not an absolute path"));
+        
+        H5::DataSet   l_dataset   = m_file.openDataSet( p_path.c_str() );
+        H5::DataSpace l_dataspace = l_dataset.getSpace();
+        
+        if (l_dataspace.getSimpleExtentNdims() != 2)
+            throw exception::runtime(_("dataset must be two-dimensional"));
+        
+        hsize_t l_size[2];
+        l_dataspace.getSimpleExtentDims( l_size );
+        
+        ublas::vector<std::size_t> l_dim(2);
+        l_dim(0) = l_size[1];
+        l_dim(1) = l_size[0];
+        
+        l_dataspace.close();
+        l_dataset.close();
+        return l_dim;
+    }
+    
+    
     /** reads a vector with convert to blas vector
      * @param p_path dataset path & name
      * @param p_datatype datatype for reading data
@@ -669,6 +747,81 @@ namespace machinelearning { namespace tools { namespace files {
     }
     
     
+    /** creates an empty chunked matrix dataset, that can be written block-wise
+     * (the layout is equal to writeBlasMatrix)
+     * @param p_path dataset path & name
+     * @param p_rows number of rows
+     * @param p_columns number of columns
+     * @param p_chunkrows number of rows of a chunk
+     * @param p_chunkcolumns number of columns of a chunk
+     * @param p_datatype datatype for writing data 
+     **/
+    inline void hdf::createBlasMatrix( const std::string& p_path, const std::size_t& p_rows, const std::size_t& p_columns, const std::size_t& p_chunkrows, const std::size_t& p_chunkcolumns, const datatype& p_datatype ) const
+    {
+        if ((!p_rows) || (!p_columns) || (!p_chunkrows) || (!p_chunkcolumns))
+            throw exception::runtime(_("dimension need not be zero"));
+        
+        if (!isAbsolutePath(p_path))
+            throw exception::runtime(_("path is not an absolute path"));
+        
+        H5::DataSet l_dataset;
+        H5::DataSpace l_dataspace;
+        std::vector<H5::Group> l_groups;
+        
+        ublas::vector<std::size_t> l_dim(2);
+        l_dim(0) = p_columns;
+        l_dim(1) = p_rows;
+        
+        ublas::vector<std::size_t> l_chunk(2);
+        l_chunk(0) = std::min(p_chunkcolumns, p_columns);
+        l_chunk(1) = std::min(p_chunkrows, p_rows);
+        
+        createDataSpace(p_path,  getHDFType(p_datatype), l_dim, l_dataspace, l_dataset, l_groups, l_chunk);
+        closeSpace(l_groups, l_dataset, l_dataspace);
+    }
+    
+    
+    /** write a blas matrix into a block of an existing matrix dataset
+     * @param p_path dataset path & name
+     * @param p_dataset matrixdata
+     * @param p_row first row of the block
+     * @param p_column first column of the block
+     * @param p_datatype datatype for writing data 
+     **/
+    template<typename T> inline void hdf::writeBlasMatrixBlock( const std::string& p_path, const ublas::matrix<T>& p_dataset, const std::size_t& p_row, const std::size_t& p_column, const datatype& p_datatype ) const
+    {
+        if ((!p_dataset.size1()) || (!p_dataset.size2()))
+            throw exception::runtime(_("can not write empty data"));
+        
+        if (!isAbsolutePath(p_path))
+            throw exception::runtime(_("path is not an absolute path"));
+        
+        H5::DataSet   l_dataset   = m_file.openDataSet( p_path.c_str() );
+        H5::DataSpace l_dataspace = l_dataset.getSpace();
+        
+        if (l_dataspace.getSimpleExtentNdims() != 2)
+            throw exception::runtime(_("dataset must be two-dimensional"));
+        
+        // first element is column size, second row size
+        hsize_t l_size[2];
+        l_dataspace.getSimpleExtentDims( l_size );
+        if ((p_row + p_dataset.size1() > l_size[1]) || (p_column + p_dataset.size2() > l_size[0]))
+            throw exception::runtime(_("block exceeds the dataset"));
+        
+        hsize_t l_offset[2] = { p_column, p_row };
+        hsize_t l_count[2]  = { p_dataset.size2(), p_dataset.size1() };
+        l_dataspace.selectHyperslab( H5S_SELECT_SET, l_count, l_offset );
+        H5::DataSpace l_memory( 2, l_count );
+        
+        ublas::matrix<T> l_matrix = ublas::trans(p_dataset);
+        l_dataset.write( &(l_matrix.data()[0]), getHDFType(p_datatype), l_memory, l_dataspace );
+        
+        l_memory.close();
+        l_dataspace.close();
+        l_dataset.close();
+    }
+    
+    
     /** write a blas vector to hdf file
      * @param p_path dataset path & name
      * @param p_dataset vectordata
@@ -760,8 +913,9 @@ namespace machinelearning { namespace tools { namespace files {
      * @param p_dataspace refernce of the dataspace
      * @param p_dataset refernce for the dataset
      * @param p_groups groups for closing
+     * @param p_chunk optional chunk dimension (empty for contiguous layout)
      **/
-    inline void hdf::createDataSpace( const std::string& p_path, const H5::PredType& p_datatype, const ublas::vector<std::size_t>& p_dim, H5::DataSpace& p_dataspace, H5::DataSet& p_dataset, std::vector<H5::Group>& p_groups ) const
+    inline void hdf::createDataSpace( const std::string& p_path, const H5::PredType& p_datatype, const ublas::vector<std::size_t>& p_dim, H5::DataSpace& p_dataspace, H5::DataSet& p_dataset, std::vector<H5::Group>& p_groups, const ublas::vector<std::size_t>& p_chunk ) const
     {
         if (!p_dim.size())
             throw exception::runtime(_("one dimension is required"));
@@ -778,10 +932,21 @@ namespace machinelearning { namespace tools { namespace files {
         if (l_path.empty())
             throw exception::runtime(_("empty path is forbidden"));
         
+        H5::DSetCreatPropList l_property;
+        if (p_chunk.size()) {
+            if (p_chunk.size() != p_dim.size())
+                throw exception::runtime(_("chunk and dataspace dimension must be equal"));
+            
+            std::vector<hsize_t> l_chunk( p_chunk.begin(), p_chunk.end() );
+            l_property.setChunk( static_cast<int>(l_chunk.size()), &l_chunk[0] );
+        }
+        
         if (!p_groups.size())
-            p_dataset = m_file.createDataSet( l_path.c_str(), p_datatype, p_dataspace );
+            p_dataset = m_file.createDataSet( l_path.c_str(), p_datatype, p_dataspace, l_property );
         else
-            p_dataset = p_groups[p_groups.size()-1].createDataSet( l_path.c_str(), p_datatype, p_dataspace );
+            p_dataset = p_groups[p_groups.size()-1].createDataSet( l_path.c_str(), p_datatype, p_dataspace, l_property );
+        
+        l_property.close();
     }
     
     
@@ -25,8 +25,15 @@
 #ifndef __MACHINELEARNING_TOOLS_LAPACK_HPP
 #define __MACHINELEARNING_TOOLS_LAPACK_HPP
 
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
 #include <boost/numeric/ublas/matrix.hpp>
 #include <boost/numeric/ublas/vector.hpp>
+#include <boost/numeric/ublas/matrix_sparse.hpp>
+#include <boost/numeric/ublas/matrix_proxy.hpp>
+#include <boost/numeric/ublas/vector_proxy.hpp>
 #include <boost/numeric/bindings/blas.hpp>
 #include <boost/numeric/bindings/ublas/vector.hpp>
 #include <boost/numeric/bindings/ublas/matrix.hpp>
@@ -38,6 +45,7 @@
 
 
 #include "../errorhandling/exception.hpp"
+#include "matrix.hpp"
 #include "language/language.h"
 
 
@@ -78,6 +86,14 @@ namespace machinelearning { namespace tools {
             template<typename T> static ublas::vector<T> perronfrobenius( const ublas::matrix<T>&, const std::size_t&, const ublas::vector<T>& );
             template<typename T> static ublas::matrix<T> unnormalizedGraphLaplacian( const ublas::matrix<T>& );
             template<typename T> static ublas::matrix<T> normalizedGraphLaplacian( const ublas::matrix<T>& );
+            template<typename T> static void lobpcg( const ublas::compressed_matrix<T>&, const std::size_t&, ublas::vector<T>&, ublas::matrix<T>&, const std::size_t& = 1000, const T& = 1e-6 );
+        
+        
+        private :
+        
+            template<typename T> static void transprod( const ublas::matrix<T>&, const ublas::matrix<T>&, ublas::matrix<T>& );
+            template<typename T> static void denseprod( const ublas::matrix<T>&, const ublas::matrix<T>&, ublas::matrix<T>&, const std::size_t& = 0 );
+            template<typename T> static void orthonormalize( ublas::matrix<T>& );
         
     };
 
@@ -304,5 +320,227 @@ namespace machinelearning { namespace tools {
         return ublas::prod( matrix::invert(l_degree), l_unnormlaplacian );
     }
 
+    
+    /** calculates the smallest eigenvalues and -vectors of a symmetric positive semi-definite sparse matrix with the
+     * locally optimal block preconditioned conjugate gradient method (LOBPCG). The matrix is used only with
+     * sparse products and the preconditioner is the inverse diagonal of the matrix
+     * @see http://en.wikipedia.org/wiki/LOBPCG
+     * @param p_matrix sparse symmetric matrix (row compressed)
+     * @param p_count number of eigenvalues
+     * @param p_eigval vector with the eigenvalues in ascending order [initialisation is not needed]
+     * @param p_eigvec matrix with the normalized eigenvectors (every column is a eigenvector) [initialisation is not needed]
+     * @param p_iteration maximum number of iterations (an exception is thrown, if the residuals do not converge)
+     * @param p_tolerance residual tolerance relative to the matrix norm
+     **/
+    template<typename T> inline void lapack::lobpcg( const ublas::compressed_matrix<T>& p_matrix, const std::size_t& p_count, ublas::vector<T>& p_eigval, ublas::matrix<T>& p_eigvec, const std::size_t& p_iteration, const T& p_tolerance )
+    {
+        if (p_matrix.size1() != p_matrix.size2())
+            throw exception::runtime(_("matrix must be square"));
+        if ( (p_count == 0) || (3*p_count > p_matrix.size1()) )
+            throw exception::runtime(_("number of eigenvalues must be greater than zero and less than a third of the matrix size"));
+        
+        // row pointers of the compressed structure are set only up to the last filled row
+        const std::size_t l_rows = (p_matrix.filled1() > 0) ? p_matrix.filled1()-1 : 0;
+        
+        // diagonal for the preconditioner and matrix norm estimation (maximum absolute row sum)
+        ublas::vector<T> l_diag( p_matrix.size1(), static_cast<T>(0) );
+        T l_norm = static_cast<T>(0);
+        for(std::size_t i=0; i < l_rows; ++i) {
+            T l_sum = static_cast<T>(0);
+            for(std::size_t j=p_matrix.index1_data()[i]; j < p_matrix.index1_data()[i+1]; ++j) {
+                l_sum += std::fabs(p_matrix.value_data()[j]);
+                if (p_matrix.index2_data()[j] == i)
+                    l_diag(i) = p_matrix.value_data()[j];
+            }
+            l_norm = std::max(l_norm, l_sum);
+        }
+        if (function::isNumericalZero(l_norm))
+            l_norm = static_cast<T>(1);
+        
+        // the block is enlarged with guard vectors, because clustered eigenvalues (eg. near zero)
+        // converge slowly if the block size is equal to the number of requested eigenvalues
+        const std::size_t l_block = std::max( p_count, std::min( 2*p_count+5, p_matrix.size1()/3 ) );
+        
+        // initialization with random orthonormal vectors
+        ublas::matrix<T> l_x = matrix::random<T>( p_matrix.size1(), l_block, tools::random::uniform, static_cast<T>(-1), static_cast<T>(1) );
+        orthonormalize(l_x);
+        if (l_x.size2() != l_block)
+            throw exception::runtime(_("initialization vectors are linear dependent"));
+        
+        ublas::matrix<T> l_ax = matrix::sparseprod( p_matrix, l_x );
+        
+        ublas::vector<T> l_eigval( l_block );
+        for(std::size_t i=0; i < l_block; ++i)
+            l_eigval(i) = ublas::inner_prod( ublas::column(l_x, i), ublas::column(l_ax, i) );
+        
+        ublas::matrix<T> l_p;
+        ublas::vector<T> l_residualnorm( l_block );
+        
+        for(std::size_t n=0; ; ++n) {
+            
+            // create the search space [X, W, P] with the preconditioned residuals W of the Ritz pairs
+            ublas::matrix<T> l_space( p_matrix.size1(), 2*l_block + l_p.size2() );
+            l_residualnorm.clear();
+            
+            for(std::size_t i=0; i < l_space.size1(); ++i) {
+                const T l_precondition = function::isNumericalZero(l_diag(i)) ? static_cast<T>(1) : static_cast<T>(1) / l_diag(i);
+                
+                for(std::size_t j=0; j < l_block; ++j) {
+                    const T l_residual = l_ax(i, j) - l_eigval(j) * l_x(i, j);
+                    l_residualnorm(j)         += l_residual * l_residual;
+                    l_space(i, j)              = l_x(i, j);
+                    l_space(i, l_block + j)    = l_precondition * l_residual;
+                }
+                for(std::size_t j=0; j < l_p.size2(); ++j)
+                    l_space(i, 2*l_block + j) = l_p(i, j);
+            }
+            
+            // check convergence only for the requested eigenvalues
+            bool l_converged = true;
+            for(std::size_t i=0; (i < p_count) && l_converged; ++i)
+                l_converged = std::sqrt(l_residualnorm(i)) <= p_tolerance * l_norm;
+            if (l_converged)
+                break;
+            if (n == p_iteration)
+                throw exception::runtime(_("eigenvalue iteration does not converge within the maximum number of iterations"));
+            
+            // orthonormal basis of the search space (the block X is orthonormal, so it is not changed)
+            orthonormalize(l_space);
+            
+            // Rayleigh-Ritz on the search space
+            const ublas::matrix<T> l_aspace = matrix::sparseprod( p_matrix, l_space );
+            
+            ublas::matrix<T> l_gram( l_space.size2(), l_space.size2() );
+            transprod( l_space, l_aspace, l_gram );
+            l_gram = static_cast<T>(0.5) * (l_gram + ublas::trans(l_gram));
+            
+            ublas::vector<T> l_ritzval;
+            ublas::matrix<T> l_ritzvec;
+            eigen( l_gram, l_ritzval, l_ritzvec );
+            const ublas::indirect_array<> l_rank = vector::rankIndex( l_ritzval );
+            
+            ublas::matrix<T> l_coefficient( l_space.size2(), l_block );
+            for(std::size_t i=0; i < l_block; ++i) {
+                ublas::column(l_coefficient, i) = ublas::column(l_ritzvec, l_rank(i));
+                l_eigval(i)                     = l_ritzval(l_rank(i));
+            }
+            
+            // new Ritz vectors and new search directions (part without the actual Ritz vectors)
+            l_p.resize( l_space.size1(), l_block, false );
+            l_x.resize( l_space.size1(), l_block, false );
+            l_ax.resize( l_space.size1(), l_block, false );
+            
+            denseprod( l_space, l_coefficient, l_p, l_block );
+            denseprod( l_space, l_coefficient, l_x );
+            denseprod( l_aspace, l_coefficient, l_ax );
+        }
+        
+        p_eigval = ublas::project( l_eigval, ublas::range(0, p_count) );
+        p_eigvec = ublas::project( l_x, ublas::range(0, l_x.size1()), ublas::range(0, p_count) );
+    }
+    
+    
+    /** calculates the product A' * B of two dense matrices with the same number of rows
+     * @param p_first matrix A
+     * @param p_second matrix B
+     * @param p_result result matrix (must have the correct size)
+     **/
+    template<typename T> inline void lapack::transprod( const ublas::matrix<T>& p_first, const ublas::matrix<T>& p_second, ublas::matrix<T>& p_result )
+    {
+        const std::size_t l_firstcols  = p_first.size2();
+        const std::size_t l_secondcols = p_second.size2();
+        
+        #pragma omp parallel for shared(p_result)
+        for(std::size_t i=0; i < l_firstcols; ++i) {
+            T* l_result = &p_result.data()[i * l_secondcols];
+            std::fill( l_result, l_result + l_secondcols, static_cast<T>(0) );
+            
+            for(std::size_t n=0; n < p_first.size1(); ++n) {
+                const T l_value   = p_first.data()[n * l_firstcols + i];
+                const T* l_second = &p_second.data()[n * l_secondcols];
+                
+                for(std::size_t j=0; j < l_secondcols; ++j)
+                    l_result[j] += l_value * l_second[j];
+            }
+        }
+    }
+    
+    
+    /** calculates the product A * B of two dense matrices, only the rows of B beginning at
+     * the offset are used (the columns of A are shifted in the same way)
+     * @param p_first matrix A
+     * @param p_second matrix B
+     * @param p_result result matrix (must have the correct size)
+     * @param p_offset row offset of B
+     **/
+    template<typename T> inline void lapack::denseprod( const ublas::matrix<T>& p_first, const ublas::matrix<T>& p_second, ublas::matrix<T>& p_result, const std::size_t& p_offset )
+    {
+        const std::size_t l_firstcols  = p_first.size2();
+        const std::size_t l_secondcols = p_second.size2();
+        
+        #pragma omp parallel for shared(p_result)
+        for(std::size_t i=0; i < p_first.size1(); ++i) {
+            T* l_result = &p_result.data()[i * l_secondcols];
+            std::fill( l_result, l_result + l_secondcols, static_cast<T>(0) );
+            
+            for(std::size_t n=p_offset; n < l_firstcols; ++n) {
+                const T l_value   = p_first.data()[i * l_firstcols + n];
+                const T* l_second = &p_second.data()[n * l_secondcols];
+                
+                for(std::size_t j=0; j < l_secondcols; ++j)
+                    l_result[j] += l_value * l_second[j];
+            }
+        }
+    }
+    
+    
+    /** orthonormalize the columns of a matrix with the modified Gram-Schmidt process (with reorthogonalization),
+     * linear dependent columns are removed. The columns are copied into contiguous memory first
+     * @param p_matrix matrix
+     **/
+    template<typename T> inline void lapack::orthonormalize( ublas::matrix<T>& p_matrix )
+    {
+        const std::size_t l_rows = p_matrix.size1();
+        const ublas::matrix<T> l_columns = ublas::trans(p_matrix);
+        ublas::matrix<T> l_basis( p_matrix.size2(), l_rows );
+        
+        std::size_t l_count = 0;
+        for(std::size_t i=0; i < l_columns.size1(); ++i) {
+            T* l_vec = &l_basis.data()[l_count * l_rows];
+            std::copy( &l_columns.data()[i * l_rows], &l_columns.data()[i * l_rows] + l_rows, l_vec );
+            
+            T l_norm = static_cast<T>(0);
+            for(std::size_t n=0; n < l_rows; ++n)
+                l_norm += l_vec[n] * l_vec[n];
+            l_norm = std::sqrt(l_norm);
+            
+            for(std::size_t k=0; k < 2; ++k)
+                for(std::size_t j=0; j < l_count; ++j) {
+                    const T* l_base = &l_basis.data()[j * l_rows];
+                    
+                    T l_inner = static_cast<T>(0);
+                    for(std::size_t n=0; n < l_rows; ++n)
+                        l_inner += l_base[n] * l_vec[n];
+                    for(std::size_t n=0; n < l_rows; ++n)
+                        l_vec[n] -= l_inner * l_base[n];
+                }
+            
+            // vector is (numerical) linear dependent to the previous vectors
+            T l_orthnorm = static_cast<T>(0);
+            for(std::size_t n=0; n < l_rows; ++n)
+                l_orthnorm += l_vec[n] * l_vec[n];
+            l_orthnorm = std::sqrt(l_orthnorm);
+            
+            if ( (function::isNumericalZero(l_orthnorm)) || (l_orthnorm < std::sqrt(std::numeric_limits<T>::epsilon()) * l_norm) )
+                continue;
+            
+            for(std::size_t n=0; n < l_rows; ++n)
+                l_vec[n] /= l_orthnorm;
+            l_count++;
+        }
+        
+        p_matrix = ublas::trans( ublas::project(l_basis, ublas::range(0, l_count), ublas::range(0, l_rows)) );
+    }
+
 }}
 #endif
@@ -27,6 +27,7 @@
 
 #include <omp.h>
 
+#include <algorithm>
 #include <boost/numeric/ublas/matrix.hpp>
 #include <boost/numeric/ublas/vector.hpp>
 #include <boost/numeric/ublas/matrix_proxy.hpp>
@@ -80,6 +81,9 @@ namespace machinelearning { namespace tools {
             template<typename T> static ublas::matrix<T> invert( const ublas::matrix<T>&);
             template<typename T> static ublas::matrix<T> repeat( const ublas::vector<T>&, const rowtype& p_which = row);
             template<typename T> static ublas::matrix<T> repeat( const ublas::vector<T>&, const std::size_t&, const rowtype& p_which = row);
+            template<typename T> static ublas::matrix<T> blockprod( const ublas::matrix<T>&, const ublas::matrix<T>&, const ublas::vector<T>& = ublas::vector<T>() );
+            template<typename T> static ublas::matrix<T> sparseprod( const ublas::matrix<T>&, const ublas::compressed_matrix<T>& );
+            template<typename T> static ublas::matrix<T> sparseprod( const ublas::compressed_matrix<T>&, const ublas::matrix<T>& );
     };
     
     
@@ -544,5 +548,119 @@ namespace machinelearning { namespace tools {
         return l_mat;
     }
         
+    
+    /** calculates the product (X - 1 * s') * P of row data X with a projection matrix P. The rows are processed
+     * in blocks (in parallel, if there is more than one block) and the inner dimension is split, so the used part
+     * of the projection matrix stays in the cache. Only local data is written, so the function can be called concurrently
+     * @param p_data data matrix (each row is a data point)
+     * @param p_project projection matrix
+     * @param p_shift vector, that is subtracted from each row (empty vector for no shift)
+     * @return projected data
+     **/
+    template<typename T> inline ublas::matrix<T> matrix::blockprod( const ublas::matrix<T>& p_data, const ublas::matrix<T>& p_project, const ublas::vector<T>& p_shift )
+    {
+        if (p_data.size2() != p_project.size1())
+            throw exception::runtime(_("column size of the data must be equal to the row size of the projection"));
+        if ( (p_shift.size() != 0) && (p_shift.size() != p_data.size2()) )
+            throw exception::runtime(_("shift vector size must be equal to the column size"));
+        
+        const std::size_t l_rowblock    = 64;
+        const std::size_t l_innerblock  = 256;
+        const std::size_t l_inner       = p_data.size2();
+        const std::size_t l_cols        = p_project.size2();
+        const std::size_t l_blocks      = (p_data.size1() + l_rowblock - 1) / l_rowblock;
+        
+        ublas::matrix<T> l_result( p_data.size1(), l_cols, static_cast<T>(0) );
+        if ( (l_inner == 0) || (l_cols == 0) )
+            return l_result;
+        
+        #pragma omp parallel for shared(l_result) if(l_blocks > 1)
+        for(std::size_t b=0; b < l_blocks; ++b) {
+            const std::size_t l_end = std::min( p_data.size1(), (b+1) * l_rowblock );
+            
+            for(std::size_t k=0; k < l_inner; k += l_innerblock) {
+                const std::size_t l_innerend = std::min( l_inner, k + l_innerblock );
+                
+                for(std::size_t i=b * l_rowblock; i < l_end; ++i) {
+                    const T* l_row  = &p_data.data()[i * l_inner];
+                    T* l_target     = &l_result.data()[i * l_cols];
+                    
+                    for(std::size_t n=k; n < l_innerend; ++n) {
+                        const T l_value = (p_shift.size() == 0) ? l_row[n] : l_row[n] - p_shift(n);
+                        const T* l_project = &p_project.data()[n * l_cols];
+                        
+                        for(std::size_t j=0; j < l_cols; ++j)
+                            l_target[j] += l_value * l_project[j];
+                    }
+                }
+            }
+        }
+        
+        return l_result;
+    }
+    
+    
+    /** calculates the product W * X of a dense matrix and a sparse matrix. Each row of the
+     * result is calculated by one thread over the non-zero elements of the sparse matrix
+     * @param p_weight dense matrix
+     * @param p_data sparse matrix
+     * @return dense product
+     **/
+    template<typename T> inline ublas::matrix<T> matrix::sparseprod( const ublas::matrix<T>& p_weight, const ublas::compressed_matrix<T>& p_data )
+    {
+        if (p_weight.size2() != p_data.size1())
+            throw exception::runtime(_("column size of the first matrix must be equal to the row size of the second matrix"));
+        
+        ublas::matrix<T> l_result( p_weight.size1(), p_data.size2(), static_cast<T>(0) );
+        
+        #pragma omp parallel for shared(l_result)
+        for(std::size_t n=0; n < p_weight.size1(); ++n) {
+            T* l_target = &l_result.data()[n * l_result.size2()];
+            
+            for(typename ublas::compressed_matrix<T>::const_iterator1 it = p_data.begin1(); it != p_data.end1(); ++it) {
+                const T l_weight = p_weight(n, it.index1());
+                if (l_weight == 0)
+                    continue;
+                
+                for(typename ublas::compressed_matrix<T>::const_iterator2 jt = it.begin(); jt != it.end(); ++jt)
+                    l_target[jt.index2()] += l_weight * (*jt);
+            }
+        }
+        
+        return l_result;
+    }
+    
+    
+    /** calculates the product S * X of a sparse matrix and a dense matrix. Each row of the
+     * result is calculated by one thread over the non-zero elements of the sparse row
+     * @param p_sparse row compressed sparse matrix
+     * @param p_dense dense matrix
+     * @return dense product
+     **/
+    template<typename T> inline ublas::matrix<T> matrix::sparseprod( const ublas::compressed_matrix<T>& p_sparse, const ublas::matrix<T>& p_dense )
+    {
+        if (p_sparse.size2() != p_dense.size1())
+            throw exception::runtime(_("column size of the first matrix must be equal to the row size of the second matrix"));
+        
+        const std::size_t l_rows = (p_sparse.filled1() > 0) ? p_sparse.filled1()-1 : 0;
+        const std::size_t l_cols = p_dense.size2();
+        ublas::matrix<T> l_result( p_sparse.size1(), l_cols, static_cast<T>(0) );
+        
+        #pragma omp parallel for shared(l_result)
+        for(std::size_t i=0; i < l_rows; ++i) {
+            T* l_target = &l_result.data()[i * l_cols];
+            
+            for(std::size_t j=p_sparse.index1_data()[i]; j < p_sparse.index1_data()[i+1]; ++j) {
+                const T l_value  = p_sparse.value_data()[j];
+                const T* l_row   = &p_dense.data()[p_sparse.index2_data()[j] * l_cols];
+                
+                for(std::size_t k=0; k < l_cols; ++k)
+                    l_target[k] += l_value * l_row[k];
+            }
+        }
+        
+        return l_result;
+    }
+        
 }}
 #endif